@@ -3,23 +3,63 @@
 #ifndef FIBONACCI_HEAP_TPP
 #define FIBONACCI_HEAP_TPP
 
+#include "MappedFile.hpp"
 #include <iostream>
 #include <cmath>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <type_traits>
+#include <unistd.h>
 using namespace std;
 
 // constructor
-template <typename T>
-FibonacciHeap<T>::FibonacciHeap() : minNode(nullptr), size(0) {}
+template <typename T, typename Observer>
+FibonacciHeap<T, Observer>::FibonacciHeap()
+    : minNode(nullptr), size(0), consolidationBudget(0), carry(nullptr) {}
 
 // destructor
-template <typename T>
-FibonacciHeap<T>::~FibonacciHeap() {
+template <typename T, typename Observer>
+FibonacciHeap<T, Observer>::~FibonacciHeap() {
     deleteAll(minNode);
 }
 
+// move constructor - takes over the other heap's nodes and storage
+template <typename T, typename Observer>
+FibonacciHeap<T, Observer>::FibonacciHeap(FibonacciHeap&& other) noexcept
+    : minNode(other.minNode), size(other.size), pool(std::move(other.pool)),
+      observer(std::move(other.observer)), consolidationBudget(other.consolidationBudget),
+      degreeTable(std::move(other.degreeTable)), pendingRoots(std::move(other.pendingRoots)),
+      carry(other.carry) {
+    other.minNode = nullptr;
+    other.size = 0;
+    other.resetConsolidation();
+}
+
+// move assignment
+template <typename T, typename Observer>
+FibonacciHeap<T, Observer>& FibonacciHeap<T, Observer>::operator=(FibonacciHeap&& other) noexcept {
+    if (this != &other) {
+        deleteAll(minNode);
+        minNode = other.minNode;
+        size = other.size;
+        pool = std::move(other.pool);
+        observer = std::move(other.observer);
+        consolidationBudget = other.consolidationBudget;
+        degreeTable = std::move(other.degreeTable);
+        pendingRoots = std::move(other.pendingRoots);
+        carry = other.carry;
+        other.minNode = nullptr;
+        other.size = 0;
+        other.resetConsolidation();
+    }
+    return *this;
+}
+
 // insertBefore()
-template <typename T>
-void FibonacciHeap<T>::insertBefore(Node* node, Node* target) {
+template <typename T, typename Observer>
+void FibonacciHeap<T, Observer>::insertBefore(Node* node, Node* target) {
     if (!node || !target) return;
     node->right = target;
     node->left = target->left;
@@ -27,24 +67,59 @@ void FibonacciHeap<T>::insertBefore(Node* node, Node* target) {
     target->left = node;
 }
 
-// deleteAll()
-template <typename T>
-void FibonacciHeap<T>::deleteAll(Node* start) {
-    if (!start) return;
-    Node* curr = start;
-    do {
-        Node* next = curr->right;
-        if (curr->child)
-            deleteAll(curr->child);
-        delete curr;
-        curr = next;
-    } while (curr != start);
+// deleteAll() - destroys the payloads reachable from start, then frees
+// all storage block by block
+template <typename T, typename Observer>
+void FibonacciHeap<T, Observer>::deleteAll(Node* start) {
+    DetachedNodes nodes(start, std::move(pool));  // freed right away
+}
+
+// DetachedNodes
+template <typename T, typename Observer>
+FibonacciHeap<T, Observer>::DetachedNodes::DetachedNodes(Node* start, NodePool<Node>&& nodes)
+    : next(nullptr), pool(std::move(nodes)) {
+    if (start && !std::is_trivially_destructible<T>::value) {
+        // the root ring is opened here; reclaim() splices each child ring
+        // in right after its parent, so the forest is walked as one list
+        start->left->right = nullptr;
+        next = start;
+    }
+}
+
+template <typename T, typename Observer>
+FibonacciHeap<T, Observer>::DetachedNodes::DetachedNodes(DetachedNodes&& other) noexcept
+    : next(other.next), pool(std::move(other.pool)) {
+    other.next = nullptr;
+}
+
+template <typename T, typename Observer>
+FibonacciHeap<T, Observer>::DetachedNodes::~DetachedNodes() {
+    reclaim(SIZE_MAX);
+}
+
+template <typename T, typename Observer>
+bool FibonacciHeap<T, Observer>::DetachedNodes::reclaim(size_t maxNodes) {
+    size_t destroyed = 0;
+    while (next && destroyed < maxNodes) {
+        Node* curr = next;
+        if (curr->child) {
+            Node* first = curr->child;
+            first->left->right = curr->right;
+            curr->right = first;
+        }
+        next = curr->right;
+        curr->~Node();
+        destroyed++;
+    }
+    if (next || destroyed >= maxNodes) return next || pool.hasBlocks();
+    // every payload is gone; the rest of the budget goes to whole blocks
+    return pool.hasBlocks() && pool.releaseSome(maxNodes - destroyed);
 }
 
 // insert
-template <typename T>
-typename FibonacciHeap<T>::Node* FibonacciHeap<T>::insert(const T& value, int key) {
-    Node* node = new Node(value, key);
+template <typename T, typename Observer>
+typename FibonacciHeap<T, Observer>::Node* FibonacciHeap<T, Observer>::insert(const T& value, int key) {
+    Node* node = pool.create(value, key);
     if (!minNode) {
         minNode = node;
     } else {
@@ -53,24 +128,29 @@ typename FibonacciHeap<T>::Node* FibonacciHeap<T>::insert(const T& value, int ke
             minNode = node;
     }
     size++;
+    observer.inserted(node);
+    if (consolidationBudget > 0) {
+        addPending(node);
+        advanceConsolidation(1);
+    }
     return node;
 }
 
 // getMin()
-template <typename T>
-typename FibonacciHeap<T>::Node* FibonacciHeap<T>::getMin() const { return minNode; }
+template <typename T, typename Observer>
+typename FibonacciHeap<T, Observer>::Node* FibonacciHeap<T, Observer>::getMin() const { return minNode; }
 
 // isEmpty()
-template <typename T>
-bool FibonacciHeap<T>::isEmpty() const { return minNode == nullptr; }
+template <typename T, typename Observer>
+bool FibonacciHeap<T, Observer>::isEmpty() const { return minNode == nullptr; }
 
 // getSize
-template <typename T>
-int FibonacciHeap<T>::getSize() const { return size; }
+template <typename T, typename Observer>
+int FibonacciHeap<T, Observer>::getSize() const { return size; }
 
 // displayMin
-template <typename T>
-void FibonacciHeap<T>::displayMin() const {
+template <typename T, typename Observer>
+void FibonacciHeap<T, Observer>::displayMin() const {
     if (isEmpty()) {
         cout << "Heap is empty\n";
     } else {
@@ -80,9 +160,13 @@ void FibonacciHeap<T>::displayMin() const {
 }
 
 // merge()
-template <typename T>
-void FibonacciHeap<T>::merge(FibonacciHeap& otherHeap) {
+template <typename T, typename Observer>
+void FibonacciHeap<T, Observer>::merge(FibonacciHeap& otherHeap) {
     if (this == &otherHeap || !otherHeap.minNode) return;
+    if (consolidationBudget > 0) {
+        for (Node* root : otherHeap.roots()) addPending(root);
+    }
+    otherHeap.resetConsolidation();
     if (!minNode) {
         minNode = otherHeap.minNode;
     } else {
@@ -95,13 +179,17 @@ void FibonacciHeap<T>::merge(FibonacciHeap& otherHeap) {
     }
     if (minNode->key > otherHeap.minNode->key) minNode = otherHeap.minNode;
     size += otherHeap.size;
+    pool.absorb(otherHeap.pool);
+    observer.merged(otherHeap.minNode, otherHeap.observer);
     otherHeap.minNode = nullptr;
     otherHeap.size = 0;
+    otherHeap.observer.cleared();
+    if (consolidationBudget > 0) advanceConsolidation(1);
 }
 
 // linkNodes()
-template <typename T>
-void FibonacciHeap<T>::linkNodes(Node* a, Node* b) {
+template <typename T, typename Observer>
+void FibonacciHeap<T, Observer>::linkNodes(Node* a, Node* b) {
     if (!a || !b) return;
     b->left->right = b->right;
     b->right->left = b->left;
@@ -114,17 +202,27 @@ void FibonacciHeap<T>::linkNodes(Node* a, Node* b) {
     }
     b->parent = a;
     a->degree++;
+    bool wasMarked = b->marked;
     b->marked = false;
+    if (wasMarked) observer.unmarked(b);
+    observer.linked(b, a);
 }
 
 // consolidate
-template <typename T>
-void FibonacciHeap<T>::consolidate() {
+template <typename T, typename Observer>
+void FibonacciHeap<T, Observer>::consolidate() {
     if (!minNode) return;
+    if (consolidationBudget > 0) {
+        // finish the outstanding incremental work
+        while (consolidationStep()) {}
+        return;
+    }
 
+    // degrees stay below 1.44 * log2(size) + 2, so the table fits inline
+    // for any heap that fits in memory
     int maxDegree = static_cast<int>(log2(size) / log2(1.618)) + 1;
-    Vector<Node*> degreeArray(maxDegree + 1, nullptr);
-    Vector<Node*> rootlist;
+    Vector<Node*, 64> degreeArray(maxDegree + 1, nullptr);
+    RootList rootlist;
 
     Node* curr = minNode;
     Node* start = minNode;
@@ -167,10 +265,11 @@ void FibonacciHeap<T>::consolidate() {
 }
 
 // extractMin
-template <typename T>
-typename FibonacciHeap<T>::Node* FibonacciHeap<T>::extractMin() {
+template <typename T, typename Observer>
+typename FibonacciHeap<T, Observer>::Node* FibonacciHeap<T, Observer>::extractMin() {
     Node* temp = minNode;
     if (!temp) return temp;
+    size_t promoted = 0;
     if (temp->child) {
         Node* start = temp->child;
         Node* curr = start;
@@ -178,6 +277,9 @@ typename FibonacciHeap<T>::Node* FibonacciHeap<T>::extractMin() {
             Node* nextChild = curr->right;
             curr->parent = nullptr;
             insertBefore(curr, temp);
+            observer.cut(curr, temp);
+            if (consolidationBudget > 0) addPending(curr);
+            promoted++;
             curr = nextChild;
         } while (curr != start);
     }
@@ -187,19 +289,128 @@ typename FibonacciHeap<T>::Node* FibonacciHeap<T>::extractMin() {
 
     if (temp->right == temp) {
         minNode = nullptr;
+        resetConsolidation();
+    } else if (consolidationBudget > 0) {
+        // this operation's share of the linking, then the new minimum from
+        // the bookkeeping (every root is filed, pending or carried) rather
+        // than from a walk of the root list. The scan reads every pending
+        // root, so filing a quarter of them too costs the same order and
+        // shrinks a large backlog (after a merge) geometrically.
+        forgetRoot(temp);
+        advanceConsolidation(promoted);
+        for (size_t i = pendingRoots.size() / 4; i > 0 && consolidationStep(); --i) {}
+        minNode = carry;
+        for (Node* root : degreeTable) {
+            if (root && (!minNode || root->key < minNode->key)) minNode = root;
+        }
+        for (Node* root : pendingRoots) {
+            if (!minNode || root->key < minNode->key) minNode = root;
+        }
     } else {
         minNode = temp->right;
         consolidate();
     }
 
     size--;
+    observer.extracted(temp);
     return temp;
 }
 
+// setConsolidationBudget()
+template <typename T, typename Observer>
+void FibonacciHeap<T, Observer>::setConsolidationBudget(int steps) {
+    if (steps < 0) {
+        throw std::invalid_argument("Consolidation budget must not be negative");
+    }
+    bool wasIncremental = consolidationBudget > 0;
+    consolidationBudget = steps;
+    if (wasIncremental && steps == 0) {
+        // the next eager consolidate() goes over the whole root list anyway
+        resetConsolidation();
+    } else if (!wasIncremental && steps > 0) {
+        for (Node* root : roots()) addPending(root);
+    }
+}
+
+// consolidationStep() - one unit of incremental work: files the carried
+// root in the degree table, or links it with the root already there and
+// carries the winner on. Returns false once every root is filed.
+template <typename T, typename Observer>
+bool FibonacciHeap<T, Observer>::consolidationStep() {
+    if (!carry) {
+        if (pendingRoots.empty()) return false;
+        carry = pendingRoots.back();
+        pendingRoots.pop_back();
+        carry->pendingSlot = -1;
+    }
+    int d = carry->degree;
+    if (d >= (int)degreeTable.size()) degreeTable.resize(d + 1, nullptr);
+    Node* other = degreeTable[d];
+    if (!other) {
+        degreeTable[d] = carry;
+        carry = nullptr;
+        return true;
+    }
+    degreeTable[d] = nullptr;
+    Node* p = carry;
+    Node* c = other;
+    // the minimum must stay a root, even against an equal key
+    if (c->key < p->key || c == minNode) {
+        p = other;
+        c = carry;
+    }
+    linkNodes(p, c);
+    carry = p;
+    return true;
+}
+
+// advanceConsolidation() - one operation's share of the work: the budget
+// for each root it added, so roots are filed as fast as they appear
+template <typename T, typename Observer>
+void FibonacciHeap<T, Observer>::advanceConsolidation(size_t addedRoots) {
+    size_t steps = static_cast<size_t>(consolidationBudget) * std::max<size_t>(addedRoots, 1);
+    for (size_t i = 0; i < steps && consolidationStep(); ++i) {}
+}
+
+// addPending() - queues a new root for incremental consolidation
+template <typename T, typename Observer>
+void FibonacciHeap<T, Observer>::addPending(Node* root) {
+    root->pendingSlot = static_cast<int>(pendingRoots.size());
+    pendingRoots.push_back(root);
+}
+
+// forgetRoot() - drops a root that is leaving the heap from the
+// incremental bookkeeping, in O(1): a pending root is swapped with the
+// last pending one. Slots are not cleared when pendingRoots is, so one is
+// only trusted if the entry it names is the root itself.
+template <typename T, typename Observer>
+void FibonacciHeap<T, Observer>::forgetRoot(Node* root) {
+    size_t slot = static_cast<size_t>(root->pendingSlot);
+    if (root == carry) {
+        carry = nullptr;
+    } else if (root->degree < (int)degreeTable.size() && degreeTable[root->degree] == root) {
+        degreeTable[root->degree] = nullptr;
+    } else if (slot < pendingRoots.size() && pendingRoots[slot] == root) {
+        Node* last = pendingRoots.back();
+        pendingRoots[slot] = last;
+        last->pendingSlot = static_cast<int>(slot);
+        pendingRoots.pop_back();
+        root->pendingSlot = -1;
+    }
+}
+
+// resetConsolidation() - the heap has no roots left to consolidate
+template <typename T, typename Observer>
+void FibonacciHeap<T, Observer>::resetConsolidation() {
+    degreeTable.clear();
+    pendingRoots.clear();
+    carry = nullptr;
+}
+
 // getRootList
-template <typename T>
-Vector<typename FibonacciHeap<T>::Node*> FibonacciHeap<T>::getRootList() const {
-    Vector<Node*> roots;
+template <typename T, typename Observer>
+typename FibonacciHeap<T, Observer>::RootList FibonacciHeap<T, Observer>::getRootList() const {
+    RootList roots;
     if (!minNode) return roots;
     Node* curr = minNode;
     Node* start = minNode;
@@ -210,8 +421,8 @@ Vector<typename FibonacciHeap<T>::Node*> FibonacciHeap<T>::getRootList() const {
     return roots;
 }
 
-template <typename T>
-void FibonacciHeap<T>::cut(Node* x, Node* y) {
+template <typename T, typename Observer>
+void FibonacciHeap<T, Observer>::cut(Node* x, Node* y) {
     if (x->right == x) {
         y->child = nullptr;
     } else {
@@ -224,15 +435,28 @@ void FibonacciHeap<T>::cut(Node* x, Node* y) {
     y->degree--;
     insertBefore(x, minNode);
     x->parent = nullptr;
+    bool wasMarked = x->marked;
     x->marked = false;
+    if (wasMarked) observer.unmarked(x);
+    observer.cut(x, y);
+    if (consolidationBudget > 0) {
+        addPending(x);
+        // a filed root that lost a child is in the wrong slot now
+        int d = y->degree + 1;
+        if (!y->parent && d < (int)degreeTable.size() && degreeTable[d] == y) {
+            degreeTable[d] = nullptr;
+            addPending(y);
+        }
+    }
 }
 
-template <typename T>
-void FibonacciHeap<T>::cascadingCut(Node* y) {
+template <typename T, typename Observer>
+void FibonacciHeap<T, Observer>::cascadingCut(Node* y) {
     Node* z = y->parent;
     if (z) {
         if (!y->marked) {
             y->marked = true;
+            observer.marked(y);
         } else {
             cut(y, z);
             cascadingCut(z);
@@ -240,11 +464,13 @@ void FibonacciHeap<T>::cascadingCut(Node* y) {
     }
 }
 
-template <typename T>
-void FibonacciHeap<T>::decreaseKey(Node* x, int newKey) {
+template <typename T, typename Observer>
+void FibonacciHeap<T, Observer>::decreaseKey(Node* x, int newKey) {
     if (newKey > x->key) {
         throw std::invalid_argument("New key is greater than current key");
     }
+    int oldKey = x->key;
+    size_t pendingBefore = pendingRoots.size();
     x->key = newKey;
     Node* y = x->parent;
     if (y && x->key < y->key) {
@@ -254,11 +480,13 @@ void FibonacciHeap<T>::decreaseKey(Node* x, int newKey) {
     if (x->key < minNode->key) {
         minNode = x;
     }
+    observer.keyChanged(x, oldKey);
+    if (consolidationBudget > 0) advanceConsolidation(pendingRoots.size() - pendingBefore);
 }
 
 // findNode()
-template <typename T>
-typename FibonacciHeap<T>::Node* FibonacciHeap<T>::findNode(Node* start, const T& value) {
+template <typename T, typename Observer>
+typename FibonacciHeap<T, Observer>::Node* FibonacciHeap<T, Observer>::findNode(Node* start, const T& value) {
     if (!start) return nullptr;
     Node* curr = start;
     do {
@@ -271,25 +499,58 @@ typename FibonacciHeap<T>::Node* FibonacciHeap<T>::findNode(Node* start, const T
 }
 
 //search()
-template <typename T>
-typename FibonacciHeap<T>::Node* FibonacciHeap<T>::search(const T& value) {
+template <typename T, typename Observer>
+typename FibonacciHeap<T, Observer>::Node* FibonacciHeap<T, Observer>::search(const T& value) {
     return findNode(minNode, value);
 }
 
-//deleteNode()
-template <typename T>
-void FibonacciHeap<T>::deleteNode(Node* x) {
+//deleteNode() - removes x in place: x is cut from its parent and its
+//children become roots. Only removing the minimum consolidates.
+template <typename T, typename Observer>
+void FibonacciHeap<T, Observer>::deleteNode(Node* x) {
     if (!x) return;
-    // it's brought to top by giving it the smallest possible key
-    decreaseKey(x, -999999);
-    Node* extracted = extractMin();
-    if (extracted) delete extracted;
+    if (x == minNode) {
+        release(extractMin());
+        return;
+    }
+
+    size_t pendingBefore = pendingRoots.size();
+    Node* y = x->parent;
+    if (y) {
+        cut(x, y);
+        cascadingCut(y);
+    }
+    if (x->child) {
+        Node* start = x->child;
+        Node* curr = start;
+        do {
+            Node* nextChild = curr->right;
+            curr->parent = nullptr;
+            insertBefore(curr, x);
+            observer.cut(curr, x);
+            if (consolidationBudget > 0) addPending(curr);
+            curr = nextChild;
+        } while (curr != start);
+    }
+
+    // x is a root other than the minimum, so the root list goes on
+    x->left->right = x->right;
+    x->right->left = x->left;
+    size--;
+    observer.extracted(x);
+    if (consolidationBudget > 0) {
+        forgetRoot(x);
+        size_t pendingAfter = pendingRoots.size();
+        advanceConsolidation(pendingAfter > pendingBefore ? pendingAfter - pendingBefore : 0);
+    }
+    release(x);
 }
 
-//increaseKey()
-template <typename T>
-void FibonacciHeap<T>::increaseKey(Node* x, int newKey) {
-    if (x == nullptr) return;
+//increaseKey() - returns the node now holding the value, since the
+//old node is freed and the value is re-inserted
+template <typename T, typename Observer>
+typename FibonacciHeap<T, Observer>::Node* FibonacciHeap<T, Observer>::increaseKey(Node* x, int newKey) {
+    if (x == nullptr) return nullptr;
 
     // store the value before deleting the node
     T val = x->value;
@@ -299,13 +560,14 @@ void FibonacciHeap<T>::increaseKey(Node* x, int newKey) {
 
     // here it's re-inserted with the new key
     // this ensures the heap property is perfectly maintained
-    insert(val, newKey);
+    return insert(val, newKey);
 }
 
 //updateKey() - general method to update key (decides whether to increase or decrease)
-template <typename T>
-void FibonacciHeap<T>::updateKey(Node* x, int newKey) {
-    if (x == nullptr) return;
+//returns the node holding the value afterwards, which differs from x after an increase
+template <typename T, typename Observer>
+typename FibonacciHeap<T, Observer>::Node* FibonacciHeap<T, Observer>::updateKey(Node* x, int newKey) {
+    if (x == nullptr) return nullptr;
 
     if (newKey < x->key) {
         // condition worsened (urgency increases)
@@ -313,9 +575,299 @@ void FibonacciHeap<T>::updateKey(Node* x, int newKey) {
     }
     else if (newKey > x->key) {
         // condition improved (urgency decreases)
-        increaseKey(x, newKey);
+        return increaseKey(x, newKey);
     }
     // if keys are equal, we do nothing.
+    return x;
+}
+
+//release() - returns an extracted node to the heap's storage
+template <typename T, typename Observer>
+void FibonacciHeap<T, Observer>::release(Node* node) {
+    pool.destroy(node);
+}
+
+//clear() - removes every node
+template <typename T, typename Observer>
+void FibonacciHeap<T, Observer>::clear() {
+    deleteAll(minNode);
+    minNode = nullptr;
+    size = 0;
+    resetConsolidation();
+    observer.cleared();
+}
+
+//detach() - the heap is left empty, as after clear(), but nothing is
+//freed until the returned nodes are
+template <typename T, typename Observer>
+typename FibonacciHeap<T, Observer>::DetachedNodes FibonacciHeap<T, Observer>::detach() {
+    DetachedNodes nodes(minNode, std::move(pool));
+    minNode = nullptr;
+    size = 0;
+    resetConsolidation();
+    observer.cleared();
+    return nodes;
+}
+
+//clone() - copies the heap in one preorder pass into a single block, so
+//the copy costs one allocation and is laid out in traversal order
+template <typename T, typename Observer>
+FibonacciHeap<T, Observer> FibonacciHeap<T, Observer>::clone() const {
+    FibonacciHeap copy;
+    copy.consolidationBudget = consolidationBudget;
+    if (!minNode) return copy;
+
+    // one frame per sibling ring being copied
+    struct Frame {
+        Node* start;
+        Node* curr;
+        Node* parent;  // the copy's
+        Node* first;
+        Node* prev;
+    };
+    std::vector<Frame> stack;
+    stack.push_back({minNode, minNode, nullptr, nullptr, nullptr});
+
+    Node* base = copy.pool.allocateRun(static_cast<size_t>(size));
+    size_t built = 0;
+    try {
+        while (!stack.empty()) {
+            Frame& frame = stack.back();
+            if (!frame.curr) {
+                // close the ring
+                frame.prev->right = frame.first;
+                frame.first->left = frame.prev;
+                stack.pop_back();
+                continue;
+            }
+
+            Node* node = frame.curr;
+            Node* clone = new (base + built) Node(node->value, node->key);
+            built++;
+            clone->degree = node->degree;
+            clone->marked = node->marked;
+            clone->parent = frame.parent;
+            if (!frame.prev) {
+                frame.first = clone;
+                if (frame.parent) frame.parent->child = clone;
+            } else {
+                frame.prev->right = clone;
+                clone->left = frame.prev;
+            }
+            frame.prev = clone;
+            frame.curr = (node->right == frame.start) ? nullptr : node->right;
+
+            // children are copied before the next sibling (invalidates frame)
+            if (node->child) stack.push_back({node->child, node->child, clone, nullptr, nullptr});
+        }
+    } catch (...) {
+        for (size_t i = 0; i < built; ++i) base[i].~Node();
+        copy.pool.releaseAll();
+        throw;
+    }
+
+    copy.minNode = base;
+    copy.size = size;
+    if (copy.consolidationBudget > 0) {
+        for (Node* root : copy.roots()) copy.addPending(root);
+    }
+    for (size_t i = 0; i < built; ++i) copy.observer.inserted(base + i);
+    return copy;
+}
+
+//saveSnapshot() - writes the heap in preorder, starting from the minimum
+template <typename T, typename Observer>
+template <typename Serializer>
+void FibonacciHeap<T, Observer>::saveSnapshot(const std::string& path) const {
+    std::vector<SnapshotNode> records;
+    std::vector<unsigned char> payload;
+    records.reserve(size);
+
+    // one frame per sibling ring being written
+    struct Frame {
+        Node* start;
+        Node* curr;
+        uint32_t parent;
+        uint32_t first;
+        uint32_t prev;
+    };
+    std::vector<Frame> stack;
+    if (minNode) stack.push_back({minNode, minNode, SNAPSHOT_NONE, SNAPSHOT_NONE, SNAPSHOT_NONE});
+
+    while (!stack.empty()) {
+        Frame& frame = stack.back();
+        if (!frame.curr) {
+            // close the ring
+            records[frame.prev].right = frame.first;
+            records[frame.first].left = frame.prev;
+            stack.pop_back();
+            continue;
+        }
+
+        Node* node = frame.curr;
+        uint32_t index = static_cast<uint32_t>(records.size());
+        SnapshotNode rec = {};
+        rec.key = node->key;
+        rec.degree = static_cast<uint32_t>(node->degree);
+        rec.parent = frame.parent;
+        rec.child = SNAPSHOT_NONE;
+        rec.left = frame.prev;
+        rec.right = SNAPSHOT_NONE;
+        rec.marked = node->marked ? 1 : 0;
+        records.push_back(rec);
+        Serializer::write(payload, node->value);
+
+        if (frame.prev == SNAPSHOT_NONE) {
+            frame.first = index;
+            if (frame.parent != SNAPSHOT_NONE) records[frame.parent].child = index;
+        } else {
+            records[frame.prev].right = index;
+        }
+        frame.prev = index;
+        frame.curr = (node->right == frame.start) ? nullptr : node->right;
+
+        // children are written before the next sibling (invalidates frame)
+        if (node->child) stack.push_back({node->child, node->child, index, SNAPSHOT_NONE, SNAPSHOT_NONE});
+    }
+
+    SnapshotHeader header = {};
+    std::memcpy(header.magic, "FHSN", 4);
+    header.version = SNAPSHOT_VERSION;
+    header.nodeSize = sizeof(SnapshotNode);
+    header.nodeCount = records.size();
+    header.payloadBytes = payload.size();
+
+    // write to a temporary file, sync it and rename it over the old one,
+    // so a crash leaves either the old snapshot or the whole new one. The
+    // rename itself is durable once the caller syncs the directory.
+    std::string tmpPath = path + ".tmp";
+    std::FILE* file = std::fopen(tmpPath.c_str(), "wb");
+    if (!file) throw std::runtime_error("Cannot create snapshot " + tmpPath);
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+    if (ok && !records.empty()) ok = std::fwrite(records.data(), sizeof(SnapshotNode), records.size(), file) == records.size();
+    if (ok && !payload.empty()) ok = std::fwrite(payload.data(), 1, payload.size(), file) == payload.size();
+    if (ok) ok = std::fflush(file) == 0 && ::fsync(::fileno(file)) == 0;
+    if (std::fclose(file) != 0) ok = false;
+    if (!ok) {
+        std::remove(tmpPath.c_str());
+        throw std::runtime_error("Cannot write snapshot " + tmpPath);
+    }
+    // the old snapshot stays in place until the new one replaces it
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        throw std::runtime_error("Cannot replace snapshot " + path);
+    }
+}
+
+//loadSnapshot() - replaces the heap with the snapshot's contents; the file
+//is memory-mapped and all nodes are built in one block, in a single pass
+template <typename T, typename Observer>
+template <typename Serializer>
+void FibonacciHeap<T, Observer>::loadSnapshot(const std::string& path) {
+    MappedFile file(path);
+    SnapshotHeader header;
+    if (file.size() < sizeof(header)) throw std::runtime_error("Snapshot is too small: " + path);
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, "FHSN", 4) != 0) throw std::runtime_error("Not a heap snapshot: " + path);
+    if (header.version != SNAPSHOT_VERSION || header.nodeSize != sizeof(SnapshotNode)) {
+        throw std::runtime_error("Unsupported snapshot version: " + path);
+    }
+    size_t count = static_cast<size_t>(header.nodeCount);
+    if (header.nodeCount > static_cast<uint64_t>(INT32_MAX) ||
+        (file.size() - sizeof(header)) / sizeof(SnapshotNode) < count ||
+        file.size() - sizeof(header) - count * sizeof(SnapshotNode) != header.payloadBytes) {
+        throw std::runtime_error("Snapshot is corrupt: " + path);
+    }
+
+    // everything is checked and built aside, so a corrupt file throws
+    // with the heap as it was
+    const unsigned char* recordBytes = file.data() + sizeof(header);
+    checkSnapshotNodes(recordBytes, count);
+    if (count == 0) {
+        clear();
+        return;
+    }
+
+    const unsigned char* cursor = recordBytes + count * sizeof(SnapshotNode);
+    const unsigned char* end = cursor + header.payloadBytes;
+    NodePool<Node> loaded;
+    Node* base = loaded.allocateRun(count);
+    auto link = [base](uint32_t index) -> Node* { return index == SNAPSHOT_NONE ? nullptr : base + index; };
+
+    size_t built = 0;
+    try {
+        for (; built < count; ++built) {
+            SnapshotNode rec;
+            std::memcpy(&rec, recordBytes + built * sizeof(SnapshotNode), sizeof(rec));
+            Node* node = new (base + built) Node(Serializer::read(cursor, end), rec.key);
+            node->degree = static_cast<int>(rec.degree);
+            node->marked = rec.marked != 0;
+            node->parent = link(rec.parent);
+            node->child = link(rec.child);
+            node->left = link(rec.left);
+            node->right = link(rec.right);
+        }
+    } catch (...) {
+        for (size_t i = 0; i < built; ++i) base[i].~Node();
+        loaded.releaseAll();
+        throw;
+    }
+
+    clear();
+    pool = std::move(loaded);
+    minNode = base;
+    size = static_cast<int>(count);
+    if (consolidationBudget > 0) {
+        for (Node* root : roots()) addPending(root);
+    }
+    for (size_t i = 0; i < count; ++i) observer.inserted(base + i);
+}
+
+//captureStructure() - preorder from the minimum, reusing out's buffers
+template <typename T, typename Observer>
+void FibonacciHeap<T, Observer>::captureStructure(HeapStructure& out) const {
+    out.resize(static_cast<size_t>(size));
+    out.rootCount = 0;
+
+    // one frame per sibling ring being copied
+    struct Frame {
+        Node* start;
+        Node* curr;
+        uint32_t parent;
+        uint32_t prev;
+    };
+    std::vector<Frame> stack;
+    if (minNode) stack.push_back({minNode, minNode, STRUCTURE_NONE, STRUCTURE_NONE});
+
+    uint32_t index = 0;
+    while (!stack.empty()) {
+        Frame& frame = stack.back();
+        if (!frame.curr) {
+            stack.pop_back();
+            continue;
+        }
+
+        Node* node = frame.curr;
+        out.key[index] = node->key;
+        out.degree[index] = node->degree;
+        out.marked[index] = node->marked ? 1 : 0;
+        out.parent[index] = frame.parent;
+        out.child[index] = STRUCTURE_NONE;
+        out.next[index] = STRUCTURE_NONE;
+
+        if (frame.prev != STRUCTURE_NONE) {
+            out.next[frame.prev] = index;
+        } else if (frame.parent != STRUCTURE_NONE) {
+            out.child[frame.parent] = index;
+        }
+        if (frame.parent == STRUCTURE_NONE) out.rootCount++;
+        frame.prev = index;
+        frame.curr = (node->right == frame.start) ? nullptr : node->right;
+
+        // children come before the next sibling (invalidates frame)
+        if (node->child) stack.push_back({node->child, node->child, index, STRUCTURE_NONE});
+        index++;
+    }
 }
 
 #endif
@@ -466,7 +466,8 @@ ApplicationWindow {
                             }
 
                             Text {
-                                text: "\u{1F321}\u{FE0F} " + ((TriageSystem && TriageSystem.topPatient) ?
+                                // topPatient is an empty map while nobody is waiting
+                                text: "\u{1F321}\u{FE0F} " + ((TriageSystem && TriageSystem.patientCount > 0) ?
                                       TriageSystem.topPatient.temperature.toFixed(1) : "--") + "\u00B0F"
                                 font.pixelSize: 13
                                 color: "white"
@@ -581,139 +582,141 @@ ApplicationWindow {
                     }
                 }
 
-                // Patient Cards Flow Layout
-                Flow {
+                // Patient cards: a ListView only creates delegates for visible rows
+                ListView {
+                    id: patientListView
                     Layout.fillWidth: true
+                    Layout.preferredHeight: Math.min(contentHeight, mainScrollView.availableHeight)
+                    clip: true
                     spacing: 16
+                    reuseItems: true
+                    cacheBuffer: 400
+                    model: TriageSystem ? TriageSystem.patientModel : null
+
+                    delegate: Rectangle {
+                        width: patientListView.width
+                        height: 195
+                        radius: 12
+                        color: "white"
+                        border.width: 2
+                        border.color: getUrgencyBorderColor(model.priority)
 
-                    Repeater {
-                        model: TriageSystem ? TriageSystem.allPatients : []
-
-                        Rectangle {
-                            width: Math.max(594, (mainColumn.width - 48 - 16) / 2 * 1.981)
-                            height: 195
-                            radius: 12
-                            color: "white"
-                            border.width: 2
-                            border.color: getUrgencyBorderColor(modelData.priority)
+                        Behavior on border.color {
+                            ColorAnimation { duration: 300 }
+                        }
 
-                            Behavior on border.color {
-                                ColorAnimation { duration: 300 }
+                        ColumnLayout {
+                            anchors {
+                                fill: parent
+                                margins: 20
                             }
+                            spacing: 10
 
-                            ColumnLayout {
-                                anchors {
-                                    fill: parent
-                                    margins: 20
+                            RowLayout {
+                                Layout.fillWidth: true
+
+                                Rectangle {
+                                    Layout.preferredWidth: 12
+                                    Layout.preferredHeight: 12
+                                    radius: 6
+                                    color: getUrgencyColor(model.priority)
                                 }
-                                spacing: 10
 
-                                RowLayout {
-                                    Layout.fillWidth: true
+                                Text {
+                                    text: getUrgencyLabel(model.priority)
+                                    font.pixelSize: 11
+                                    font.weight: Font.Bold
+                                    color: getUrgencyTextColor(model.priority)
+                                    font.letterSpacing: 0.5
+                                }
 
-                                    Rectangle {
-                                        Layout.preferredWidth: 12
-                                        Layout.preferredHeight: 12
-                                        radius: 6
-                                        color: getUrgencyColor(modelData.priority)
-                                    }
+                                Item { Layout.fillWidth: true }
+
+                                Rectangle {
+                                    Layout.preferredWidth: 70
+                                    Layout.preferredHeight: 24
+                                    radius: 6
+                                    color: "#f8fafc"
 
                                     Text {
-                                        text: getUrgencyLabel(modelData.priority)
+                                        anchors.centerIn: parent
+                                        text: "P: " + model.priority
                                         font.pixelSize: 11
-                                        font.weight: Font.Bold
-                                        color: getUrgencyTextColor(modelData.priority)
-                                        font.letterSpacing: 0.5
-                                    }
-
-                                    Item { Layout.fillWidth: true }
-
-                                    Rectangle {
-                                        Layout.preferredWidth: 70
-                                        Layout.preferredHeight: 24
-                                        radius: 6
-                                        color: "#f8fafc"
-
-                                        Text {
-                                            anchors.centerIn: parent
-                                            text: "P: " + modelData.priority
-                                            font.pixelSize: 11
-                                            color: "#64748b"
-                                            font.weight: Font.Medium
-                                        }
+                                        color: "#64748b"
+                                        font.weight: Font.Medium
                                     }
                                 }
+                            }
+
+                            Text {
+                                text: model.name
+                                font.pixelSize: 18
+                                font.weight: Font.Bold
+                                color: "#1e293b"
+                            }
+
+                            Text {
+                                text: model.condition
+                                font.pixelSize: 12
+                                color: "#64748b"
+                                wrapMode: Text.WordWrap
+                                Layout.fillWidth: true
+                                maximumLineCount: 2
+                                elide: Text.ElideRight
+                            }
+
+                            RowLayout {
+                                spacing: 16
 
                                 Text {
-                                    text: modelData.name
-                                    font.pixelSize: 18
-                                    font.weight: Font.Bold
-                                    color: "#1e293b"
+                                    text: "\u{2764}\u{FE0F} " + model.heartRate
+                                    font.pixelSize: 11
+                                    color: "#475569"
                                 }
 
                                 Text {
-                                    text: modelData.condition
-                                    font.pixelSize: 12
-                                    color: "#64748b"
-                                    wrapMode: Text.WordWrap
-                                    Layout.fillWidth: true
-                                    maximumLineCount: 2
-                                    elide: Text.ElideRight
+                                    text: "BP: " + model.bloodPressure
+                                    font.pixelSize: 11
+                                    color: "#475569"
                                 }
 
-                                RowLayout {
-                                    spacing: 16
-
-                                    Text {
-                                        text: "\u{2764}\u{FE0F} " + modelData.heartRate
-                                        font.pixelSize: 11
-                                        color: "#475569"
-                                    }
-
-                                    Text {
-                                        text: "BP: " + modelData.bloodPressure
-                                        font.pixelSize: 11
-                                        color: "#475569"
-                                    }
-
-                                    Text {
-                                        text: modelData.temperature.toFixed(1) + "\u00B0F"
-                                        font.pixelSize: 11
-                                        color: "#475569"
-                                    }
+                                Text {
+                                    text: model.temperature.toFixed(1) + "\u00B0F"
+                                    font.pixelSize: 11
+                                    color: "#475569"
                                 }
+                            }
 
-                                Item { Layout.fillHeight: true }
+                            Item { Layout.fillHeight: true }
 
-                                Button {
-                                    Layout.fillWidth: true
-                                    Layout.preferredHeight: 32
+                            Button {
+                                Layout.fillWidth: true
+                                Layout.preferredHeight: 32
 
-                                    background: Rectangle {
-                                        radius: 8
-                                        color: parent.hovered ? "#f1f5f9" : "#f8fafc"
-                                        border.width: 1
-                                        border.color: "#cbd5e1"
+                                background: Rectangle {
+                                    radius: 8
+                                    color: parent.hovered ? "#f1f5f9" : "#f8fafc"
+                                    border.width: 1
+                                    border.color: "#cbd5e1"
 
-                                        Behavior on color {
-                                            ColorAnimation { duration: 150 }
-                                        }
+                                    Behavior on color {
+                                        ColorAnimation { duration: 150 }
                                     }
+                                }
 
-                                    Text {
-                                        anchors.centerIn: parent
-                                        text: "Update Priority"
-                                        font.pixelSize: 12
-                                        font.weight: Font.Medium
-                                        color: "#475569"
-                                    }
+                                Text {
+                                    anchors.centerIn: parent
+                                    text: "Update Priority"
+                                    font.pixelSize: 12
+                                    font.weight: Font.Medium
+                                    color: "#475569"
+                                }
 
-                                    onClicked: {
-                                        updateDialog.patientId = modelData.id
-                                        updateDialog.patientName = modelData.name
-                                        updateDialog.currentPriority = modelData.priority
-                                        updateDialog.open()
-                                    }
+                                onClicked: {
+                                    updateDialog.patientId = model.id
+                                    updateDialog.patientName = model.name
+                                    updateDialog.currentPriority = model.priority
+                                    updateDialog.open()
                                 }
                             }
                         }
@@ -0,0 +1,177 @@
+#ifndef NODE_POOL_HPP
+#define NODE_POOL_HPP
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+/**
+ * Slab allocator for heap nodes.
+ * Nodes are carved out of large blocks and recycled through a free list,
+ * so inserts do not hit the global allocator and whole blocks can be
+ * released at once. A pool belongs to one heap and is not thread-safe.
+ */
+template <typename U>
+class NodePool {
+private:
+    static constexpr size_t BLOCK_ALIGN = alignof(U) > alignof(void*) ? alignof(U) : alignof(void*);
+    static constexpr size_t FIRST_BLOCK = 64;
+    static constexpr size_t MAX_BLOCK = 4096;
+
+    struct alignas(BLOCK_ALIGN) Block {
+        Block* next;
+        size_t capacity;
+    };
+
+    struct FreeSlot {
+        FreeSlot* next;
+    };
+
+    static_assert(sizeof(U) >= sizeof(FreeSlot), "Pooled type is too small for the free list");
+
+    Block* blocks;
+    Block* oldest;  // tail of the block chain, for O(1) absorb()
+    FreeSlot* freeList;
+    U* cursor;  // bump pointer into the newest block
+    U* limit;
+    size_t nextCapacity;
+
+    static U* slotsOf(Block* block) { return reinterpret_cast<U*>(block + 1); }
+
+    Block* newBlock(size_t capacity) {
+        void* raw = ::operator new(sizeof(Block) + capacity * sizeof(U));
+        Block* block = static_cast<Block*>(raw);
+        block->next = blocks;
+        block->capacity = capacity;
+        if (!blocks) oldest = block;
+        blocks = block;
+        return block;
+    }
+
+    U* allocate() {
+        if (freeList) {
+            FreeSlot* slot = freeList;
+            freeList = slot->next;
+            return reinterpret_cast<U*>(slot);
+        }
+        if (cursor == limit) {
+            Block* block = newBlock(nextCapacity);
+            cursor = slotsOf(block);
+            limit = cursor + block->capacity;
+            if (nextCapacity < MAX_BLOCK) nextCapacity *= 2;
+        }
+        return cursor++;
+    }
+
+public:
+    NodePool()
+        : blocks(nullptr), oldest(nullptr), freeList(nullptr),
+          cursor(nullptr), limit(nullptr), nextCapacity(FIRST_BLOCK) {}
+
+    ~NodePool() { releaseAll(); }
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    NodePool(NodePool&& other) noexcept
+        : blocks(other.blocks), oldest(other.oldest), freeList(other.freeList),
+          cursor(other.cursor), limit(other.limit), nextCapacity(other.nextCapacity) {
+        other.blocks = other.oldest = nullptr;
+        other.freeList = nullptr;
+        other.cursor = other.limit = nullptr;
+        other.nextCapacity = FIRST_BLOCK;
+    }
+
+    NodePool& operator=(NodePool&& other) noexcept {
+        if (this != &other) {
+            releaseAll();
+            std::swap(blocks, other.blocks);
+            std::swap(oldest, other.oldest);
+            std::swap(freeList, other.freeList);
+            std::swap(cursor, other.cursor);
+            std::swap(limit, other.limit);
+            std::swap(nextCapacity, other.nextCapacity);
+        }
+        return *this;
+    }
+
+    template <typename... Args>
+    U* create(Args&&... args) {
+        U* slot = allocate();
+        try {
+            return new (slot) U(std::forward<Args>(args)...);
+        } catch (...) {
+            reinterpret_cast<FreeSlot*>(slot)->next = freeList;
+            freeList = reinterpret_cast<FreeSlot*>(slot);
+            throw;
+        }
+    }
+
+    void destroy(U* node) {
+        if (!node) return;
+        node->~U();
+        FreeSlot* slot = reinterpret_cast<FreeSlot*>(node);
+        slot->next = freeList;
+        freeList = slot;
+    }
+
+    // Uninitialized contiguous storage for n nodes in a block of its own;
+    // the caller constructs every slot before handing them to destroy()
+    U* allocateRun(size_t n) {
+        if (n == 0) return nullptr;
+        return slotsOf(newBlock(n));
+    }
+
+    // Takes ownership of all of other's storage in O(1), e.g. when the
+    // heaps are merged. Free slots of other are only kept if this pool has
+    // none of its own; the rest is reclaimed with the blocks.
+    void absorb(NodePool& other) {
+        if (this == &other || !other.blocks) return;
+        other.oldest->next = blocks;
+        if (!blocks) oldest = other.oldest;
+        blocks = other.blocks;
+        if (!freeList) freeList = other.freeList;
+        other.blocks = other.oldest = nullptr;
+        other.freeList = nullptr;
+        other.cursor = other.limit = nullptr;
+        other.nextCapacity = FIRST_BLOCK;
+    }
+
+    bool hasBlocks() const { return blocks != nullptr; }
+
+    // Frees blocks, newest first, until they held at least maxNodes slots
+    // (always one block or more); returns true while blocks are left. The
+    // pool stays usable, but like releaseAll() this needs the objects in
+    // those blocks destroyed already.
+    bool releaseSome(size_t maxNodes) {
+        freeList = nullptr;  // may point into the blocks being freed
+        cursor = limit = nullptr;
+        size_t freed = 0;
+        while (blocks && (freed == 0 || freed < maxNodes)) {
+            Block* next = blocks->next;
+            freed += blocks->capacity;
+            ::operator delete(blocks);
+            blocks = next;
+        }
+        if (blocks) return true;
+        oldest = nullptr;
+        nextCapacity = FIRST_BLOCK;
+        return false;
+    }
+
+    // Frees every block at once. Objects still alive in the pool must
+    // already have been destroyed (or be trivially destructible).
+    void releaseAll() {
+        while (blocks) {
+            Block* next = blocks->next;
+            ::operator delete(blocks);
+            blocks = next;
+        }
+        oldest = nullptr;
+        freeList = nullptr;
+        cursor = limit = nullptr;
+        nextCapacity = FIRST_BLOCK;
+    }
+};
+
+#endif // NODE_POOL_HPP
@@ -0,0 +1,24 @@
+#ifndef PATIENT_HPP
+#define PATIENT_HPP
+
+#include <QString>
+
+// Custom structure for patient data
+struct Patient {
+    int id;
+    QString name;
+    QString condition;
+    int priority;
+    int heartRate;
+    QString bloodPressure;
+    double temperature;
+    int waitTime;
+    QString severity;
+
+    Patient(int _id, QString _name, QString _cond, int _priority)
+        : id(_id), name(_name), condition(_cond), priority(_priority),
+        heartRate(70), bloodPressure("120/80"), temperature(98.6), waitTime(0),
+        severity("STABLE") {}
+};
+
+#endif // PATIENT_HPP
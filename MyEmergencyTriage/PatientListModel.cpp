@@ -0,0 +1,152 @@
+#include "PatientListModel.hpp"
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+// Batches larger than this are applied with a model reset
+constexpr size_t RESET_THRESHOLD = 256;
+
+bool treatedBefore(int priorityA, int idA, int priorityB, int idB) {
+    return priorityA != priorityB ? priorityA < priorityB : idA < idB;
+}
+
+
+} // namespace
+
+PatientListModel::PatientListModel(QObject* parent)
+    : QAbstractListModel(parent) {}
+
+int PatientListModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : static_cast<int>(rows.size());
+}
+
+QVariant PatientListModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() < 0 || index.row() >= static_cast<int>(rows.size())) {
+        return QVariant();
+    }
+    const Patient& p = *rows[static_cast<size_t>(index.row())].patient;
+    switch (role) {
+    case IdRole: return p.id;
+    case Qt::DisplayRole:
+    case NameRole: return p.name;
+    case ConditionRole: return p.condition;
+    case PriorityRole: return p.priority;
+    case HeartRateRole: return p.heartRate;
+    case BloodPressureRole: return p.bloodPressure;
+    case TemperatureRole: return p.temperature;
+    case SeverityRole: return p.severity;
+    default: return QVariant();
+    }
+}
+
+QHash<int, QByteArray> PatientListModel::roleNames() const {
+    return {
+        {IdRole, "id"},
+        {NameRole, "name"},
+        {ConditionRole, "condition"},
+        {PriorityRole, "priority"},
+        {HeartRateRole, "heartRate"},
+        {BloodPressureRole, "bloodPressure"},
+        {TemperatureRole, "temperature"},
+        {SeverityRole, "severity"}
+    };
+}
+
+int PatientListModel::insertionRow(int priority, int id) const {
+    auto it = std::lower_bound(rows.begin(), rows.end(), 0,
+        [priority, id](const Row& row, int) {
+            return treatedBefore(row.priority, row.id, priority, id);
+        });
+    return static_cast<int>(it - rows.begin());
+}
+
+int PatientListModel::rowOf(int priority, int id) const {
+    int row = insertionRow(priority, id);
+    if (row < static_cast<int>(rows.size()) && rows[static_cast<size_t>(row)].id == id) return row;
+    return -1;
+}
+
+void PatientListModel::insertPatient(const std::shared_ptr<Patient>& patient) {
+    Row entry{patient->priority, patient->id, patient};
+    if (batchDepth > 0) {
+        pending.push_back(entry);
+        return;
+    }
+    int row = insertionRow(entry.priority, entry.id);
+    beginInsertRows(QModelIndex(), row, row);
+    rows.insert(rows.begin() + row, entry);
+    endInsertRows();
+}
+
+void PatientListModel::removePatient(const Patient& patient) {
+    flushPending();
+    int row = rowOf(patient.priority, patient.id);
+    if (row < 0) return;
+    beginRemoveRows(QModelIndex(), row, row);
+    rows.erase(rows.begin() + row);
+    endRemoveRows();
+}
+
+void PatientListModel::priorityChanged(const Patient& patient, int oldPriority) {
+    flushPending();
+    int from = rowOf(oldPriority, patient.id);
+    if (from < 0) return;
+
+    // the search still sees this row under its old priority and counts it
+    // when it sorts before the new position
+    int to = insertionRow(patient.priority, patient.id);
+    if (to > from) to--;
+    rows[static_cast<size_t>(from)].priority = patient.priority;
+
+    if (to != from) {
+        // beginMoveRows counts the destination before the source is removed
+        beginMoveRows(QModelIndex(), from, from, QModelIndex(), to > from ? to + 1 : to);
+        if (to > from) {
+            std::rotate(rows.begin() + from, rows.begin() + from + 1, rows.begin() + to + 1);
+        } else {
+            std::rotate(rows.begin() + to, rows.begin() + from, rows.begin() + from + 1);
+        }
+        endMoveRows();
+    }
+    QModelIndex changed = index(to);
+    emit dataChanged(changed, changed, {PriorityRole, SeverityRole});
+}
+
+void PatientListModel::beginBatch() {
+    batchDepth++;
+}
+
+void PatientListModel::endBatch() {
+    if (batchDepth == 0) return;
+    if (--batchDepth == 0) flushPending();
+}
+
+void PatientListModel::flushPending() {
+    if (pending.empty()) return;
+    auto rowBefore = [](const Row& a, const Row& b) {
+        return treatedBefore(a.priority, a.id, b.priority, b.id);
+    };
+    std::sort(pending.begin(), pending.end(), rowBefore);
+
+    if (pending.size() > RESET_THRESHOLD) {
+        beginResetModel();
+        std::vector<Row> merged;
+        merged.reserve(rows.size() + pending.size());
+        std::merge(rows.begin(), rows.end(), pending.begin(), pending.end(),
+                   std::back_inserter(merged), rowBefore);
+        rows.swap(merged);
+        pending.clear();
+        endResetModel();
+        return;
+    }
+
+    std::vector<Row> batch;
+    batch.swap(pending);
+    for (const Row& entry : batch) {
+        int row = insertionRow(entry.priority, entry.id);
+        beginInsertRows(QModelIndex(), row, row);
+        rows.insert(rows.begin() + row, entry);
+        endInsertRows();
+    }
+}
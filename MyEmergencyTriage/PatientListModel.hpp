@@ -0,0 +1,67 @@
+#ifndef PATIENTLISTMODEL_HPP
+#define PATIENTLISTMODEL_HPP
+
+#include <QAbstractListModel>
+#include <QByteArray>
+#include <QHash>
+#include "Patient.hpp"
+#include <memory>
+#include <vector>
+
+/**
+ * Waiting patients in treatment order, (priority, id) ascending.
+ *
+ * TriageBridge reports each heap change here and the model turns it into
+ * the matching row insert, remove, move or dataChanged, so views only
+ * touch the affected delegates. Inserts made between beginBatch() and
+ * endBatch() are merged in one pass; a large batch resets the model
+ * instead of emitting one insert per patient.
+ */
+class PatientListModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    enum Roles {
+        IdRole = Qt::UserRole + 1,
+        NameRole,
+        ConditionRole,
+        PriorityRole,
+        HeartRateRole,
+        BloodPressureRole,
+        TemperatureRole,
+        SeverityRole
+    };
+
+    explicit PatientListModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    void insertPatient(const std::shared_ptr<Patient>& patient);
+    void removePatient(const Patient& patient);
+    // patient already carries its new priority; oldPriority locates its row
+    void priorityChanged(const Patient& patient, int oldPriority);
+
+    void beginBatch();
+    void endBatch();
+
+private:
+    // The sort key is stored with the row, so the model stays ordered
+    // while the bridge updates the patient it points to
+    struct Row {
+        int priority;
+        int id;
+        std::shared_ptr<Patient> patient;
+    };
+
+    std::vector<Row> rows;
+    std::vector<Row> pending;  // batched inserts
+    int batchDepth = 0;
+
+    int rowOf(int priority, int id) const;
+    int insertionRow(int priority, int id) const;
+    void flushPending();
+};
+
+#endif // PATIENTLISTMODEL_HPP
@@ -53,7 +53,7 @@ public:
         if (heap.isEmpty()) return "";
         FibonacciHeap<string>::Node* min = heap.extractMin();
         string name = min->value;
-        delete min;
+        heap.release(min);
         return name;
     }
 
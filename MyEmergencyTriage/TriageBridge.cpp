@@ -7,6 +7,41 @@
 TriageBridge::TriageBridge(QObject* parent)
     : QObject(parent), nextPatientId(1) {
     srand(static_cast<unsigned>(time(nullptr)));  // Seed for randomization
+    notifyTimer.setSingleShot(true);
+    notifyTimer.setInterval(16);  // about one frame at 60 Hz
+    connect(&notifyTimer, &QTimer::timeout, this, &TriageBridge::flushNotifications);
+}
+
+void TriageBridge::beginUpdate() {
+    updateDepth++;
+    patientList.beginBatch();
+}
+
+void TriageBridge::endUpdate() {
+    if (updateDepth == 0) return;
+    patientList.endBatch();
+    if (--updateDepth == 0 && dirty && !notifyTimer.isActive()) {
+        notifyTimer.start();
+    }
+}
+
+void TriageBridge::markDirty(unsigned flags) {
+    dirty |= flags;
+    if (updateDepth == 0 && !notifyTimer.isActive()) {
+        notifyTimer.start();
+    }
+}
+
+void TriageBridge::flushNotifications() {
+    if (updateDepth > 0) return;  // endUpdate() reschedules
+    unsigned pending = dirty;
+    dirty = 0;
+    if (pending & DirtyPatients) emit patientsChanged();
+    if (pending & DirtyCount) emit patientCountChanged();
+    if (pending & DirtyCritical) emit criticalCountChanged();
+    if (pending & DirtyUrgent) emit urgentCountChanged();
+    if (pending & DirtyTreated) emit treatedCountChanged();
+    if (pending & DirtyTop) emit topPatientChanged();
 }
 
 int TriageBridge::patientCount() const {
@@ -15,7 +50,7 @@ int TriageBridge::patientCount() const {
 
 QVariantList TriageBridge::allPatients() const {
     QVariantList list;
-    for (const auto& node : heap.getRootList()) {
+    for (const auto& node : heap.nodes()) {
         list.append(patientToVariant(node->value));
     }
     return list;
@@ -25,27 +60,30 @@ void TriageBridge::addPatient(QString name, QString condition, int priority) {
     auto patient = std::make_shared<Patient>(nextPatientId++, name, condition, priority);
     patient->severity = getSeverity(priority);
     generateVitals(*patient);  // Generate dummy vitals (heart rate, BP, etc.)
-    heap.insert(patient, priority);
+    if (nodeById.size() <= static_cast<size_t>(patient->id)) {
+        nodeById.resize(static_cast<size_t>(patient->id) + 1, nullptr);
+    }
+    nodeById[static_cast<size_t>(patient->id)] = heap.insert(patient, priority);
+    patientList.insertPatient(patient);
 
-    emit patientsChanged();
-    emit patientCountChanged();
-    emit criticalCountChanged();
-    emit urgentCountChanged();
-    emit topPatientChanged();
+    markDirty(DirtyPatients | DirtyCount | DirtyCritical | DirtyUrgent | DirtyTop);
 }
 
-void TriageBridge::simulateMassEmergency() {
-    for (int i = 0; i < 50; ++i) {
+void TriageBridge::simulateMassEmergency(int count) {
+    UpdateScope scope(this);
+    for (int i = 0; i < count; ++i) {
         addPatient(getRandomName(), getRandomCondition(), rand() % 10 + 1);
     }
 }
 
 QString TriageBridge::getSeverity(int priority) {
-    if (priority <= 1) return "CRITICAL";
-    if (priority <= 3) return "URGENT";
-    if (priority <= 5) return "MODERATE";
-    if (priority <= 8) return "STABLE";
-    return "ROUTINE";
+    switch (SeverityCounter::levelOf(priority)) {
+    case SeverityCounter::CRITICAL: return "CRITICAL";
+    case SeverityCounter::URGENT: return "URGENT";
+    case SeverityCounter::MODERATE: return "MODERATE";
+    case SeverityCounter::STABLE: return "STABLE";
+    default: return "ROUTINE";
+    }
 }
 
 QVariantMap TriageBridge::patientToVariant(const std::shared_ptr<Patient>& p) const {
@@ -62,31 +100,23 @@ QVariantMap TriageBridge::patientToVariant(const std::shared_ptr<Patient>& p) co
 }
 
 QString TriageBridge::getRandomName() {
-    QStringList names = {"John Doe", "Jane Smith", "Alice Green", "Bob Brown", "Charlie White"};
+    static const QStringList names = {"John Doe", "Jane Smith", "Alice Green", "Bob Brown", "Charlie White"};
     return names[rand() % names.size()];
 }
 
 QString TriageBridge::getRandomCondition() {
-    QStringList conditions = {
+    static const QStringList conditions = {
         "Chest Pain", "Fever", "Fracture", "Severe Allergy", "Shortness of Breath"
     };
     return conditions[rand() % conditions.size()];
 }
 
 int TriageBridge::criticalCount() const {
-    int count = 0;
-    for (const auto& node : heap.getRootList()) {
-        if (node->value->priority <= 1) count++;
-    }
-    return count;
+    return heap.getObserver().count(SeverityCounter::CRITICAL);
 }
 
 int TriageBridge::urgentCount() const {
-    int count = 0;
-    for (const auto& node : heap.getRootList()) {
-        if (node->value->priority > 1 && node->value->priority <= 3) count++;
-    }
-    return count;
+    return heap.getObserver().count(SeverityCounter::URGENT);
 }
 
 int TriageBridge::treatedCount() const {
@@ -109,34 +139,38 @@ void TriageBridge::treatNext() {
     auto minNode = heap.extractMin();
     if (minNode) {
         treated++;
-        emit treatedCountChanged();
-        emit patientCountChanged();
-        emit criticalCountChanged();
-        emit urgentCountChanged();
-        emit topPatientChanged();
-        emit patientsChanged();
-        delete minNode;  // Free memory for the treated patient node
+        nodeById[static_cast<size_t>(minNode->value->id)] = nullptr;
+        patientList.removePatient(*minNode->value);
+        markDirty(DirtyTreated | DirtyCount | DirtyCritical | DirtyUrgent | DirtyTop | DirtyPatients);
+        heap.release(minNode);  // Free memory for the treated patient node
     }
 }
 
+TriageBridge::PatientHeap::Node* TriageBridge::findNode(int patientId) const {
+    if (patientId < 0 || static_cast<size_t>(patientId) >= nodeById.size()) return nullptr;
+    return nodeById[static_cast<size_t>(patientId)];
+}
+
 void TriageBridge::updatePriority(int patientId, int newPriority) {
-    auto nodes = heap.getRootList();
-    for (auto node : nodes) {
-        if (node->value->id == patientId) {
-            heap.updateKey(node, newPriority);
-            node->value->priority = newPriority;
-            node->value->severity = getSeverity(newPriority);
-            emit patientsChanged();
-            emit criticalCountChanged();
-            emit urgentCountChanged();
-            emit topPatientChanged();
-            return;
-        }
+    PatientHeap::Node* node = findNode(patientId);
+    if (!node) {
+        qDebug() << "Patient ID not found!";
+        return;
     }
-    qDebug() << "Patient ID not found!";
+
+    // An increase re-inserts the patient in a new node, so keep the patient
+    // itself rather than the node across the update, and re-index it
+    std::shared_ptr<Patient> patient = node->value;
+    int oldPriority = patient->priority;
+    nodeById[static_cast<size_t>(patientId)] = heap.updateKey(node, newPriority);
+    patient->priority = newPriority;
+    patient->severity = getSeverity(newPriority);
+    patientList.priorityChanged(*patient, oldPriority);
+    markDirty(DirtyPatients | DirtyCritical | DirtyUrgent | DirtyTop);
 }
 
 void TriageBridge::initializeSampleData() {
+    UpdateScope scope(this);
     addPatient("Sarah Johnson", "Severe chest pain", 2);
     addPatient("David Wilson", "Possible fracture", 4);
     addPatient("Michael Brown", "Head trauma", 6);
@@ -3,35 +3,53 @@
 
 #include <QObject>
 #include <QString>
+#include <QTimer>
 #include <QVariantList>
 #include <QVariantMap>
 #include "FibonacciHeap.hpp"
 #include "FibonacciHeap.tpp"
+#include "PatientListModel.hpp"
+#include <algorithm>
+#include <iterator>
 #include <memory>
 #include <random>
+#include <vector>
 
-// Custom structure for patient data
-struct Patient {
-    int id;
-    QString name;
-    QString condition;
-    int priority;
-    int heartRate;
-    QString bloodPressure;
-    double temperature;
-    int waitTime;
-    QString severity;
-
-    Patient(int _id, QString _name, QString _cond, int _priority)
-        : id(_id), name(_name), condition(_cond), priority(_priority),
-        heartRate(70), bloodPressure("120/80"), temperature(98.6), waitTime(0),
-        severity("STABLE") {}
+// Heap observer keeping the number of waiting patients per severity level.
+// The heap key is the priority, so every count follows inserts, extracts
+// and key changes exactly, and reading one is O(1).
+struct SeverityCounter : NullHeapObserver {
+    enum Level { CRITICAL, URGENT, MODERATE, STABLE, ROUTINE, LEVEL_COUNT };
+
+    int counts[LEVEL_COUNT] = {};
+
+    static Level levelOf(int priority) {
+        if (priority <= 1) return CRITICAL;
+        if (priority <= 3) return URGENT;
+        if (priority <= 5) return MODERATE;
+        if (priority <= 8) return STABLE;
+        return ROUTINE;
+    }
+
+    int count(Level level) const { return counts[level]; }
+
+    template <typename Node> void inserted(const Node* node) { counts[levelOf(node->key)]++; }
+    template <typename Node> void extracted(const Node* node) { counts[levelOf(node->key)]--; }
+    template <typename Node> void keyChanged(const Node* node, int oldKey) {
+        counts[levelOf(oldKey)]--;
+        counts[levelOf(node->key)]++;
+    }
+    template <typename Node> void merged(const Node*, SeverityCounter& source) {
+        for (int level = 0; level < LEVEL_COUNT; ++level) counts[level] += source.counts[level];
+    }
+    void cleared() { std::fill(std::begin(counts), std::end(counts), 0); }
 };
 
 class TriageBridge : public QObject {
     Q_OBJECT
     Q_PROPERTY(int patientCount READ patientCount NOTIFY patientCountChanged)
     Q_PROPERTY(QVariantList allPatients READ allPatients NOTIFY patientsChanged)
+    Q_PROPERTY(QAbstractItemModel* patientModel READ patientModel CONSTANT)
     Q_PROPERTY(int criticalCount READ criticalCount NOTIFY criticalCountChanged)
     Q_PROPERTY(int urgentCount READ urgentCount NOTIFY urgentCountChanged)
     Q_PROPERTY(int treatedCount READ treatedCount NOTIFY treatedCountChanged)
@@ -43,14 +61,21 @@ public:
 
     int patientCount() const;
     QVariantList allPatients() const;
+    QAbstractItemModel* patientModel() { return &patientList; }
 
     // QML-exposed methods
     Q_INVOKABLE void addPatient(QString name, QString condition, int priority);
-    Q_INVOKABLE void simulateMassEmergency();
+    Q_INVOKABLE void simulateMassEmergency(int count = 50);
     Q_INVOKABLE void treatNext();
     Q_INVOKABLE void updatePriority(int patientId, int newPriority);
     Q_INVOKABLE void initializeSampleData();
 
+    // Change notifications are coalesced: mutations only mark properties
+    // dirty, and each dirty property is signalled once per frame. Between
+    // beginUpdate() and the matching endUpdate() nothing is signalled at all.
+    Q_INVOKABLE void beginUpdate();
+    Q_INVOKABLE void endUpdate();
+
     // Severity level counters
     int criticalCount() const;
     int urgentCount() const;
@@ -68,10 +93,40 @@ signals:
     void topPatientChanged();
 
 private:
-    FibonacciHeap<std::shared_ptr<Patient>> heap;
+    enum DirtyFlag {
+        DirtyPatients = 1 << 0,
+        DirtyCount = 1 << 1,
+        DirtyCritical = 1 << 2,
+        DirtyUrgent = 1 << 3,
+        DirtyTreated = 1 << 4,
+        DirtyTop = 1 << 5
+    };
+
+    // Holds a beginUpdate()/endUpdate() pair for the duration of a scope
+    struct UpdateScope {
+        TriageBridge* bridge;
+        explicit UpdateScope(TriageBridge* b) : bridge(b) { bridge->beginUpdate(); }
+        ~UpdateScope() { bridge->endUpdate(); }
+    };
+
+    using PatientHeap = FibonacciHeap<std::shared_ptr<Patient>, SeverityCounter>;
+
+    PatientHeap heap;
+    PatientListModel patientList;  // the queue in treatment order, for views
+    // Heap node of each waiting patient, indexed by id (ids are handed out
+    // consecutively from nextPatientId); null once a patient is treated
+    std::vector<PatientHeap::Node*> nodeById;
     int nextPatientId;
     int treated = 0;
 
+    unsigned dirty = 0;
+    int updateDepth = 0;
+    QTimer notifyTimer;  // single-shot, one frame
+
+    PatientHeap::Node* findNode(int patientId) const;
+    void markDirty(unsigned flags);
+    void flushNotifications();
+
     QVariantMap patientToVariant(const std::shared_ptr<Patient>& p) const;
 
     // Helper methods
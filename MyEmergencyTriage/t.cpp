@@ -0,0 +1,11 @@
+#include "sc.hpp"
+#include <memory>
+#include <random>
+#include <cstdio>
+struct P{int id;};
+int main(){ FibonacciHeap<std::shared_ptr<P>,SeverityCounter> h; std::vector<decltype(h)::Node*> v; std::mt19937 r(1);
+ for(int i=0;i<20000;i++){ int op=r()%4; if(op<2||v.empty()){ v.push_back(h.insert(std::make_shared<P>(P{i}), 1+r()%10)); }
+  else if(op==2){ auto*m=h.extractMin(); for(auto&x:v) if(x==m){x=v.back();v.pop_back();break;} h.release(m);} 
+  else { size_t j=r()%v.size(); v[j]=h.updateKey(v[j],1+r()%10);} 
+  int c[5]={}; for(auto*n:h.nodes()) c[SeverityCounter::levelOf(n->key)]++; for(int l=0;l<5;l++) if(c[l]!=h.getObserver().counts[l]){printf("bad\n");return 1;} }
+ printf("ok\n"); }
@@ -8,9 +8,35 @@
 
 AppWindow::AppWindow(QWidget* parent) 
     : QMainWindow(parent), taskCounter(0) {
+    // Record the live workload for heap_replay when a trace path is given
+    QString tracePath = qEnvironmentVariable("TASKMANAGER_TRACE");
+    if (!tracePath.isEmpty()) {
+        try {
+            traceWriter = std::make_unique<HeapTraceWriter>(tracePath.toStdString());
+            taskManager.setTraceWriter(traceWriter.get());
+        } catch (const std::exception& e) {
+            qWarning("Trace recording disabled: %s", e.what());
+        }
+    }
+
+    // Persist the queue across restarts when a data directory is given
+    QString dataDir = qEnvironmentVariable("TASKMANAGER_DATA_DIR");
+    if (!dataDir.isEmpty()) {
+        bool ok = false;
+        long windowUs = qEnvironmentVariable("TASKMANAGER_COMMIT_WINDOW_US").toLong(&ok);
+        if (!ok || windowUs < 0) windowUs = 2000;
+        try {
+            taskManager.enableJournal(dataDir.toStdString(), std::chrono::microseconds(windowUs));
+        } catch (const std::exception& e) {
+            qWarning("Journal disabled: %s", e.what());
+        }
+    }
+    
     setupUI();
-    initializeSampleTasks();
-    refreshTaskList();
+    if (taskManager.getPendingCount() == 0) {
+        initializeSampleTasks();
+    }
+    updateQueueStatus();
     
     timer = new QTimer(this);
     connect(timer, &QTimer::timeout, this, &AppWindow::updateTime);
@@ -20,6 +46,7 @@ AppWindow::AppWindow(QWidget* parent)
 
 AppWindow::~AppWindow() {
     // Qt handles memory cleanup via parent-child hierarchy
+    taskManager.setTraceWriter(nullptr);
 }
 
 void AppWindow::setupUI() {
@@ -92,18 +119,33 @@ void AppWindow::setupUI() {
     taskGroup->setStyleSheet("QGroupBox { background-color: rgba(255, 255, 255, 0.85); border-radius: 5px; padding: 10px; font-weight: bold; }");
     QVBoxLayout* taskGroupLayout = new QVBoxLayout(taskGroup);
     
-    scrollArea = new QScrollArea(this);
-    scrollArea->setWidgetResizable(true);
-    scrollArea->setStyleSheet("QScrollArea { border: 1px solid rgba(189, 195, 199, 0.8); background-color: rgba(255, 255, 255, 0.6); }");
-    
-    QWidget* scrollWidget = new QWidget();
-    scrollWidget->setStyleSheet("background-color: transparent;");
-    taskListLayout = new QVBoxLayout(scrollWidget);
-    taskListLayout->setAlignment(Qt::AlignTop);
-    taskListLayout->setSpacing(5);
-    scrollArea->setWidget(scrollWidget);
-    
-    taskGroupLayout->addWidget(scrollArea);
+    // The view only paints the visible rows, and the model follows the
+    // task manager row by row, so no action rebuilds the list
+    taskModel = new TaskListModel(taskManager, this);
+    TaskItemDelegate* taskDelegate = new TaskItemDelegate(this);
+    taskListView = new QListView(this);
+    taskListView->setModel(taskModel);
+    taskListView->setItemDelegate(taskDelegate);
+    taskListView->setUniformItemSizes(true);
+    taskListView->setSelectionMode(QAbstractItemView::NoSelection);
+    taskListView->setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+    taskListView->setStyleSheet("QListView { border: 1px solid rgba(189, 195, 199, 0.8); background-color: rgba(255, 255, 255, 0.6); }");
+
+    // Queued, so the task is changed after the view has finished with the click
+    connect(taskDelegate, &TaskItemDelegate::completeRequested,
+            this, &AppWindow::completeTask, Qt::QueuedConnection);
+    connect(taskDelegate, &TaskItemDelegate::updateRequested,
+            this, &AppWindow::updateTaskPriority, Qt::QueuedConnection);
+    connect(taskModel, &QAbstractItemModel::rowsInserted, this, &AppWindow::updateQueueStatus);
+    connect(taskModel, &QAbstractItemModel::rowsRemoved, this, &AppWindow::updateQueueStatus);
+    connect(taskModel, &QAbstractItemModel::modelReset, this, &AppWindow::updateQueueStatus);
+
+    emptyLabel = new QLabel("No patients in queue", this);
+    emptyLabel->setAlignment(Qt::AlignCenter);
+    emptyLabel->setStyleSheet("color: #95a5a6; font-size: 14px; padding: 20px;");
+
+    taskGroupLayout->addWidget(emptyLabel);
+    taskGroupLayout->addWidget(taskListView);
     mainLayout->addWidget(taskGroup);
     
     // Legend
@@ -121,78 +163,10 @@ void AppWindow::initializeSampleTasks() {
     taskCounter = 3;
 }
 
-void AppWindow::refreshTaskList() {
-    // Clear existing task widgets
-    QLayoutItem* item;
-    while ((item = taskListLayout->takeAt(0)) != nullptr) {
-        delete item->widget();
-        delete item;
-    }
-    
-    // Get all tasks from task manager
-    auto tasks = taskManager.getAllTasks();
-    
-    if (tasks.empty()) {
-        QLabel* emptyLabel = new QLabel("No patients in queue", this);
-        emptyLabel->setAlignment(Qt::AlignCenter);
-        emptyLabel->setStyleSheet("color: #95a5a6; font-size: 14px; padding: 20px;");
-        taskListLayout->addWidget(emptyLabel);
-    } else {
-        // Sort tasks by urgency for display purposes
-        // Note: The heap internally maintains priority; this sorting is only for UI presentation
-        // to show patients grouped by urgency level for better readability
-        std::sort(tasks.begin(), tasks.end(),
-            [](const Task& a, const Task& b) {
-                return static_cast<int>(a.urgency) < static_cast<int>(b.urgency);
-            });
-        
-        for (const auto& task : tasks) {
-            QFrame* taskFrame = new QFrame(this);
-            QColor bgColor = urgencyToColor(task.urgency);
-            bgColor.setAlpha(220);  // Add transparency to task cards
-            taskFrame->setStyleSheet(
-                "QFrame { background-color: " + bgColor.name(QColor::HexArgb) + 
-                "; border-left: 5px solid #34495e; border-radius: 3px; padding: 8px; margin: 2px; }"
-            );
-            
-            QHBoxLayout* taskLayout = new QHBoxLayout(taskFrame);
-            
-            // Priority indicator
-            QString urgencyStr = urgencyToString(task.urgency);
-            QLabel* priorityLabel = new QLabel(urgencyStr, this);
-            priorityLabel->setFixedWidth(100);
-            priorityLabel->setStyleSheet("font-weight: bold; color: #2c3e50;");
-            
-            // Task name
-            QLabel* nameLabel = new QLabel(QString::fromStdString(task.name), this);
-            nameLabel->setStyleSheet("color: #2c3e50; font-size: 12px;");
-            
-            // Action buttons
-            QPushButton* completeBtn = new QPushButton("Complete", this);
-            completeBtn->setFixedWidth(80);
-            completeBtn->setStyleSheet("background-color: rgba(39, 174, 96, 0.9); color: white; border-radius: 3px; padding: 5px;");
-            connect(completeBtn, &QPushButton::clicked, this, [this, taskName = task.name]() {
-                completeTask(QString::fromStdString(taskName));
-            });
-            
-            QPushButton* updateBtn = new QPushButton("Update", this);
-            updateBtn->setFixedWidth(80);
-            updateBtn->setStyleSheet("background-color: rgba(52, 152, 219, 0.9); color: white; border-radius: 3px; padding: 5px;");
-            connect(updateBtn, &QPushButton::clicked, this, [this, taskName = task.name]() {
-                updateTaskPriority(QString::fromStdString(taskName));
-            });
-            
-            taskLayout->addWidget(priorityLabel);
-            taskLayout->addWidget(nameLabel);
-            taskLayout->addStretch();
-            taskLayout->addWidget(updateBtn);
-            taskLayout->addWidget(completeBtn);
-            
-            taskListLayout->addWidget(taskFrame);
-        }
-    }
-    
-    // Update active count
+void AppWindow::updateQueueStatus() {
+    bool empty = taskModel->rowCount() == 0;
+    emptyLabel->setVisible(empty);
+    taskListView->setVisible(!empty);
     activeTasksLabel->setText(QString::number(taskManager.getPendingCount()) + " Active Tasks");
 }
 
@@ -216,7 +190,6 @@ void AppWindow::addTask() {
             taskManager.addPatient(taskName.toStdString(), urgency);
             taskCounter++;
             showNotification("✅ Patient added: " + taskName);
-            refreshTaskList();
         }
     }
 }
@@ -237,14 +210,12 @@ void AppWindow::treatNext() {
         showNotification("ℹ️ No patients in queue");
     } else {
         showNotification("✅ Treated: " + QString::fromStdString(treated));
-        refreshTaskList();
     }
 }
 
 void AppWindow::completeTask(const QString& taskName) {
     taskManager.removeTask(taskName.toStdString());
     showNotification("✅ Completed: " + taskName);
-    refreshTaskList();
 }
 
 void AppWindow::updateTaskPriority(const QString& taskName) {
@@ -262,7 +233,6 @@ void AppWindow::updateTaskPriority(const QString& taskName) {
         
         if (taskManager.updatePatientStatus(taskName.toStdString(), urgency)) {
             showNotification("✅ Priority updated for: " + taskName);
-            refreshTaskList();
         } else {
             showNotification("❌ Failed to update priority");
         }
@@ -277,23 +247,3 @@ void AppWindow::updateTime() {
 void AppWindow::showNotification(const QString& message) {
     statusBar()->showMessage(message, 3000);
 }
-
-QString AppWindow::urgencyToString(Urgency priority) const {
-    switch (priority) {
-        case Urgency::CRITICAL: return "🔴 CRITICAL";
-        case Urgency::URGENT: return "🟠 URGENT";
-        case Urgency::MODERATE: return "🟡 MODERATE";
-        case Urgency::MINOR: return "🟢 MINOR";
-        default: return "UNKNOWN";
-    }
-}
-
-QColor AppWindow::urgencyToColor(Urgency priority) const {
-    switch (priority) {
-        case Urgency::CRITICAL: return QColor("#ffebee");
-        case Urgency::URGENT: return QColor("#fff3e0");
-        case Urgency::MODERATE: return QColor("#fff9c4");
-        case Urgency::MINOR: return QColor("#e8f5e9");
-        default: return QColor("#f5f5f5");
-    }
-}
\ No newline at end of file
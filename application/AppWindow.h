@@ -9,10 +9,13 @@
 #include <QInputDialog>
 #include <QMessageBox>
 #include <QTimer>
-#include <QScrollArea>
+#include <QListView>
 #include <QComboBox>
 #include <QStatusBar>
 #include "TaskManager.h"
+#include "TaskListModel.h"
+#include "TaskItemDelegate.h"
+#include <memory>
 
 class AppWindow : public QMainWindow
 {
@@ -20,20 +23,18 @@ class AppWindow : public QMainWindow
 
 private:
     TaskManager taskManager;
+    std::unique_ptr<HeapTraceWriter> traceWriter;  // Set when TASKMANAGER_TRACE is defined
     QWidget* centralWidget;
     QVBoxLayout* mainLayout;
-    QVBoxLayout* taskListLayout;
-    QScrollArea* scrollArea;
-    QLabel *timeLabel, *activeTasksLabel;
+    TaskListModel* taskModel;
+    QListView* taskListView;
+    QLabel *timeLabel, *activeTasksLabel, *emptyLabel;
     QTimer* timer;
     int taskCounter;
 
     void setupUI();
     void initializeSampleTasks();
-    void refreshTaskList();
-    int getActiveTaskCount();
-    QString urgencyToString(Urgency priority) const;
-    QColor urgencyToColor(Urgency priority) const;
+    void updateQueueStatus();
 
 private slots:
     void addTask();
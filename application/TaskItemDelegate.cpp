@@ -0,0 +1,125 @@
+#include "TaskItemDelegate.h"
+#include "TaskListModel.h"
+#include <QEvent>
+#include <QMouseEvent>
+#include <QPainter>
+
+namespace {
+
+constexpr int ROW_HEIGHT = 48;
+constexpr int CARD_MARGIN = 2;
+constexpr int BUTTON_WIDTH = 80;
+constexpr int BUTTON_HEIGHT = 28;
+constexpr int BUTTON_SPACING = 6;
+constexpr int PRIORITY_WIDTH = 100;
+
+void drawButton(QPainter* painter, const QRect& rect, const QColor& color, const QString& text) {
+    painter->setPen(Qt::NoPen);
+    painter->setBrush(color);
+    painter->drawRoundedRect(rect, 3, 3);
+    painter->setPen(Qt::white);
+    painter->drawText(rect, Qt::AlignCenter, text);
+}
+
+} // namespace
+
+TaskItemDelegate::TaskItemDelegate(QObject* parent)
+    : QStyledItemDelegate(parent) {}
+
+QRect TaskItemDelegate::cardRect(const QRect& itemRect) {
+    return itemRect.adjusted(CARD_MARGIN, CARD_MARGIN, -CARD_MARGIN, -CARD_MARGIN);
+}
+
+QRect TaskItemDelegate::completeButtonRect(const QRect& itemRect) {
+    QRect card = cardRect(itemRect);
+    return QRect(card.right() - 8 - BUTTON_WIDTH, card.center().y() - BUTTON_HEIGHT / 2,
+                 BUTTON_WIDTH, BUTTON_HEIGHT);
+}
+
+QRect TaskItemDelegate::updateButtonRect(const QRect& itemRect) {
+    return completeButtonRect(itemRect).translated(-(BUTTON_WIDTH + BUTTON_SPACING), 0);
+}
+
+void TaskItemDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option,
+                             const QModelIndex& index) const {
+    Urgency urgency = static_cast<Urgency>(index.data(TaskListModel::UrgencyRole).toInt());
+    QString name = index.data(TaskListModel::NameRole).toString();
+    QRect card = cardRect(option.rect);
+
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+
+    // Card background with the urgency colour and a dark left border
+    QColor bgColor = urgencyToColor(urgency);
+    bgColor.setAlpha(220);  // Add transparency to task cards
+    painter->setPen(Qt::NoPen);
+    painter->setBrush(bgColor);
+    painter->drawRoundedRect(card, 3, 3);
+    painter->setBrush(QColor("#34495e"));
+    painter->drawRect(QRect(card.left(), card.top(), 5, card.height()));
+
+    // Priority indicator and task name
+    QRect textRect = card.adjusted(16, 0, 0, 0);
+    QFont font = option.font;
+    font.setBold(true);
+    painter->setFont(font);
+    painter->setPen(QColor("#2c3e50"));
+    painter->drawText(QRect(textRect.left(), textRect.top(), PRIORITY_WIDTH, textRect.height()),
+                      Qt::AlignVCenter | Qt::AlignLeft, urgencyToString(urgency));
+
+    font.setBold(false);
+    painter->setFont(font);
+    QRect updateRect = updateButtonRect(option.rect);
+    QRect nameRect(textRect.left() + PRIORITY_WIDTH, textRect.top(),
+                   updateRect.left() - BUTTON_SPACING - textRect.left() - PRIORITY_WIDTH, textRect.height());
+    painter->drawText(nameRect, Qt::AlignVCenter | Qt::AlignLeft,
+                      painter->fontMetrics().elidedText(name, Qt::ElideRight, nameRect.width()));
+
+    // Action buttons
+    drawButton(painter, updateRect, QColor(52, 152, 219, 230), "Update");
+    drawButton(painter, completeButtonRect(option.rect), QColor(39, 174, 96, 230), "Complete");
+
+    painter->restore();
+}
+
+QSize TaskItemDelegate::sizeHint(const QStyleOptionViewItem& option, const QModelIndex&) const {
+    return QSize(option.rect.width(), ROW_HEIGHT);
+}
+
+bool TaskItemDelegate::editorEvent(QEvent* event, QAbstractItemModel* model,
+                                   const QStyleOptionViewItem& option, const QModelIndex& index) {
+    if (event->type() == QEvent::MouseButtonRelease) {
+        auto* mouseEvent = static_cast<QMouseEvent*>(event);
+        QPoint pos = mouseEvent->position().toPoint();
+        QString name = index.data(TaskListModel::NameRole).toString();
+        if (updateButtonRect(option.rect).contains(pos)) {
+            emit updateRequested(name);
+            return true;
+        }
+        if (completeButtonRect(option.rect).contains(pos)) {
+            emit completeRequested(name);
+            return true;
+        }
+    }
+    return QStyledItemDelegate::editorEvent(event, model, option, index);
+}
+
+QString TaskItemDelegate::urgencyToString(Urgency priority) {
+    switch (priority) {
+        case Urgency::CRITICAL: return "🔴 CRITICAL";
+        case Urgency::URGENT: return "🟠 URGENT";
+        case Urgency::MODERATE: return "🟡 MODERATE";
+        case Urgency::MINOR: return "🟢 MINOR";
+        default: return "UNKNOWN";
+    }
+}
+
+QColor TaskItemDelegate::urgencyToColor(Urgency priority) {
+    switch (priority) {
+        case Urgency::CRITICAL: return QColor("#ffebee");
+        case Urgency::URGENT: return QColor("#fff3e0");
+        case Urgency::MODERATE: return QColor("#fff9c4");
+        case Urgency::MINOR: return QColor("#e8f5e9");
+        default: return QColor("#f5f5f5");
+    }
+}
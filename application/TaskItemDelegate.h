@@ -0,0 +1,41 @@
+#ifndef TASKITEMDELEGATE_H
+#define TASKITEMDELEGATE_H
+
+#include <QColor>
+#include <QRect>
+#include <QString>
+#include <QStyledItemDelegate>
+#include "TaskManager.h"
+
+/**
+ * Paints one task of a TaskListModel as a card with its urgency, its name
+ * and "Update" / "Complete" buttons. The buttons are drawn, not widgets:
+ * a click on one is found by hit-testing in editorEvent() and reported
+ * through a signal, so a row costs nothing until it is painted.
+ */
+class TaskItemDelegate : public QStyledItemDelegate {
+    Q_OBJECT
+
+public:
+    explicit TaskItemDelegate(QObject* parent = nullptr);
+
+    void paint(QPainter* painter, const QStyleOptionViewItem& option,
+               const QModelIndex& index) const override;
+    QSize sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+    bool editorEvent(QEvent* event, QAbstractItemModel* model,
+                     const QStyleOptionViewItem& option, const QModelIndex& index) override;
+
+    static QString urgencyToString(Urgency priority);
+    static QColor urgencyToColor(Urgency priority);
+
+signals:
+    void updateRequested(const QString& taskName);
+    void completeRequested(const QString& taskName);
+
+private:
+    static QRect cardRect(const QRect& itemRect);
+    static QRect completeButtonRect(const QRect& itemRect);
+    static QRect updateButtonRect(const QRect& itemRect);
+};
+
+#endif // TASKITEMDELEGATE_H
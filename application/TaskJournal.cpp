@@ -0,0 +1,246 @@
+#include "TaskJournal.h"
+#include "MappedFile.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// File layout: 8-byte header, then records of
+//   u32 payload length | u32 checksum | u8 op | u8 urgency | name bytes
+// where the payload is everything after the checksum.
+constexpr char JOURNAL_MAGIC[4] = {'T', 'M', 'W', 'L'};
+constexpr uint32_t JOURNAL_VERSION = 1;
+constexpr size_t HEADER_SIZE = 8;
+constexpr size_t RECORD_PREFIX = 8;
+
+uint32_t checksum(const char* data, size_t length) {
+    uint32_t hash = 2166136261u;  // FNV-1a
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void dataSync(int fd) {
+#if defined(__APPLE__)
+    int result = ::fsync(fd);
+#else
+    int result = ::fdatasync(fd);
+#endif
+    if (result != 0) throw std::runtime_error("Journal sync failed");
+}
+
+void writeFully(int fd, const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t n = ::write(fd, data, length);
+        if (n < 0) throw std::runtime_error("Journal write failed");
+        data += n;
+        length -= static_cast<size_t>(n);
+    }
+}
+
+void writeHeader(int fd) {
+    char header[HEADER_SIZE];
+    std::memcpy(header, JOURNAL_MAGIC, 4);
+    std::memcpy(header + 4, &JOURNAL_VERSION, 4);
+    writeFully(fd, header, sizeof(header));
+}
+
+// Walks the intact records of a journal image and returns the length of
+// the valid prefix
+template <typename F>
+size_t scan(const unsigned char* data, size_t size, F onRecord) {
+    if (size < HEADER_SIZE || std::memcmp(data, JOURNAL_MAGIC, 4) != 0) return 0;
+    size_t offset = HEADER_SIZE;
+    while (size - offset >= RECORD_PREFIX) {
+        uint32_t length, sum;
+        std::memcpy(&length, data + offset, 4);
+        std::memcpy(&sum, data + offset + 4, 4);
+        if (length < 2 || size - offset - RECORD_PREFIX < length) break;
+        const char* payload = reinterpret_cast<const char*>(data + offset + RECORD_PREFIX);
+        if (checksum(payload, length) != sum) break;
+        onRecord(static_cast<JournalOp>(payload[0]),
+                 std::string(payload + 2, length - 2),
+                 static_cast<int>(static_cast<unsigned char>(payload[1])));
+        offset += RECORD_PREFIX + length;
+    }
+    return offset;
+}
+
+} // namespace
+
+TaskJournal::TaskJournal(const std::string& p, std::chrono::microseconds commitWindow)
+    : path(p), fd(-1), window(commitWindow), appendedSeq(0), durableSeq(0),
+      syncs(0), flushNow(false), stopping(false) {
+    // Keep only the intact prefix of an existing log, dropping a torn tail
+    size_t validLength = 0;
+    struct stat st;
+    if (::stat(path.c_str(), &st) == 0 && st.st_size > 0) {
+        MappedFile existing(path);
+        validLength = scan(existing.data(), existing.size(),
+                           [](JournalOp, const std::string&, int) {});
+    }
+
+    fd = ::open(path.c_str(), O_WRONLY | O_CREAT, 0644);
+    if (fd < 0) throw std::runtime_error("Cannot open journal " + path);
+    if (::ftruncate(fd, static_cast<off_t>(validLength)) != 0 ||
+        ::lseek(fd, 0, SEEK_END) < 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot prepare journal " + path);
+    }
+    if (validLength == 0) {
+        writeHeader(fd);
+        dataSync(fd);
+    }
+
+    if (window.count() > 0) {
+        flusher = std::thread(&TaskJournal::flusherLoop, this);
+    }
+}
+
+TaskJournal::~TaskJournal() {
+    if (flusher.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        flushRequested.notify_one();
+        flusher.join();
+    }
+    if (fd >= 0) ::close(fd);
+}
+
+void TaskJournal::encode(std::vector<char>& out, JournalOp op, const std::string& name, int urgency) {
+    uint32_t length = static_cast<uint32_t>(name.size() + 2);
+    size_t start = out.size();
+    out.resize(start + RECORD_PREFIX + length);
+    char* record = out.data() + start;
+    char* payload = record + RECORD_PREFIX;
+    payload[0] = static_cast<char>(op);
+    payload[1] = static_cast<char>(urgency);
+    std::memcpy(payload + 2, name.data(), name.size());
+    uint32_t sum = checksum(payload, length);
+    std::memcpy(record, &length, 4);
+    std::memcpy(record + 4, &sum, 4);
+}
+
+void TaskJournal::writeAndSync(const std::vector<char>& bytes) {
+    writeFully(fd, bytes.data(), bytes.size());
+    dataSync(fd);
+}
+
+void TaskJournal::append(JournalOp op, const std::string& name, int urgency) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (error) std::rethrow_exception(error);
+    encode(pending, op, name, urgency);
+    appendedSeq++;
+    if (window.count() == 0) {
+        // No batching: the caller pays for its own sync
+        try {
+            writeAndSync(pending);
+        } catch (...) {
+            error = std::current_exception();
+            throw;
+        }
+        pending.clear();
+        durableSeq = appendedSeq;
+        syncs++;
+    }
+}
+
+void TaskJournal::flusherLoop() {
+    std::vector<char> batch;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        flushRequested.wait_for(lock, window, [this] { return flushNow || stopping; });
+        flushNow = false;
+        if (pending.empty()) {
+            if (stopping) break;
+            continue;
+        }
+        batch.swap(pending);
+        uint64_t batchSeq = appendedSeq;
+
+        // Appends continue into the fresh buffer while this batch is synced
+        lock.unlock();
+        std::exception_ptr failure;
+        try {
+            writeAndSync(batch);
+        } catch (...) {
+            failure = std::current_exception();
+        }
+        batch.clear();
+        lock.lock();
+
+        if (failure) {
+            // Nothing written after a failed write can be trusted, so
+            // durableSeq stays put and sync()/append() report the error
+            error = failure;
+            flushed.notify_all();
+            break;
+        }
+
+        durableSeq = batchSeq;
+        syncs++;
+        flushed.notify_all();
+    }
+}
+
+void TaskJournal::sync() {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (error) std::rethrow_exception(error);
+    if (!flusher.joinable()) return;  // window 0 is always durable
+    uint64_t target = appendedSeq;
+    if (durableSeq >= target) return;
+    flushNow = true;
+    flushRequested.notify_one();
+    flushed.wait(lock, [this, target] { return durableSeq >= target || error; });
+    if (error) std::rethrow_exception(error);
+}
+
+void TaskJournal::reset() {
+    sync();
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // Build the empty log beside the old one and swap it in atomically
+    std::string tmpPath = path + ".tmp";
+    int newFd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (newFd < 0) throw std::runtime_error("Cannot create journal " + tmpPath);
+    writeHeader(newFd);
+    dataSync(newFd);
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        ::close(newFd);
+        throw std::runtime_error("Cannot replace journal " + path);
+    }
+    ::close(fd);
+    fd = newFd;
+    syncDirectoryOf(path);
+}
+
+uint64_t TaskJournal::syncCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return syncs;
+}
+
+void TaskJournal::replay(const std::string& path,
+                         const std::function<void(JournalOp, const std::string&, int)>& f) {
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0 || st.st_size == 0) return;
+    MappedFile file(path);
+    scan(file.data(), file.size(), f);
+}
+
+void TaskJournal::syncDirectoryOf(const std::string& path) {
+    size_t slash = path.find_last_of('/');
+    std::string dir = slash == std::string::npos ? "." : path.substr(0, slash);
+    int dirFd = ::open(dir.c_str(), O_RDONLY);
+    if (dirFd < 0) throw std::runtime_error("Cannot open directory " + dir);
+    int result = ::fsync(dirFd);
+    ::close(dirFd);
+    if (result != 0) throw std::runtime_error("Directory sync failed: " + dir);
+}
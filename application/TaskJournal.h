@@ -0,0 +1,75 @@
+#ifndef TASKJOURNAL_H
+#define TASKJOURNAL_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Journal record types. Every record sets the final state of one patient,
+// so replaying a log over a snapshot that already contains part of it
+// yields the same queue.
+enum class JournalOp : uint8_t {
+    ADD = 1,     // patient present with the given urgency
+    UPDATE = 2,  // patient's urgency changed
+    REMOVE = 3   // patient treated or removed
+};
+
+/**
+ * Append-only write-ahead log with group commit.
+ *
+ * append() only encodes the record into an in-memory buffer. A flusher
+ * thread writes the buffer and issues one fdatasync per commit window,
+ * so many operations share the cost of a single sync. A window of zero
+ * syncs every record before append() returns.
+ */
+class TaskJournal {
+private:
+    std::string path;
+    int fd;
+    std::chrono::microseconds window;
+
+    std::mutex mutex;
+    std::condition_variable flushRequested;
+    std::condition_variable flushed;
+    std::vector<char> pending;   // records not yet written
+    uint64_t appendedSeq;        // records appended so far
+    uint64_t durableSeq;         // records known to be on disk
+    uint64_t syncs;
+    bool flushNow;               // sync() is waiting, skip the rest of the window
+    bool stopping;
+    std::exception_ptr error;    // first failed write or sync; the log takes no more records
+    std::thread flusher;
+
+    void flusherLoop();
+    void writeAndSync(const std::vector<char>& bytes);
+    static void encode(std::vector<char>& out, JournalOp op, const std::string& name, int urgency);
+
+public:
+    TaskJournal(const std::string& path, std::chrono::microseconds commitWindow);
+    ~TaskJournal();
+
+    TaskJournal(const TaskJournal&) = delete;
+    TaskJournal& operator=(const TaskJournal&) = delete;
+
+    // After a write or sync fails, append() and sync() rethrow that error
+    void append(JournalOp op, const std::string& name, int urgency);
+    void sync();   // blocks until every appended record is durable
+    void reset();  // starts an empty log after a checkpoint (no concurrent appends)
+    uint64_t syncCount();
+
+    // Calls f for each intact record; stops at a torn or corrupt tail
+    static void replay(const std::string& path,
+                       const std::function<void(JournalOp, const std::string&, int)>& f);
+
+    // Makes a rename inside the file's directory durable; throws if it
+    // cannot be
+    static void syncDirectoryOf(const std::string& path);
+};
+
+#endif // TASKJOURNAL_H
@@ -0,0 +1,83 @@
+#include "TaskListModel.h"
+#include <QString>
+#include <algorithm>
+
+namespace {
+
+int levelOf(const Task& task) {
+    return static_cast<int>(task.urgency);
+}
+
+} // namespace
+
+TaskListModel::TaskListModel(TaskManager& m, QObject* parent)
+    : QAbstractListModel(parent), manager(m) {
+    loadRows();
+    manager.setListener(this);
+}
+
+TaskListModel::~TaskListModel() {
+    manager.setListener(nullptr);
+}
+
+int TaskListModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : static_cast<int>(rows.size());
+}
+
+QVariant TaskListModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() < 0 || index.row() >= static_cast<int>(rows.size())) {
+        return QVariant();
+    }
+    const Task& task = *rows[static_cast<size_t>(index.row())].task;
+    switch (role) {
+    case Qt::DisplayRole:
+    case NameRole: return QString::fromStdString(task.name);
+    case UrgencyRole: return static_cast<int>(task.urgency);
+    default: return QVariant();
+    }
+}
+
+QHash<int, QByteArray> TaskListModel::roleNames() const {
+    return {
+        {NameRole, "name"},
+        {UrgencyRole, "urgency"}
+    };
+}
+
+int TaskListModel::insertionRow(int level, uint64_t order) const {
+    auto it = std::lower_bound(rows.begin(), rows.end(), 0,
+        [level, order](const Row& row, int) {
+            return row.level != level ? row.level < level : row.order < order;
+        });
+    return static_cast<int>(it - rows.begin());
+}
+
+void TaskListModel::taskAdded(const Task& task) {
+    int row = insertionRow(levelOf(task), task.order);
+    beginInsertRows(QModelIndex(), row, row);
+    rows.insert(rows.begin() + row, Row{levelOf(task), task.order, &task});
+    endInsertRows();
+}
+
+void TaskListModel::taskRemoving(const Task& task) {
+    int row = insertionRow(levelOf(task), task.order);
+    if (row >= static_cast<int>(rows.size()) || rows[static_cast<size_t>(row)].task != &task) return;
+    beginRemoveRows(QModelIndex(), row, row);
+    rows.erase(rows.begin() + row);
+    endRemoveRows();
+}
+
+void TaskListModel::tasksReset() {
+    beginResetModel();
+    loadRows();
+    endResetModel();
+}
+
+void TaskListModel::loadRows() {
+    TaskView view = manager.tasksByUrgency();
+    rows.clear();
+    rows.reserve(view.size());
+    for (const Task& task : view) {
+        rows.push_back(Row{levelOf(task), task.order, &task});
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef TASKLISTMODEL_H
+#define TASKLISTMODEL_H
+
+#include <QAbstractListModel>
+#include "TaskManager.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * List model over a TaskManager's queue, most urgent first.
+ *
+ * The model registers itself as the manager's TaskListener and turns each
+ * reported change into a single row insert or remove, so a view repaints
+ * only the rows that changed and only if they are visible. Rows point at
+ * the manager's tasks; nothing is copied per task.
+ */
+class TaskListModel : public QAbstractListModel, public TaskListener {
+    Q_OBJECT
+
+public:
+    enum Roles {
+        NameRole = Qt::UserRole + 1,
+        UrgencyRole  // int value of Urgency
+    };
+
+    explicit TaskListModel(TaskManager& manager, QObject* parent = nullptr);
+    ~TaskListModel() override;
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    // TaskListener
+    void taskAdded(const Task& task) override;
+    void taskRemoving(const Task& task) override;
+    void tasksReset() override;
+
+private:
+    // (level, order) is the task's position in TaskView, kept with the row
+    // so the search never has to read a task that is being changed
+    struct Row {
+        int level;
+        uint64_t order;
+        const Task* task;
+    };
+
+    TaskManager& manager;
+    std::vector<Row> rows;
+
+    int insertionRow(int level, uint64_t order) const;
+    void loadRows();
+};
+
+#endif // TASKLISTMODEL_H
@@ -1,58 +1,69 @@
 #include "TaskManager.h"
 #include <algorithm>
+#include <sys/stat.h>
 
 void TaskManager::addPatient(const std::string& name, Urgency urgency) {
+    if (tasks.count(name)) {
+        updatePatientStatus(name, urgency);
+        return;
+    }
     auto* node = heap.insert(name, static_cast<int>(urgency));
-    tasks.push_back(Task(name, urgency, node));
+    if (trace) trace->recordInsert(node, static_cast<int>(urgency));
+    auto it = tasks.emplace(name, Task(name, urgency, node)).first;
+    link(it->second);
+    if (listener) listener->taskAdded(it->second);
+    logChange(JournalOp::ADD, name, urgency);
 }
 
 bool TaskManager::updatePatientStatus(const std::string& name, Urgency newLevel) {
-    // Find task in our list
-    for (auto& task : tasks) {
-        if (task.name == name && task.heapNode) {
-            int newPriority = static_cast<int>(newLevel);
-            int currentPriority = static_cast<int>(task.urgency);
-            
-            // Only use decreaseKey if new priority is better (lower number = higher priority)
-            if (newPriority < currentPriority) {
-                heap.decreaseKey(task.heapNode, newPriority);
-                task.urgency = newLevel;
-                return true;
-            } else if (newPriority > currentPriority) {
-                // For worsening priority (higher priority value = lower urgency)
-                // we need to delete and re-insert since decreaseKey only works for improvements
-                heap.deleteNode(task.heapNode);
-                task.heapNode = heap.insert(name, newPriority);
-                task.urgency = newLevel;
-                return true;
-            }
-            // If same priority, no change needed
-            return true;
-        }
+    auto it = tasks.find(name);
+    if (it == tasks.end() || !it->second.heapNode) return false;
+    Task& task = it->second;
+
+    int newPriority = static_cast<int>(newLevel);
+    int currentPriority = static_cast<int>(task.urgency);
+
+    // Only use decreaseKey if new priority is better (lower number = higher priority)
+    if (newPriority < currentPriority) {
+        heap.decreaseKey(task.heapNode, newPriority);
+        if (trace) trace->recordDecreaseKey(task.heapNode, newPriority);
+    } else if (newPriority > currentPriority) {
+        // For worsening priority (higher priority value = lower urgency)
+        // we need to delete and re-insert since decreaseKey only works for improvements
+        auto* oldNode = task.heapNode;
+        heap.deleteNode(oldNode);
+        task.heapNode = heap.insert(name, newPriority);
+        if (trace) trace->recordUpdateKey(oldNode, task.heapNode, newPriority);
+    } else {
+        // If same priority, no change needed
+        return true;
     }
-    return false;
+    if (listener) listener->taskRemoving(task);
+    unlink(task);
+    task.urgency = newLevel;
+    link(task);
+    if (listener) listener->taskAdded(task);
+    logChange(JournalOp::UPDATE, name, newLevel);
+    return true;
 }
 
 std::string TaskManager::getNextUrgent() {
     if (heap.isEmpty()) return "";
+    if (trace) trace->recordGetMin();
     return heap.getMin()->value;
 }
 
 std::string TaskManager::treatNext() {
     if (heap.isEmpty()) return "";
     auto* min = heap.extractMin();
+    if (trace) trace->recordExtractMin(min);
     std::string value = min->value;
-    
-    // Remove from tasks list - O(n) operation
-    // Note: Using vector for simplicity. For larger datasets, consider using 
-    // std::unordered_map<std::string, Task*> for O(1) lookup and removal
-    tasks.erase(
-        std::remove_if(tasks.begin(), tasks.end(),
-            [&value](const Task& t) { return t.name == value; }),
-        tasks.end()
-    );
-    
-    delete min;
+
+    auto it = tasks.find(value);
+    if (it != tasks.end()) eraseTask(it);
+
+    heap.release(min);
+    logChange(JournalOp::REMOVE, value, Urgency::MINOR);
     return value;
 }
 
@@ -60,19 +71,113 @@ int TaskManager::getPendingCount() {
     return heap.getSize();
 }
 
-std::vector<Task> TaskManager::getAllTasks() const {
-    return tasks;
+const Task* TaskManager::findTask(const std::string& name) const {
+    auto it = tasks.find(name);
+    return it == tasks.end() ? nullptr : &it->second;
 }
 
 void TaskManager::removeTask(const std::string& name) {
-    // Find and remove from tasks list
-    auto it = std::find_if(tasks.begin(), tasks.end(),
-        [&name](const Task& t) { return t.name == name; });
-    
-    if (it != tasks.end()) {
-        if (it->heapNode) {
-            heap.deleteNode(it->heapNode);
-        }
-        tasks.erase(it);
+    auto it = tasks.find(name);
+    if (it == tasks.end()) return;
+
+    if (it->second.heapNode) {
+        if (trace) trace->recordDelete(it->second.heapNode);
+        heap.deleteNode(it->second.heapNode);
+    }
+    eraseTask(it);
+    logChange(JournalOp::REMOVE, name, Urgency::MINOR);
+}
+
+// Appends task to the list of its urgency level
+void TaskManager::link(Task& task) {
+    int level = static_cast<int>(task.urgency) - 1;
+    task.prev = levelTail[level];
+    task.next = nullptr;
+    task.order = nextOrder++;
+    if (task.prev) task.prev->next = &task;
+    else levelHead[level] = &task;
+    levelTail[level] = &task;
+}
+
+void TaskManager::unlink(Task& task) {
+    int level = static_cast<int>(task.urgency) - 1;
+    if (task.prev) task.prev->next = task.next;
+    else levelHead[level] = task.next;
+    if (task.next) task.next->prev = task.prev;
+    else levelTail[level] = task.prev;
+    task.prev = task.next = nullptr;
+}
+
+void TaskManager::eraseTask(std::unordered_map<std::string, Task>::iterator it) {
+    if (listener) listener->taskRemoving(it->second);
+    unlink(it->second);
+    tasks.erase(it);
+}
+
+void TaskManager::logChange(JournalOp op, const std::string& name, Urgency urgency) {
+    if (!journal) return;
+    journal->append(op, name, static_cast<int>(urgency));
+    if (checkpointInterval > 0 && ++opsSinceCheckpoint >= checkpointInterval) {
+        checkpoint();
+    }
+}
+
+// Recreates the task list from the heap's nodes after a snapshot load
+void TaskManager::rebuildTasksFromHeap() {
+    tasks.clear();
+    std::fill(std::begin(levelHead), std::end(levelHead), nullptr);
+    std::fill(std::begin(levelTail), std::end(levelTail), nullptr);
+    tasks.reserve(static_cast<size_t>(heap.getSize()));
+    for (auto* node : heap.nodes()) {
+        auto it = tasks.emplace(node->value, Task(node->value, static_cast<Urgency>(node->key), node)).first;
+        link(it->second);
     }
+    if (listener) listener->tasksReset();
+}
+
+void TaskManager::enableJournal(const std::string& directory,
+                                std::chrono::microseconds commitWindow,
+                                size_t checkpointEvery) {
+    journal.reset();
+    ::mkdir(directory.c_str(), 0755);
+    dataDir = directory;
+    checkpointInterval = checkpointEvery;
+
+    // Snapshot first, then every logged change on top of it. Records set
+    // a patient's final state, so replaying changes the snapshot already
+    // contains is harmless.
+    std::string snapshotPath = dataDir + "/tasks.snap";
+    struct stat st;
+    if (::stat(snapshotPath.c_str(), &st) == 0) {
+        heap.loadSnapshot(snapshotPath);
+        rebuildTasksFromHeap();
+    }
+    TaskJournal::replay(dataDir + "/tasks.wal", [this](JournalOp op, const std::string& name, int level) {
+        Urgency urgency = static_cast<Urgency>(level);
+        if (op == JournalOp::REMOVE) {
+            removeTask(name);
+        } else if (!updatePatientStatus(name, urgency)) {
+            addPatient(name, urgency);
+        }
+    });
+
+    journal = std::make_unique<TaskJournal>(dataDir + "/tasks.wal", commitWindow);
+    checkpoint();
+}
+
+void TaskManager::checkpoint() {
+    if (!journal) return;
+    std::string snapshotPath = dataDir + "/tasks.snap";
+    journal->sync();
+    // saveSnapshot() syncs the new file before renaming it into place; the
+    // rename must be durable too before the log that still covers it is
+    // emptied. Any failure throws here and leaves the log as it was.
+    heap.saveSnapshot(snapshotPath);
+    TaskJournal::syncDirectoryOf(snapshotPath);
+    journal->reset();
+    opsSinceCheckpoint = 0;
+}
+
+void TaskManager::syncJournal() {
+    if (journal) journal->sync();
 }
\ No newline at end of file
@@ -2,8 +2,15 @@
 #define TASKMANAGER_HPP
 
 #include "FibonacciHeap.hpp"
+#include "HeapTrace.hpp"
+#include "TaskJournal.h"
+#include <chrono>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
 #include <string>
-#include <vector>
+#include <unordered_map>
 
 // Urgency levels for emergency care management
 enum class Urgency {
@@ -13,29 +20,146 @@ enum class Urgency {
     MINOR = 4        // Non-urgent
 };
 
+constexpr int URGENCY_LEVELS = 4;
+
 // Structure to hold task information
 struct Task {
     std::string name;
     Urgency urgency;
     FibonacciHeap<std::string>::Node* heapNode;
-    
+
+    // Links within the list of tasks with the same urgency (see TaskView)
+    Task* prev = nullptr;
+    Task* next = nullptr;
+    uint64_t order = 0;  // position in that list, increasing towards the tail
+
     Task(const std::string& n, Urgency u, FibonacciHeap<std::string>::Node* node)
         : name(n), urgency(u), heapNode(node) {}
 };
 
+/**
+ * Read-only view of the waiting tasks, most urgent level first and in
+ * arrival order within a level. It walks the task store in place: nothing
+ * is copied or sorted, and it is invalidated by the next change to the
+ * TaskManager.
+ */
+class TaskView {
+public:
+    class iterator {
+    private:
+        Task* const* heads;
+        int level;
+        const Task* curr;
+
+        void skipEmptyLevels() {
+            while (!curr && ++level < URGENCY_LEVELS) curr = heads[level];
+        }
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Task;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Task*;
+        using reference = const Task&;
+
+        iterator(Task* const* h, int l) : heads(h), level(l), curr(nullptr) {
+            if (level < URGENCY_LEVELS) {
+                curr = heads[level];
+                skipEmptyLevels();
+            }
+        }
+        const Task& operator*() const { return *curr; }
+        const Task* operator->() const { return curr; }
+        iterator& operator++() {
+            curr = curr->next;
+            skipEmptyLevels();
+            return *this;
+        }
+        iterator operator++(int) { iterator tmp = *this; ++*this; return tmp; }
+        bool operator==(const iterator& other) const { return curr == other.curr; }
+        bool operator!=(const iterator& other) const { return curr != other.curr; }
+    };
+
+    TaskView(Task* const* h, size_t n) : heads(h), count(n) {}
+    iterator begin() const { return iterator(heads, 0); }
+    iterator end() const { return iterator(heads, URGENCY_LEVELS); }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+private:
+    Task* const* heads;
+    size_t count;
+};
+
+/**
+ * Receives every change to the task store, in the order of TaskView, so a
+ * view model can follow the queue incrementally. A changed urgency moves a
+ * task to the tail of its new level and is reported as a removal followed
+ * by an addition.
+ */
+class TaskListener {
+public:
+    virtual ~TaskListener() = default;
+    virtual void taskAdded(const Task& task) = 0;     // already in the view
+    virtual void taskRemoving(const Task& task) = 0;  // still in the view
+    virtual void tasksReset() = 0;                    // the whole store was replaced
+};
+
 class TaskManager
 {
 private:
     FibonacciHeap<std::string> heap;
-    std::vector<Task> tasks;  // Keep track of all tasks
+    // Every waiting task by name; each also sits in the list for its
+    // urgency, so lookups and the ordered view are both O(1) per task
+    std::unordered_map<std::string, Task> tasks;
+    Task* levelHead[URGENCY_LEVELS] = {};
+    Task* levelTail[URGENCY_LEVELS] = {};
+    uint64_t nextOrder = 0;
+    TaskListener* listener = nullptr;
+    HeapTraceWriter* trace = nullptr;  // Optional workload recorder
+
+    // Durability (see enableJournal)
+    std::unique_ptr<TaskJournal> journal;
+    std::string dataDir;
+    size_t checkpointInterval = 0;
+    size_t opsSinceCheckpoint = 0;
+
+    void logChange(JournalOp op, const std::string& name, Urgency urgency);
+    void rebuildTasksFromHeap();
+    void link(Task& task);
+    void unlink(Task& task);
+    void eraseTask(std::unordered_map<std::string, Task>::iterator it);
 
 public:
+    TaskManager() = default;
+    // Tasks link to each other, so the store cannot be copied
+    TaskManager(const TaskManager&) = delete;
+    TaskManager& operator=(const TaskManager&) = delete;
+
+    // Adding a name that is already waiting updates its urgency instead
     void addPatient(const std::string &name, Urgency priority);
     bool updatePatientStatus(const std::string &name, Urgency newLevel);
     std::string getNextUrgent();
     std::string treatNext();
     int getPendingCount();
-    std::vector<Task> getAllTasks() const;
+    const Task* findTask(const std::string& name) const;
+    TaskView tasksByUrgency() const { return TaskView(levelHead, tasks.size()); }
     void removeTask(const std::string& name);
+
+    // Report store changes to listener (nullptr stops reporting)
+    void setListener(TaskListener* l) { listener = l; }
+
+    // Stream every heap operation into a trace (nullptr stops recording)
+    void setTraceWriter(HeapTraceWriter* writer) { trace = writer; }
+
+    // Restores the queue saved in directory (snapshot + write-ahead log),
+    // then logs every change with group commit. A checkpoint is taken after
+    // recovery and every checkpointEvery logged changes (0 = only on request).
+    void enableJournal(const std::string& directory,
+                       std::chrono::microseconds commitWindow,
+                       size_t checkpointEvery = 10000);
+    void checkpoint();   // snapshot the queue and start an empty log
+    void syncJournal();  // wait until every change so far is durable
+    uint64_t journalSyncCount() { return journal ? journal->syncCount() : 0; }
 };
 #endif // TASKMANAGER_HPP
\ No newline at end of file
@@ -0,0 +1,122 @@
+// canvas_bench - HeapCanvas layout and paint time against heap size
+//
+// Usage: canvas_bench [nodes...]
+//
+// Runs on Qt's offscreen platform, so it needs no display. For each heap
+// size (1000, 10000 and 100000 by default) it inserts random keys,
+// extracts the minimum once so the roots are linked into trees, and
+// decreases the keys of a few random nodes so some trees are cut and
+// marked. Then it times, in milliseconds:
+//   layout      laying the fresh heap out (every subtree shape built)
+//   relayout    laying it out again after one more extractMin
+//   paint       one 1600x900 frame at 1x zoom into a QImage, tiles cold
+//   paint fit   the same frame zoomed out to the whole heap, tiles cold
+//   paint warm  the fitted frame again, from the cached tiles
+// Every time but the first layout is the median of RUNS runs. Without Qt,
+// layout_bench times the layout columns.
+
+#include "MainWindow.h"
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QImage>
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr int RUNS = 5;
+constexpr int WIDTH = 1600;
+constexpr int HEIGHT = 900;
+
+template <typename Work>
+double timeMs(Work work) {
+    QElapsedTimer timer;
+    timer.start();
+    work();
+    return static_cast<double>(timer.nsecsElapsed()) / 1e6;
+}
+
+double median(std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+void fill(VisualHeap& heap, int nodes, std::mt19937& rng) {
+    std::uniform_int_distribution<int> keys(0, 1000000);
+    for (int i = 0; i < nodes; ++i) {
+        int key = keys(rng);
+        heap.insert(key, key);
+    }
+    heap.release(heap.extractMin());
+
+    std::vector<VisualHeap::Node*> children;
+    for (VisualHeap::Node* node : heap.nodes()) {
+        if (node->parent) children.push_back(node);
+    }
+    std::shuffle(children.begin(), children.end(), rng);
+    children.resize(children.size() / 100);
+    // below the parent's key, so every one is cut and its parent marked
+    for (VisualHeap::Node* node : children) {
+        if (node->parent) heap.decreaseKey(node, node->parent->key - 1);
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+
+    std::vector<int> sizes;
+    for (int i = 1; i < argc; ++i) sizes.push_back(std::atoi(argv[i]));
+    if (sizes.empty()) sizes = {1000, 10000, 100000};
+
+    std::cout << std::right << std::setw(10) << "nodes" << std::setw(12) << "layout"
+              << std::setw(12) << "relayout" << std::setw(12) << "paint"
+              << std::setw(12) << "paint fit" << std::setw(12) << "paint warm" << "\n";
+
+    std::mt19937 rng(42);
+    for (int nodes : sizes) {
+        VisualHeap heap;
+        heap.getObserver().setRecording(false);
+        fill(heap, nodes, rng);
+
+        uint64_t version = 0;
+        HeapScenePtr scene;
+        double layout = timeMs([&] { scene = HeapWorker::layOut(heap, ++version); });
+
+        std::vector<double> relayout;
+        for (int run = 0; run < RUNS && !heap.isEmpty(); ++run) {
+            heap.release(heap.extractMin());
+            relayout.push_back(timeMs([&] { scene = HeapWorker::layOut(heap, ++version); }));
+        }
+
+        AnimationSystem animationSystem;
+        HeapCanvas canvas(&animationSystem);
+        canvas.resize(WIDTH, HEIGHT);
+        QImage image(WIDTH, HEIGHT, QImage::Format_ARGB32_Premultiplied);
+
+        std::vector<double> paint, paintFit, paintWarm;
+        canvas.setScene(scene);
+        for (int run = 0; run < RUNS; ++run) {
+            canvas.invalidateTiles();
+            paint.push_back(timeMs([&] { canvas.render(&image); }));
+        }
+        canvas.zoomToFit();
+        for (int run = 0; run < RUNS; ++run) {
+            canvas.invalidateTiles();
+            paintFit.push_back(timeMs([&] { canvas.render(&image); }));
+            paintWarm.push_back(timeMs([&] { canvas.render(&image); }));
+        }
+
+        std::cout << std::setw(10) << scene->size() << std::fixed << std::setprecision(2)
+                  << std::setw(12) << layout << std::setw(12) << median(relayout)
+                  << std::setw(12) << median(paint) << std::setw(12) << median(paintFit)
+                  << std::setw(12) << median(paintWarm) << "\n";
+    }
+    return 0;
+}
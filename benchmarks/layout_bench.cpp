@@ -0,0 +1,128 @@
+// layout_bench - heap canvas layout time against heap size, without Qt
+//
+// Usage: layout_bench [nodes...]
+//
+// The layout half of canvas_bench, for machines without Qt: the heaps are
+// built the same way (random keys, one extractMin to link the roots into
+// trees, then a few decreased keys so some trees are cut and marked) and
+// laid out by the TidyTreeLayout the worker uses, into a flat list of
+// placed nodes. Times, in milliseconds:
+//   layout      laying the fresh heap out (every subtree shape built)
+//   relayout    laying it out again after one more extractMin
+//   burst       laying it out again after BURST more inserts
+//   shapes      subtree shapes rebuilt by one relayout
+// Every time but the first layout is the median of RUNS runs.
+
+#include "FibonacciHeap.hpp"
+#include "TidyTreeLayout.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr int RUNS = 5;
+constexpr int BURST = 20000;  // the worker's insert chunk
+
+using LaidOutHeap = FibonacciHeap<int, TidyTreeLayout>;
+
+struct Placed {
+    const void* id;
+    float x;
+    float y;
+    int parent;
+    float left;
+    float right;
+};
+
+template <typename Work>
+double timeMs(Work work) {
+    auto start = std::chrono::steady_clock::now();
+    work();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+double median(std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+void fill(LaidOutHeap& heap, int nodes, std::mt19937& rng) {
+    std::uniform_int_distribution<int> keys(0, 1000000);
+    for (int i = 0; i < nodes; ++i) {
+        int key = keys(rng);
+        heap.insert(key, key);
+    }
+    heap.release(heap.extractMin());
+
+    std::vector<LaidOutHeap::Node*> children;
+    for (LaidOutHeap::Node* node : heap.nodes()) {
+        if (node->parent) children.push_back(node);
+    }
+    std::shuffle(children.begin(), children.end(), rng);
+    children.resize(children.size() / 100);
+    // below the parent's key, so every one is cut and its parent marked
+    for (LaidOutHeap::Node* node : children) {
+        if (node->parent) heap.decreaseKey(node, node->parent->key - 1);
+    }
+}
+
+// What HeapWorker::layOut does, minus the scene's Qt types
+void layOut(LaidOutHeap& heap, std::vector<Placed>& placed) {
+    placed.clear();
+    placed.reserve(static_cast<size_t>(heap.getSize()));
+    heap.getObserver().place(heap.roots(), 150, 100,
+        [&](const LaidOutHeap::Node* node, float x, float y, int parent,
+            const TidyTreeLayout::Shape&, float left, float right) {
+            placed.push_back(Placed{node, x, y, parent, left, right});
+        });
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<int> sizes;
+    for (int i = 1; i < argc; ++i) sizes.push_back(std::atoi(argv[i]));
+    if (sizes.empty()) sizes = {1000, 10000, 100000, 1000000};
+
+    std::cout << std::right << std::setw(10) << "nodes" << std::setw(12) << "layout"
+              << std::setw(12) << "relayout" << std::setw(12) << "burst"
+              << std::setw(12) << "shapes" << "\n";
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> keys(0, 1000000);
+    for (int nodes : sizes) {
+        LaidOutHeap heap;
+        fill(heap, nodes, rng);
+
+        std::vector<Placed> placed;
+        double layout = timeMs([&] { layOut(heap, placed); });
+
+        std::vector<double> relayout;
+        size_t shapes = 0;
+        for (int run = 0; run < RUNS && !heap.isEmpty(); ++run) {
+            heap.release(heap.extractMin());
+            size_t rebuilt = heap.getObserver().shapesRebuilt();
+            relayout.push_back(timeMs([&] { layOut(heap, placed); }));
+            shapes = heap.getObserver().shapesRebuilt() - rebuilt;
+        }
+
+        std::vector<double> burst;
+        for (int run = 0; run < RUNS; ++run) {
+            for (int i = 0; i < BURST; ++i) {
+                int key = keys(rng);
+                heap.insert(key, key);
+            }
+            burst.push_back(timeMs([&] { layOut(heap, placed); }));
+        }
+
+        std::cout << std::setw(10) << nodes << std::fixed << std::setprecision(2)
+                  << std::setw(12) << layout << std::setw(12) << median(relayout)
+                  << std::setw(12) << median(burst) << std::setw(12) << shapes << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,89 @@
+// task_bench - cost of each TaskManager operation with a large queue
+//
+// Usage: task_bench [patients]
+//
+// Admits the given number of patients (100000 by default), changes every
+// patient's urgency once in random order, walks the queue in display
+// order, treats half of the patients and discharges the rest by name.
+// Prints the total time and the time per operation of each phase.
+
+#include "TaskManager.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+class Phase {
+private:
+    const char* name;
+    size_t ops;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    Phase(const char* n, size_t o) : name(n), ops(o), start(std::chrono::steady_clock::now()) {}
+    ~Phase() {
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << std::left << std::setw(12) << name << std::right
+                  << std::setw(10) << ops
+                  << std::setw(12) << std::fixed << std::setprecision(1) << seconds * 1e3
+                  << std::setw(12) << std::setprecision(0) << (ops ? seconds * 1e9 / ops : 0.0) << "\n";
+    }
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t patients = argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : 100000;
+
+    std::mt19937 rng(42);
+    std::vector<std::string> names;
+    names.reserve(patients);
+    for (size_t i = 0; i < patients; ++i) names.push_back("patient-" + std::to_string(i));
+
+    std::cout << std::left << std::setw(12) << "phase" << std::right
+              << std::setw(10) << "ops" << std::setw(12) << "total ms" << std::setw(12) << "ns/op" << "\n";
+
+    TaskManager manager;
+    {
+        Phase phase("add", patients);
+        for (const auto& name : names) manager.addPatient(name, static_cast<Urgency>(1 + rng() % 4));
+    }
+
+    std::vector<std::string> order(names);
+    std::shuffle(order.begin(), order.end(), rng);
+    {
+        Phase phase("update", patients);
+        for (const auto& name : order) manager.updatePatientStatus(name, static_cast<Urgency>(1 + rng() % 4));
+    }
+
+    size_t checksum = 0;
+    {
+        Phase phase("view", patients);
+        for (const Task& task : manager.tasksByUrgency()) checksum += task.name.size();
+    }
+
+    size_t treatCount = patients / 2;
+    {
+        Phase phase("treat", treatCount);
+        for (size_t i = 0; i < treatCount; ++i) manager.treatNext();
+    }
+
+    std::shuffle(order.begin(), order.end(), rng);
+    {
+        Phase phase("remove", patients);
+        for (const auto& name : order) manager.removeTask(name);
+    }
+
+    if (manager.getPendingCount() != 0) {
+        std::cerr << "queue not empty after the run\n";
+        return 1;
+    }
+    std::cout << "(checksum " << checksum << ")\n";
+    return 0;
+}
@@ -0,0 +1,92 @@
+// wal_bench - TaskManager throughput with the write-ahead log at several
+// group-commit windows
+//
+// Usage: wal_bench [ops] [directory]
+//
+// Runs the same add/update/treat mix without a journal, with a sync per
+// change, and with commit windows of 100 us, 1 ms and 10 ms, then prints
+// ops/sec and how many fdatasync calls were issued.
+
+#include "TaskManager.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unistd.h>
+
+namespace {
+
+struct Result {
+    double opsPerSecond;
+    double seconds;
+};
+
+Result runMix(TaskManager& manager, int ops) {
+    std::mt19937 rng(42);
+    int added = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ops; ++i) {
+        unsigned roll = rng() % 10;
+        if (roll < 6 || manager.getPendingCount() == 0) {
+            manager.addPatient("patient-" + std::to_string(added++),
+                               static_cast<Urgency>(1 + rng() % 4));
+        } else if (roll < 8) {
+            // Recent arrivals are the likeliest to still be waiting
+            int recent = std::max(0, added - 1 - static_cast<int>(rng() % 16));
+            manager.updatePatientStatus("patient-" + std::to_string(recent),
+                                        static_cast<Urgency>(1 + rng() % 4));
+        } else {
+            manager.treatNext();
+        }
+    }
+    manager.syncJournal();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return {ops / seconds, seconds};
+}
+
+void cleanDirectory(const std::string& dir) {
+    std::remove((dir + "/tasks.wal").c_str());
+    std::remove((dir + "/tasks.snap").c_str());
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int ops = argc > 1 ? std::atoi(argv[1]) : 20000;
+    std::string dir = argc > 2 ? argv[2] : "wal_bench_data";
+
+    std::cout << std::left << std::setw(16) << "commit window"
+              << std::right << std::setw(12) << "ops" << std::setw(14) << "ops/sec"
+              << std::setw(10) << "syncs" << "\n";
+
+    {
+        TaskManager manager;
+        Result r = runMix(manager, ops);
+        std::cout << std::left << std::setw(16) << "no journal" << std::right
+                  << std::setw(12) << ops << std::setw(14) << std::fixed << std::setprecision(0)
+                  << r.opsPerSecond << std::setw(10) << 0 << "\n";
+    }
+
+    const long windowsUs[] = {0, 100, 1000, 10000};
+    for (long windowUs : windowsUs) {
+        cleanDirectory(dir);
+        // A sync per change is slow enough that a smaller run is representative
+        int runOps = windowUs == 0 ? std::min(ops, 2000) : ops;
+        TaskManager manager;
+        manager.enableJournal(dir, std::chrono::microseconds(windowUs), 0);
+        uint64_t syncsBefore = manager.journalSyncCount();
+        Result r = runMix(manager, runOps);
+        uint64_t syncs = manager.journalSyncCount() - syncsBefore;
+        std::string label = windowUs == 0 ? "sync each op" : std::to_string(windowUs) + " us";
+        std::cout << std::left << std::setw(16) << label << std::right
+                  << std::setw(12) << runOps << std::setw(14) << std::fixed << std::setprecision(0)
+                  << r.opsPerSecond << std::setw(10) << syncs << "\n";
+    }
+    cleanDirectory(dir);
+    ::rmdir(dir.c_str());
+    return 0;
+}
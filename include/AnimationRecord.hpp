@@ -0,0 +1,125 @@
+#ifndef ANIMATION_RECORD_HPP
+#define ANIMATION_RECORD_HPP
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * One visible event of a heap operation, as played back by
+ * AnimationSystem. Nodes are identified by address only and are never
+ * dereferenced after the fact, so records can outlive the nodes they
+ * name and cross threads freely.
+ */
+struct AnimationRecord {
+    enum Type : uint8_t {
+        OPERATION,   // start of a user operation; operation and key say which
+        INSERT,
+        EXTRACT,
+        KEY_CHANGE,  // key is the new key, otherKey the old one
+        LINK,        // node became a child of other
+        CUT,         // node left other's children
+        MARK,
+        UNMARK,
+        MERGE,
+        CLEAR
+    };
+    enum Operation : uint8_t {
+        OP_NONE,
+        OP_INSERT,
+        OP_INSERT_RANDOM,  // key is the number of values
+        OP_EXTRACT_MIN,
+        OP_DECREASE_KEY,
+        OP_DELETE,
+        OP_MERGE,
+        OP_RESET
+    };
+
+    const void* node = nullptr;
+    const void* other = nullptr;
+    int key = 0;
+    int otherKey = 0;
+    Type type = OPERATION;
+    Operation operation = OP_NONE;
+};
+
+/**
+ * Observer mixin that records what the heap does as AnimationRecords and
+ * then passes every hook on to Base, e.g.
+ *   FibonacciHeap<int, AnimationRecorder<TidyTreeLayout>>
+ * Recording costs one push_back per event, so operations run at full
+ * speed; the owner collects the records with takeRecords(). Records can
+ * be switched off for bulk work that is not worth watching.
+ */
+template <typename Base>
+class AnimationRecorder : public Base {
+private:
+    std::vector<AnimationRecord> records;
+    bool enabled = true;
+
+    void add(AnimationRecord::Type type, const void* node, const void* other = nullptr,
+             int key = 0, int otherKey = 0) {
+        if (!enabled) return;
+        AnimationRecord record;
+        record.node = node;
+        record.other = other;
+        record.key = key;
+        record.otherKey = otherKey;
+        record.type = type;
+        records.push_back(record);
+    }
+
+public:
+    using Base::Base;
+
+    // Marks the start of a user operation
+    void beginOperation(AnimationRecord::Operation operation, int key = 0) {
+        AnimationRecord record;
+        record.key = key;
+        record.operation = operation;
+        records.push_back(record);
+    }
+
+    void setRecording(bool on) { enabled = on; }
+    std::vector<AnimationRecord> takeRecords() { return std::exchange(records, {}); }
+
+    // Observer hooks
+    template <typename Node> void inserted(const Node* node) {
+        add(AnimationRecord::INSERT, node, nullptr, node->key);
+        Base::inserted(node);
+    }
+    template <typename Node> void extracted(const Node* node) {
+        add(AnimationRecord::EXTRACT, node, nullptr, node->key);
+        Base::extracted(node);
+    }
+    template <typename Node> void keyChanged(const Node* node, int oldKey) {
+        add(AnimationRecord::KEY_CHANGE, node, nullptr, node->key, oldKey);
+        Base::keyChanged(node, oldKey);
+    }
+    template <typename Node> void linked(const Node* child, const Node* parent) {
+        add(AnimationRecord::LINK, child, parent, child->key, parent->key);
+        Base::linked(child, parent);
+    }
+    template <typename Node> void cut(const Node* child, const Node* parent) {
+        add(AnimationRecord::CUT, child, parent, child->key, parent->key);
+        Base::cut(child, parent);
+    }
+    template <typename Node> void marked(const Node* node) {
+        add(AnimationRecord::MARK, node, nullptr, node->key);
+        Base::marked(node);
+    }
+    template <typename Node> void unmarked(const Node* node) {
+        add(AnimationRecord::UNMARK, node, nullptr, node->key);
+        Base::unmarked(node);
+    }
+    template <typename Node> void merged(const Node* otherMin, AnimationRecorder& source) {
+        add(AnimationRecord::MERGE, otherMin, nullptr, otherMin->key);
+        Base::merged(otherMin, static_cast<Base&>(source));
+    }
+    void cleared() {
+        add(AnimationRecord::CLEAR, nullptr);
+        Base::cleared();
+    }
+};
+
+#endif // ANIMATION_RECORD_HPP
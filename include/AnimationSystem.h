@@ -3,76 +3,110 @@
 
 #include <QObject>
 #include <QTimer>
-#include <QPointF>
-#include <QColor>
+#include <QElapsedTimer>
+#include <QString>
 #include <vector>
-#include <functional>
+#include "AnimationRecord.hpp"
+#include "HeapScene.h"
 
 /**
- * Represents a single animation step
+ * The record being shown, how far into it playback is (0.0 to 1.0), and
+ * the heap it played out on: scene is the one published right after the
+ * record's operation, before the one published ahead of it (null if there
+ * was none). All are null once playback has caught up.
  */
-struct AnimationStep {
-    enum Type {
-        MOVE_NODE,
-        CHANGE_COLOR,
-        HIGHLIGHT_NODE,
-        REMOVE_NODE,
-        ADD_LINK,
-        REMOVE_LINK,
-        PAUSE
-    };
-    
-    Type type;
-    void* nodePtr;  // Pointer to the node being animated
-    QPointF startPos;
-    QPointF endPos;
-    QColor startColor;
-    QColor endColor;
-    int duration;  // milliseconds
-    std::function<void()> callback;  // Called when step completes
+struct AnimationFrame {
+    const AnimationRecord* record = nullptr;
+    float progress = 0.0f;
+    HeapScenePtr scene;
+    HeapScenePtr before;
 };
 
 /**
- * Animation system for visualizing heap operations
+ * Plays back the AnimationRecords of heap operations that have already
+ * run, on a timeline where every record lasts a fixed time for its type.
+ *
+ * The playback position is computed from a clock whenever it is asked
+ * for, so a frame shows exactly where playback is at the moment it is
+ * painted: at high speed or on a slow frame, records that fit between two
+ * frames are simply never shown instead of holding playback back. The
+ * timer only schedules repaints. Playback can be paused, sped up, seeked
+ * (e.g. by a scrub bar) and skipped to the next operation or to the end;
+ * it stops when it catches up and resumes when more records arrive.
+ *
+ * Records are appended with the scene they arrived in, and each frame
+ * names that scene, so seeking back shows the heap as it was. The oldest
+ * records are dropped together with their scenes once those hold more
+ * than MAX_SCENE_NODES nodes.
  */
 class AnimationSystem : public QObject {
     Q_OBJECT
-    
+
 private:
-    std::vector<AnimationStep> steps;
-    int currentStep;
+    std::vector<AnimationRecord> records;
+    std::vector<double> startTimes;  // timeline position of each record, in ms at 1x
+
+    // The records from first up to the next span's first arrived in scene
+    struct Span {
+        size_t first;
+        HeapScenePtr scene;
+        HeapScenePtr before;
+        size_t nodes;  // scene nodes kept alive by this span alone
+    };
+    std::vector<Span> spans;
+    HeapScenePtr latest;  // the last scene appended
+    size_t sceneNodes;    // sum of the spans' nodes
+    double endTime;                  // end of the last record
+    double anchorTime;               // timeline position when the clock was started
+    QElapsedTimer clock;
     QTimer* timer;
-    int elapsedTime;
-    bool isPlaying;
-    int animationSpeed;  // 1 = normal, 2 = fast, 3 = very fast
-    
+    double animationSpeed;
+    bool paused;
+    bool running;  // the clock is moving: not paused and not caught up
+
+    // Older records are dropped beyond this many
+    static constexpr size_t MAX_RECORDS = size_t(1) << 20;
+    static constexpr size_t MAX_SCENE_NODES = size_t(1) << 21;
+    static constexpr double MIN_SPEED = 0.25;
+    static constexpr double MAX_SPEED = 4096.0;
+
+    static double durationOf(const AnimationRecord& record);
+    void setPosition(double time);
+    void start();
+
 public:
     explicit AnimationSystem(QObject* parent = nullptr);
     ~AnimationSystem();
-    
-    // Animation control
-    void addStep(const AnimationStep& step);
-    void clearSteps();
-    void play();
+
+    // Timeline
+    void append(HeapScenePtr scene);  // queues scene->records
+    void clear();
+    double startTime() const { return startTimes.empty() ? endTime : startTimes.front(); }
+    double getEndTime() const { return endTime; }
+    double position() const;
+
+    // Playback control
     void pause();
     void resume();
-    void stop();
-    void setSpeed(int speed);  // 1-3
-    bool isAnimating() const { return isPlaying; }
-    
-    // Get current animation progress (0.0 to 1.0)
-    float getCurrentProgress() const;
-    const AnimationStep* getCurrentStep() const;
-    
+    void seek(double time);
+    void skipOperation();  // to the start of the next operation
+    void skipToEnd();
+    void setSpeed(double speed);  // timeline ms per wall-clock ms
+    double getSpeed() const { return animationSpeed; }
+    bool isPaused() const { return paused; }
+    bool isAnimating() const { return running; }
+
+    // What to draw right now
+    AnimationFrame currentFrame() const;
+    static QString describe(const AnimationRecord& record);
+
 signals:
     void animationStarted();
-    void animationStepChanged(int stepIndex);
     void animationCompleted();
     void animationUpdate();  // Emit during animation for smooth updates
-    
+
 private slots:
     void onTimerTick();
-    void nextStep();
 };
 
 #endif // ANIMATION_SYSTEM_H
@@ -3,10 +3,19 @@
 
 #include <iostream>
 #include "Vector.hpp"
+#include "NodePool.hpp"
+#include "HeapSnapshot.hpp"
+#include "HeapStructure.hpp"
+#include "HeapObserver.hpp"
 #include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <vector>
 using namespace std;
 
-template <typename T>
+// Observer receives structural events (see HeapObserver.hpp)
+template <typename T, typename Observer = NullHeapObserver>
 class FibonacciHeap {
 // nested Node class    
 public:
@@ -17,28 +26,138 @@ public:
         int key;    
         int degree;
         bool marked;
+        int pendingSlot;  // index in pendingRoots while the root waits there
         Node* parent;
         Node* child;
         Node* left;
         Node* right;
         Node(const T& val, int p)
-            : value(val), key(p), degree(0), marked(false),
+            : value(val), key(p), degree(0), marked(false), pendingSlot(-1),
               parent(nullptr), child(nullptr), left(this), right(this) {}
     };
 
+    // after consolidation there is at most one root per degree, so root
+    // lists of any realistic heap fit in the inline buffer
+    using RootList = Vector<Node*, 64>;
+
+    // Walks one circular sibling list in place, from first back around to
+    // it. Used by roots() and children(); the heap must not change while
+    // a range is being walked.
+    class RingIterator {
+        Node* first;
+        Node* curr;
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Node*;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Node* const*;
+        using reference = Node*;
+
+        RingIterator(Node* f = nullptr, Node* c = nullptr) : first(f), curr(c) {}
+        Node* operator*() const { return curr; }
+        RingIterator& operator++() {
+            curr = (curr->right == first) ? nullptr : curr->right;
+            return *this;
+        }
+        RingIterator operator++(int) { RingIterator old = *this; ++(*this); return old; }
+        bool operator==(const RingIterator& other) const { return curr == other.curr; }
+        bool operator!=(const RingIterator& other) const { return curr != other.curr; }
+    };
+
+    // Depth-first preorder over every node, starting at the minimum. Moves
+    // up through parent pointers, so it keeps no stack.
+    class NodeIterator {
+        Node* rootStart;
+        Node* curr;
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Node*;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Node* const*;
+        using reference = Node*;
+
+        NodeIterator(Node* start = nullptr, Node* c = nullptr) : rootStart(start), curr(c) {}
+        Node* operator*() const { return curr; }
+        NodeIterator& operator++() {
+            if (curr->child) {
+                curr = curr->child;
+                return *this;
+            }
+            while (curr) {
+                Node* ringStart = curr->parent ? curr->parent->child : rootStart;
+                if (curr->right != ringStart) {
+                    curr = curr->right;
+                    return *this;
+                }
+                curr = curr->parent;
+            }
+            return *this;
+        }
+        NodeIterator operator++(int) { NodeIterator old = *this; ++(*this); return old; }
+        bool operator==(const NodeIterator& other) const { return curr == other.curr; }
+        bool operator!=(const NodeIterator& other) const { return curr != other.curr; }
+    };
+
+    // The nodes of a heap emptied by detach(), with all of their storage.
+    // Destroying it frees everything; reclaim() frees a bounded share at a
+    // time instead, so the work can be spread out or moved to another
+    // thread (see HeapReclaimer.hpp), where the payload destructors run.
+    class DetachedNodes {
+        Node* next;  // next node to destroy, nullptr once all are
+        NodePool<Node> pool;
+    public:
+        DetachedNodes(Node* start, NodePool<Node>&& nodes);
+        DetachedNodes(DetachedNodes&& other) noexcept;
+        DetachedNodes& operator=(DetachedNodes&&) = delete;
+        ~DetachedNodes();
+        // destroys up to maxNodes nodes, then frees blocks of about as many
+        // slots; returns true while anything is left
+        bool reclaim(size_t maxNodes);
+    };
+
+    template <typename Iterator>
+    class Range {
+        Iterator first;
+    public:
+        explicit Range(Iterator f) : first(f) {}
+        Iterator begin() const { return first; }
+        Iterator end() const { return Iterator(); }
+        bool empty() const { return first == Iterator(); }
+    };
+
 private:
 
     Node* minNode;
     int size; 
+    NodePool<Node> pool;  // storage for every node of this heap
+    Observer observer;
+
+    // incremental consolidation (see setConsolidationBudget()); every root
+    // is exactly one of: degreeTable[root->degree], in pendingRoots, or carry
+    int consolidationBudget;          // steps per operation, 0 = eager
+    std::vector<Node*> degreeTable;   // consolidated roots, one per degree
+    std::vector<Node*> pendingRoots;  // roots not consolidated yet (see Node::pendingSlot)
+    Node* carry;                      // root being linked up the table
 
     void insertBefore(Node* node, Node* target);
     void deleteAll(Node* start);
     Node* findNode(Node* start, const T& value);
+    bool consolidationStep();
+    void advanceConsolidation(size_t addedRoots);
+    void addPending(Node* root);
+    void forgetRoot(Node* root);
+    void resetConsolidation();
 
 public:
 
     FibonacciHeap();
     ~FibonacciHeap();
+    // nodes point at each other, so a member-wise copy would share them;
+    // copies are made with clone()
+    FibonacciHeap(const FibonacciHeap&) = delete;
+    FibonacciHeap& operator=(const FibonacciHeap&) = delete;
+    FibonacciHeap(FibonacciHeap&& other) noexcept;
+    FibonacciHeap& operator=(FibonacciHeap&& other) noexcept;
 
     Node* insert(const T& value, int key);
     Node* getMin() const;
@@ -52,11 +171,56 @@ public:
     void linkNodes(Node*a, Node*b);
     void consolidate();
     Node* extractMin();
-    Vector<Node*> getRootList() const;
+
+    // By default extractMin() consolidates the whole root list at once, so
+    // after a burst of inserts one call links them all. With a budget of
+    // steps > 0 that work is spread out instead: insert, extractMin,
+    // decreaseKey and merge each do at most steps links (or table
+    // placements) per root they add to the root list. getMin() is exact
+    // either way: extractMin takes the new minimum from the degree table
+    // and the roots still pending, which costs O(log n) plus the number of
+    // pending roots. A budget of 2 or more files roots as fast as they
+    // appear, so few are pending except right after merging in a large
+    // heap. Then each extractMin is O(roots) and also files a quarter of
+    // the pending ones, so the backlog shrinks geometrically;
+    // consolidate() finishes the outstanding work at once.
+    void setConsolidationBudget(int steps);
+    int getConsolidationBudget() const { return consolidationBudget; }
+    RootList getRootList() const;
+    Range<RingIterator> roots() const { return Range<RingIterator>(RingIterator(minNode, minNode)); }
+    Range<RingIterator> children(const Node* node) const {
+        Node* first = node ? node->child : nullptr;
+        return Range<RingIterator>(RingIterator(first, first));
+    }
+    Range<NodeIterator> nodes() const { return Range<NodeIterator>(NodeIterator(minNode, minNode)); }
     void deleteNode(Node* x);             
     Node* search(const T& value);
-    void increaseKey(Node* x, int newKey);
-    void updateKey(Node* x, int newKey);
+    Node* increaseKey(Node* x, int newKey);
+    Node* updateKey(Node* x, int newKey);
+    void release(Node* node);             // frees a node returned by extractMin()
+    Observer& getObserver() { return observer; }
+    const Observer& getObserver() const { return observer; }
+    void clear();
+    // empties the heap in O(1), handing its nodes over to be freed later
+    DetachedNodes detach();
+    // independent deep copy with the same trees, marks and consolidation
+    // budget: O(n), every node and payload is copied (nothing is shared
+    // copy-on-write), but into one block in one pass. Its nodes() visits
+    // the copies of this heap's nodes() in the same order. The observer
+    // starts fresh and is sent inserted() for each node, as after
+    // loadSnapshot().
+    FibonacciHeap clone() const;
+
+    // binary snapshots: keys, degrees, marks and links stored as indices,
+    // payloads written by Serializer (see HeapSnapshot.hpp)
+    template <typename Serializer = SnapshotSerializer<T>>
+    void saveSnapshot(const std::string& path) const;
+    template <typename Serializer = SnapshotSerializer<T>>
+    void loadSnapshot(const std::string& path);
+
+    // flat copy of the tree shape (no values) for readers on other threads,
+    // usually published through a HeapStructurePublisher
+    void captureStructure(HeapStructure& out) const;
 };
 
 #include "FibonacciHeap.tpp"
@@ -2,43 +2,113 @@
 #define HEAP_INTERFACE_H
 
 #include <QString>
+#include <QStringList>
+#include <cstddef>
 #include <vector>
 #include <memory>
+#include <optional>
+#include <type_traits>
 
 /**
- * Abstract interface for Fibonacci Heap operations
- * This allows the GUI to work with heaps of different types
+ * Per-payload-type accessors for heap nodes. Each HeapWrapper<T> owns one
+ * static table; its address doubles as the type tag of a HeapNodeHandle.
  */
-class IHeapNode {
+struct HeapNodeOps {
+    QString (*displayValue)(const void* node);
+    int (*key)(const void* node);
+    int (*degree)(const void* node);
+    bool (*marked)(const void* node);
+    void* (*parent)(const void* node);
+    void* (*child)(const void* node);
+    void* (*left)(const void* node);
+    void* (*right)(const void* node);
+};
+
+/**
+ * Type-erased reference to a node of some IFibonacciHeap.
+ * Two pointers, trivially copyable and never allocating: pass it by value
+ * and throw it away freely. A handle does not keep its node alive; it is
+ * invalidated when the node is extracted or deleted, like a raw pointer.
+ */
+class HeapNodeHandle {
+private:
+    void* node;
+    const HeapNodeOps* ops;
+
 public:
-    virtual ~IHeapNode() = default;
-    virtual QString getDisplayValue() const = 0;
-    virtual int getKey() const = 0;
-    virtual int getDegree() const = 0;
-    virtual bool isMarked() const = 0;
-    virtual IHeapNode* getParent() const = 0;
-    virtual IHeapNode* getChild() const = 0;
-    virtual IHeapNode* getLeft() const = 0;
-    virtual IHeapNode* getRight() const = 0;
+    HeapNodeHandle() : node(nullptr), ops(nullptr) {}
+    HeapNodeHandle(void* n, const HeapNodeOps* o) : node(n), ops(n ? o : nullptr) {}
+
+    bool isNull() const { return node == nullptr; }
+    explicit operator bool() const { return node != nullptr; }
+
+    QString getDisplayValue() const { return node ? ops->displayValue(node) : QString(); }
+    int getKey() const { return node ? ops->key(node) : 0; }
+    int getDegree() const { return node ? ops->degree(node) : 0; }
+    bool isMarked() const { return node ? ops->marked(node) : false; }
+
+    HeapNodeHandle getParent() const { return node ? HeapNodeHandle(ops->parent(node), ops) : HeapNodeHandle(); }
+    HeapNodeHandle getChild() const { return node ? HeapNodeHandle(ops->child(node), ops) : HeapNodeHandle(); }
+    HeapNodeHandle getLeft() const { return node ? HeapNodeHandle(ops->left(node), ops) : HeapNodeHandle(); }
+    HeapNodeHandle getRight() const { return node ? HeapNodeHandle(ops->right(node), ops) : HeapNodeHandle(); }
+
+    // Raw node and type tag, for the heap that created the handle
+    void* get() const { return node; }
+    const HeapNodeOps* type() const { return ops; }
+
+    bool operator==(const HeapNodeHandle& other) const { return node == other.node; }
+    bool operator!=(const HeapNodeHandle& other) const { return node != other.node; }
 };
 
+static_assert(std::is_trivially_copyable<HeapNodeHandle>::value,
+              "HeapNodeHandle must stay trivially copyable");
+
+// One entry of a batched key update
+struct KeyUpdate {
+    HeapNodeHandle node;
+    int newKey;
+};
+
+// Value and key of a node that has left the heap
+struct HeapEntry {
+    QString displayValue;
+    int key;
+};
+
+/**
+ * Abstract interface for Fibonacci Heap operations
+ * This allows the GUI to work with heaps of different types
+ */
 class IFibonacciHeap {
 public:
     virtual ~IFibonacciHeap() = default;
-    
+
     // Core operations
-    virtual IHeapNode* insert(const QString& value, int key) = 0;
-    virtual IHeapNode* getMin() const = 0;
+    virtual HeapNodeHandle insert(const QString& value, int key) = 0;
+    virtual HeapNodeHandle getMin() const = 0;
     virtual bool isEmpty() const = 0;
     virtual int getSize() const = 0;
-    virtual IHeapNode* extractMin() = 0;
-    virtual void decreaseKey(IHeapNode* node, int newKey) = 0;
-    virtual void deleteNode(IHeapNode* node) = 0;
+    virtual std::optional<HeapEntry> extractMin() = 0;
+    virtual void decreaseKey(HeapNodeHandle node, int newKey) = 0;
+    virtual void deleteNode(HeapNodeHandle node) = 0;
     virtual void merge(IFibonacciHeap* other) = 0;
-    
-    // For visualization
-    virtual std::vector<IHeapNode*> getRootList() const = 0;
-    virtual IHeapNode* search(const QString& value) = 0;
+
+    // Batched operations (one virtual call per batch instead of per node)
+    // Inserts values[i] with keys[i]; new handles are appended to inserted if given
+    virtual void insertBatch(const QStringList& values, const std::vector<int>& keys,
+                             std::vector<HeapNodeHandle>* inserted = nullptr) = 0;
+    // Sets each node's key; an increase moves the value to a new node, so
+    // the handles in updates are refreshed in place
+    virtual void updateKeys(KeyUpdate* updates, size_t count) = 0;
+    // Appends a handle to every node, depth-first from the minimum
+    virtual void collectNodes(std::vector<HeapNodeHandle>& out) const = 0;
+
+    // Type tag shared by every handle this heap hands out
+    virtual const HeapNodeOps* nodeType() const = 0;
+
+    // For visualization (the roots can also be walked with getMin()/getRight())
+    virtual std::vector<HeapNodeHandle> getRootList() const = 0;
+    virtual HeapNodeHandle search(const QString& value) = 0;
 };
 
 #endif // HEAP_INTERFACE_H
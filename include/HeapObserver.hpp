@@ -0,0 +1,44 @@
+#ifndef HEAP_OBSERVER_HPP
+#define HEAP_OBSERVER_HPP
+
+/**
+ * Default observer policy of FibonacciHeap: every hook is an empty inline
+ * function, so a heap without an observer compiles to the same code as
+ * before.
+ *
+ * An observer is any class with these member functions, usually derived
+ * from this one so it only defines the hooks it needs; the heap keeps one
+ * instance (reachable through getObserver()) and calls it directly,
+ * without virtual dispatch. Hooks are templates over the node type so an
+ * observer can be declared before the heap that uses it. Composite
+ * operations report their parts: deleteNode() is the cut() (and any
+ * cascading cuts) freeing the node, a cut() per child, and an extracted(),
+ * and an increased key adds an inserted() for the value's new node.
+ */
+struct NullHeapObserver {
+    // node was added: a new root from insert(), or a node restored by
+    // loadSnapshot() (reported in preorder once the whole heap is built)
+    template <typename Node> void inserted(const Node*) {}
+    // node left the heap through extractMin() or deleteNode(); it is still
+    // readable here
+    template <typename Node> void extracted(const Node*) {}
+    // node->key was lowered from oldKey
+    template <typename Node> void keyChanged(const Node*, int) {}
+    // child became the newest child of parent (consolidation)
+    template <typename Node> void linked(const Node* /*child*/, const Node* /*parent*/) {}
+    // child left parent's children and is now a root, through cut() or
+    // because parent is being extracted; parent->parent is still valid
+    template <typename Node> void cut(const Node* /*child*/, const Node* /*parent*/) {}
+    // node lost a child for the first time (cascadingCut())
+    template <typename Node> void marked(const Node*) {}
+    // node's mark was cleared by being cut or linked
+    template <typename Node> void unmarked(const Node*) {}
+    // the roots from otherMin onwards came from another heap, whose
+    // observer is source; source is sent cleared() right afterwards
+    template <typename Node, typename Source> void merged(const Node* /*otherMin*/, Source& /*source*/) {}
+    // every node was removed at once (clear(), loadSnapshot(), or this
+    // heap was merged into another)
+    void cleared() {}
+};
+
+#endif // HEAP_OBSERVER_HPP
@@ -0,0 +1,97 @@
+#ifndef HEAP_RECLAIMER_HPP
+#define HEAP_RECLAIMER_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+/**
+ * Background thread that destroys what it is handed, so freeing a large
+ * structure does not stall the thread that dropped it. Typically:
+ *
+ *     HeapReclaimer::instance().post(heap.detach());
+ *
+ * empties the heap in O(1), and the nodes' payloads and the pool's blocks
+ * are freed on the reclaimer thread (see FibonacciHeap::DetachedNodes).
+ * Jobs are destroyed one at a time, in the order they were posted; their
+ * destructors must not touch anything still in use elsewhere.
+ */
+class HeapReclaimer {
+private:
+    struct Job {
+        virtual ~Job() = default;
+    };
+
+    template <typename Garbage>
+    struct Holder : Job {
+        Garbage garbage;
+        explicit Holder(Garbage&& g) : garbage(std::move(g)) {}
+    };
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    std::deque<std::unique_ptr<Job>> jobs;
+    bool busy;      // a job is being destroyed
+    bool stopping;
+    std::thread worker;
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            wake.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (jobs.empty()) return;  // stopping, and everything is freed
+            std::unique_ptr<Job> job = std::move(jobs.front());
+            jobs.pop_front();
+            busy = true;
+            lock.unlock();
+            job.reset();
+            lock.lock();
+            busy = false;
+            if (jobs.empty()) idle.notify_all();
+        }
+    }
+
+public:
+    HeapReclaimer() : busy(false), stopping(false), worker(&HeapReclaimer::run, this) {}
+
+    // Finishes the jobs already posted
+    ~HeapReclaimer() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        worker.join();
+    }
+
+    HeapReclaimer(const HeapReclaimer&) = delete;
+    HeapReclaimer& operator=(const HeapReclaimer&) = delete;
+
+    // One reclaimer serves the whole process
+    static HeapReclaimer& instance() {
+        static HeapReclaimer reclaimer;
+        return reclaimer;
+    }
+
+    template <typename Garbage>
+    void post(Garbage garbage) {
+        std::unique_ptr<Job> job(new Holder<Garbage>(std::move(garbage)));
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobs.push_back(std::move(job));
+        }
+        wake.notify_one();
+    }
+
+    // Blocks until everything posted so far has been destroyed
+    void drain() {
+        std::unique_lock<std::mutex> lock(mutex);
+        idle.wait(lock, [this] { return jobs.empty() && !busy; });
+    }
+};
+
+#endif // HEAP_RECLAIMER_HPP
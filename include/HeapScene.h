@@ -0,0 +1,91 @@
+#ifndef HEAPSCENE_H
+#define HEAPSCENE_H
+
+#include <QMetaType>
+#include <QPointF>
+#include <QRectF>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "AnimationRecord.hpp"
+#include "SpatialHashGrid.hpp"
+
+/**
+ * One laid-out version of the visualized heap, built by HeapWorker on its
+ * thread and handed to HeapCanvas, which draws and hit-tests it without
+ * ever touching the heap.
+ *
+ * Nodes are in preorder: a subtree occupies the entries [index, end) and
+ * fits in bounds. A scene is immutable once published, so the GUI can keep
+ * using it while the worker goes on changing the heap. It also carries
+ * the animation records of the operations that led to it.
+ */
+struct HeapScene {
+    static constexpr float NODE_RADIUS = 30.0f;
+
+    struct Node {
+        const void* id;  // the heap node; only handed back to the worker
+        QPointF pos;
+        int parent;      // index of the parent's entry, -1 for roots
+        int end;         // one past the subtree's last entry
+        QRectF bounds;   // the subtree's nodes, in layout coordinates
+        int key;
+        int value;
+        int degree;
+        bool marked;
+    };
+
+    // A subtree whose bounds changed: where it is drawn as one glyph, the
+    // whole area differs
+    struct ShapeChange {
+        QRectF area;   // its bounds before and after
+        float extent;  // the smaller of the two bounds' larger sides
+    };
+
+    uint64_t version = 0;  // HeapWorker's change count when the scene was built
+    double layoutMs = 0;   // time the worker took to build the scene
+    int minIndex = -1;
+    std::vector<Node> nodes;
+    std::vector<uint32_t> byId;             // node indices sorted by id
+    SpatialHashGrid grid{NODE_RADIUS * 2};  // over nodes[i].pos
+    std::vector<AnimationRecord> records;   // since the previous scene
+
+    // How the scene differs from the one of version changesSince, so a
+    // rendering of that one can be partly reused (see HeapWorker::noteChanges).
+    // Both lists are bounded and may overstate; without hasChanges anything
+    // may differ.
+    bool hasChanges = false;
+    uint64_t changesSince = 0;
+    std::vector<QRectF> changedAreas;  // differ at any zoom
+    std::vector<ShapeChange> changedShapes;
+
+    bool empty() const { return nodes.empty(); }
+    int size() const { return static_cast<int>(nodes.size()); }
+    const Node* min() const { return minIndex >= 0 ? &nodes[minIndex] : nullptr; }
+
+    // Looked up for the selection and for every animation frame
+    int indexOf(const void* id) const {
+        if (!id) return -1;
+        std::less<const void*> before;
+        auto it = std::lower_bound(byId.begin(), byId.end(), id,
+            [&](uint32_t i, const void* key) { return before(nodes[i].id, key); });
+        return it != byId.end() && nodes[*it].id == id ? static_cast<int>(*it) : -1;
+    }
+
+    // Call once nodes are complete
+    void indexNodes() {
+        byId.resize(nodes.size());
+        for (uint32_t i = 0; i < byId.size(); ++i) byId[i] = i;
+        std::less<const void*> before;
+        std::sort(byId.begin(), byId.end(),
+            [&](uint32_t a, uint32_t b) { return before(nodes[a].id, nodes[b].id); });
+        grid.build(nodes.size(), [this](size_t i) { return nodes[i].pos; });
+    }
+};
+
+using HeapScenePtr = std::shared_ptr<const HeapScene>;
+Q_DECLARE_METATYPE(HeapScenePtr)
+
+#endif // HEAPSCENE_H
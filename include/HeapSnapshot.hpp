@@ -0,0 +1,155 @@
+#ifndef HEAP_SNAPSHOT_HPP
+#define HEAP_SNAPSHOT_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+ * On-disk layout used by FibonacciHeap::saveSnapshot/loadSnapshot.
+ *
+ *   SnapshotHeader
+ *   SnapshotNode[nodeCount]   (preorder, the minimum is node 0)
+ *   payload bytes             (one serialized value per node, same order)
+ *
+ * Links are stored as node indices, SNAPSHOT_NONE meaning null, so a
+ * loader can rebuild the exact tree shape in a single pass over the
+ * records. All fields use native (little-endian) byte order.
+ */
+struct SnapshotHeader {
+    char magic[4];           // "FHSN"
+    uint16_t version;
+    uint16_t nodeSize;       // sizeof(SnapshotNode), checked on load
+    uint64_t nodeCount;
+    uint64_t payloadBytes;
+};
+
+struct SnapshotNode {
+    int32_t key;
+    uint32_t degree;
+    uint32_t parent;
+    uint32_t child;
+    uint32_t left;
+    uint32_t right;
+    uint8_t marked;
+    uint8_t reserved[3];
+};
+
+static_assert(sizeof(SnapshotHeader) == 24, "SnapshotHeader must stay 24 bytes");
+static_assert(sizeof(SnapshotNode) == 28, "SnapshotNode must stay 28 bytes");
+
+constexpr uint16_t SNAPSHOT_VERSION = 1;
+constexpr uint32_t SNAPSHOT_NONE = 0xFFFFFFFFu;
+
+/**
+ * Checks that count records (as stored after the header) describe a
+ * well-formed forest before anything is built from them: links in range,
+ * sibling rings that close in both directions and share one parent,
+ * children that link back to their parent, degrees equal to the number
+ * of children, keys in heap order with node 0 the minimum, and every node
+ * reached exactly once from node 0's root ring. Each node is visited
+ * once, so a crafted file cannot make the check, or a heap built from the
+ * records, follow links forever. Throws std::runtime_error otherwise.
+ */
+inline void checkSnapshotNodes(const unsigned char* records, size_t count) {
+    auto at = [records](uint32_t index) {
+        SnapshotNode rec;
+        std::memcpy(&rec, records + static_cast<size_t>(index) * sizeof(SnapshotNode), sizeof(rec));
+        return rec;
+    };
+    auto fail = [](const char* what) {
+        throw std::runtime_error(std::string("Snapshot is corrupt: ") + what);
+    };
+    if (count == 0) return;
+    SnapshotNode min = at(0);
+    if (min.parent != SNAPSHOT_NONE) fail("the minimum is not a root");
+
+    std::vector<unsigned char> seen(count, 0);
+    std::vector<uint32_t> rings(1, 0);  // first node of each sibling ring left to walk
+    size_t reached = 0;
+    while (!rings.empty()) {
+        uint32_t first = rings.back();
+        rings.pop_back();
+        uint32_t parent = at(first).parent;
+        int32_t floor = parent == SNAPSHOT_NONE ? min.key : at(parent).key;
+        uint32_t siblings = 0;
+        uint32_t index = first;
+        do {
+            if (seen[index]) fail("a node is linked twice");
+            seen[index] = 1;
+            reached++;
+            siblings++;
+            SnapshotNode rec = at(index);
+            if (rec.parent != parent) fail("siblings have different parents");
+            if (rec.left >= count || rec.right >= count) fail("link out of range");
+            if (at(rec.right).left != index) fail("a sibling ring does not close");
+            if (rec.key < floor) fail("keys are out of heap order");
+            if (rec.child != SNAPSHOT_NONE) {
+                if (rec.child >= count || at(rec.child).parent != index) fail("a child does not link back");
+                rings.push_back(rec.child);
+            } else if (rec.degree != 0) {
+                fail("a degree does not match the children");
+            }
+            index = rec.right;
+        } while (index != first);
+        if (parent != SNAPSHOT_NONE && at(parent).degree != siblings) fail("a degree does not match the children");
+    }
+    if (reached != count) fail("nodes are not reachable from the roots");
+}
+
+/**
+ * Payload serializer used by default for snapshots.
+ * Trivially copyable values are stored as raw bytes and std::string as a
+ * 32-bit length followed by its characters. Other payload types need a
+ * serializer of their own with the same two static functions.
+ */
+template <typename T>
+struct SnapshotSerializer {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Provide a SnapshotSerializer for this payload type");
+
+    static void write(std::vector<unsigned char>& out, const T& value) {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+
+    static T read(const unsigned char*& cursor, const unsigned char* end) {
+        if (static_cast<size_t>(end - cursor) < sizeof(T)) {
+            throw std::runtime_error("Snapshot payload is truncated");
+        }
+        T value;
+        std::memcpy(&value, cursor, sizeof(T));
+        cursor += sizeof(T);
+        return value;
+    }
+};
+
+template <>
+struct SnapshotSerializer<std::string> {
+    static void write(std::vector<unsigned char>& out, const std::string& value) {
+        uint32_t length = static_cast<uint32_t>(value.size());
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&length);
+        out.insert(out.end(), bytes, bytes + sizeof(length));
+        out.insert(out.end(), value.begin(), value.end());
+    }
+
+    static std::string read(const unsigned char*& cursor, const unsigned char* end) {
+        uint32_t length;
+        if (static_cast<size_t>(end - cursor) < sizeof(length)) {
+            throw std::runtime_error("Snapshot payload is truncated");
+        }
+        std::memcpy(&length, cursor, sizeof(length));
+        cursor += sizeof(length);
+        if (static_cast<size_t>(end - cursor) < length) {
+            throw std::runtime_error("Snapshot payload is truncated");
+        }
+        std::string value(reinterpret_cast<const char*>(cursor), length);
+        cursor += length;
+        return value;
+    }
+};
+
+#endif // HEAP_SNAPSHOT_HPP
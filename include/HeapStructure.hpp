@@ -0,0 +1,119 @@
+#ifndef HEAP_STRUCTURE_HPP
+#define HEAP_STRUCTURE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+constexpr uint32_t STRUCTURE_NONE = 0xFFFFFFFFu;
+
+/**
+ * Flat, value-free copy of a heap's shape, filled by
+ * FibonacciHeap::captureStructure().
+ *
+ * Nodes are numbered in preorder starting from the minimum, so node 0 is
+ * the minimum whenever the heap is non-empty and every subtree occupies a
+ * contiguous index range. Links are indices, STRUCTURE_NONE meaning null;
+ * next runs along a sibling ring and ends at STRUCTURE_NONE instead of
+ * wrapping around.
+ */
+struct HeapStructure {
+    uint64_t version = 0;  // set by HeapStructurePublisher, 0 = never published
+    uint32_t rootCount = 0;
+    std::vector<int> key;
+    std::vector<int> degree;
+    std::vector<uint8_t> marked;
+    std::vector<uint32_t> parent;
+    std::vector<uint32_t> child;  // first child
+    std::vector<uint32_t> next;   // next sibling
+
+    size_t size() const { return key.size(); }
+    bool empty() const { return key.empty(); }
+
+    // keeps the capacity, so a reused buffer does not reallocate
+    void resize(size_t n) {
+        key.resize(n);
+        degree.resize(n);
+        marked.resize(n);
+        parent.resize(n);
+        child.resize(n);
+        next.resize(n);
+    }
+};
+
+/**
+ * Double-buffered publication of HeapStructure for readers on other
+ * threads.
+ *
+ * The owning thread calls publish(), which captures the heap into the
+ * back buffer and flips it to the front with a single atomic store.
+ * Readers call read() and get a guard that pins the front buffer: no
+ * locks are taken on either side, and the heap itself is never touched
+ * by a reader. If a slow reader still pins the back buffer, publish()
+ * returns false without waiting and the caller simply tries again after
+ * its next change; readers keep seeing the previous version meanwhile.
+ */
+class HeapStructurePublisher {
+private:
+    HeapStructure buffers[2];
+    mutable std::atomic<int> readers[2];
+    std::atomic<int> front;
+    uint64_t published;  // writer-side only
+
+public:
+    class ReadGuard {
+    private:
+        const HeapStructurePublisher* owner;
+        int slot;
+
+    public:
+        ReadGuard(const HeapStructurePublisher* o, int s) : owner(o), slot(s) {}
+        ~ReadGuard() {
+            if (owner) owner->readers[slot].fetch_sub(1);
+        }
+        ReadGuard(ReadGuard&& other) noexcept : owner(other.owner), slot(other.slot) {
+            other.owner = nullptr;
+        }
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+        ReadGuard& operator=(ReadGuard&&) = delete;
+
+        const HeapStructure& operator*() const { return owner->buffers[slot]; }
+        const HeapStructure* operator->() const { return &owner->buffers[slot]; }
+    };
+
+    HeapStructurePublisher() : front(0), published(0) {
+        readers[0].store(0);
+        readers[1].store(0);
+    }
+
+    HeapStructurePublisher(const HeapStructurePublisher&) = delete;
+    HeapStructurePublisher& operator=(const HeapStructurePublisher&) = delete;
+
+    // Writer side: only the thread that mutates the heap may call this
+    template <typename Heap>
+    bool publish(const Heap& heap) {
+        int back = 1 - front.load();
+        if (readers[back].load() != 0) return false;
+        HeapStructure& target = buffers[back];
+        heap.captureStructure(target);
+        target.version = ++published;
+        // a reader that pinned back before this store re-checks front and retries
+        front.store(back);
+        return true;
+    }
+
+    uint64_t version() const { return published; }
+
+    // Reader side: safe from any thread, never blocks
+    ReadGuard read() const {
+        while (true) {
+            int slot = front.load();
+            readers[slot].fetch_add(1);
+            if (front.load() == slot) return ReadGuard(this, slot);
+            readers[slot].fetch_sub(1);
+        }
+    }
+};
+
+#endif // HEAP_STRUCTURE_HPP
@@ -0,0 +1,209 @@
+#ifndef HEAP_TRACE_HPP
+#define HEAP_TRACE_HPP
+
+#include "FibonacciHeap.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Binary workload traces for heap engines.
+ *
+ * A trace is a 16-byte header followed by fixed-size 12-byte records in
+ * native (little-endian) byte order. Nodes are identified by handles:
+ * the n-th Insert record creates handle n, and later records refer to it.
+ * Payloads are not recorded, only the keys and the order of operations.
+ */
+enum class TraceOp : uint8_t {
+    INSERT = 1,        // handle = new handle, key = key
+    EXTRACT_MIN = 2,   // handle = extracted node
+    DECREASE_KEY = 3,  // handle = node, key = new key
+    UPDATE_KEY = 4,    // handle = node, key = new key (either direction)
+    DELETE_NODE = 5,   // handle = node
+    GET_MIN = 6        // peek only
+};
+
+struct TraceHeader {
+    char magic[4];         // "FHTR"
+    uint16_t version;
+    uint16_t recordSize;
+    uint64_t recordCount;  // 0 if the writer did not close cleanly
+};
+
+struct TraceRecord {
+    uint8_t op;
+    uint8_t reserved[3];
+    uint32_t handle;
+    int32_t key;
+};
+
+static_assert(sizeof(TraceHeader) == 16, "TraceHeader must stay 16 bytes");
+static_assert(sizeof(TraceRecord) == 12, "TraceRecord must stay 12 bytes");
+
+constexpr uint16_t TRACE_VERSION = 1;
+constexpr uint32_t TRACE_NO_HANDLE = 0xFFFFFFFFu;
+
+/**
+ * Streams heap operations into a trace file.
+ * Records are buffered and written in large chunks, so recording costs a
+ * hash lookup and a few stores per operation.
+ */
+class HeapTraceWriter {
+private:
+    static constexpr size_t BUFFER_RECORDS = 4096;
+
+    std::FILE* file;
+    std::vector<TraceRecord> buffer;
+    std::unordered_map<const void*, uint32_t> handles;
+    uint32_t nextHandle;
+    uint64_t written;
+
+    void append(TraceOp op, uint32_t handle, int key) {
+        TraceRecord rec;
+        rec.op = static_cast<uint8_t>(op);
+        rec.reserved[0] = rec.reserved[1] = rec.reserved[2] = 0;
+        rec.handle = handle;
+        rec.key = key;
+        buffer.push_back(rec);
+        if (buffer.size() >= BUFFER_RECORDS) flush();
+    }
+
+    uint32_t handleOf(const void* node) const {
+        auto it = handles.find(node);
+        return it == handles.end() ? TRACE_NO_HANDLE : it->second;
+    }
+
+    uint32_t takeHandle(const void* node) {
+        auto it = handles.find(node);
+        if (it == handles.end()) return TRACE_NO_HANDLE;
+        uint32_t handle = it->second;
+        handles.erase(it);
+        return handle;
+    }
+
+public:
+    explicit HeapTraceWriter(const std::string& path)
+        : file(std::fopen(path.c_str(), "wb")), nextHandle(0), written(0) {
+        if (!file) throw std::runtime_error("Cannot create trace file " + path);
+        buffer.reserve(BUFFER_RECORDS);
+        TraceHeader header;
+        std::memcpy(header.magic, "FHTR", 4);
+        header.version = TRACE_VERSION;
+        header.recordSize = sizeof(TraceRecord);
+        header.recordCount = 0;
+        std::fwrite(&header, sizeof(header), 1, file);
+    }
+
+    ~HeapTraceWriter() {
+        flush();
+        // Patch the record count so readers can detect truncated traces
+        if (std::fseek(file, offsetof(TraceHeader, recordCount), SEEK_SET) == 0) {
+            std::fwrite(&written, sizeof(written), 1, file);
+        }
+        std::fclose(file);
+    }
+
+    HeapTraceWriter(const HeapTraceWriter&) = delete;
+    HeapTraceWriter& operator=(const HeapTraceWriter&) = delete;
+
+    void flush() {
+        if (buffer.empty()) return;
+        std::fwrite(buffer.data(), sizeof(TraceRecord), buffer.size(), file);
+        written += buffer.size();
+        buffer.clear();
+        std::fflush(file);
+    }
+
+    uint64_t recordCount() const { return written + buffer.size(); }
+
+    void recordInsert(const void* node, int key) {
+        uint32_t handle = nextHandle++;
+        handles[node] = handle;
+        append(TraceOp::INSERT, handle, key);
+    }
+
+    void recordExtractMin(const void* node) {
+        append(TraceOp::EXTRACT_MIN, takeHandle(node), 0);
+    }
+
+    void recordDecreaseKey(const void* node, int key) {
+        append(TraceOp::DECREASE_KEY, handleOf(node), key);
+    }
+
+    // The heap may move a value to a new node on a key increase,
+    // so the handle is rebound to whichever node holds it afterwards
+    void recordUpdateKey(const void* oldNode, const void* newNode, int key) {
+        uint32_t handle = takeHandle(oldNode);
+        if (handle != TRACE_NO_HANDLE) handles[newNode] = handle;
+        append(TraceOp::UPDATE_KEY, handle, key);
+    }
+
+    void recordDelete(const void* node) {
+        append(TraceOp::DELETE_NODE, takeHandle(node), 0);
+    }
+
+    void recordGetMin() {
+        append(TraceOp::GET_MIN, TRACE_NO_HANDLE, 0);
+    }
+};
+
+/**
+ * FibonacciHeap front-end that records every operation it forwards.
+ */
+template <typename T>
+class RecordingHeap {
+public:
+    using Node = typename FibonacciHeap<T>::Node;
+
+private:
+    FibonacciHeap<T>& heap;
+    HeapTraceWriter& trace;
+
+public:
+    RecordingHeap(FibonacciHeap<T>& h, HeapTraceWriter& w) : heap(h), trace(w) {}
+
+    Node* insert(const T& value, int key) {
+        Node* node = heap.insert(value, key);
+        trace.recordInsert(node, key);
+        return node;
+    }
+
+    Node* getMin() const {
+        trace.recordGetMin();
+        return heap.getMin();
+    }
+
+    Node* extractMin() {
+        Node* node = heap.extractMin();
+        if (node) trace.recordExtractMin(node);
+        return node;
+    }
+
+    void decreaseKey(Node* x, int newKey) {
+        heap.decreaseKey(x, newKey);
+        trace.recordDecreaseKey(x, newKey);
+    }
+
+    Node* updateKey(Node* x, int newKey) {
+        Node* moved = heap.updateKey(x, newKey);
+        if (moved) trace.recordUpdateKey(x, moved, newKey);
+        return moved;
+    }
+
+    void deleteNode(Node* x) {
+        if (!x) return;
+        trace.recordDelete(x);
+        heap.deleteNode(x);
+    }
+
+    bool isEmpty() const { return heap.isEmpty(); }
+    int getSize() const { return heap.getSize(); }
+    FibonacciHeap<T>& getHeap() { return heap; }
+};
+
+#endif // HEAP_TRACE_HPP
@@ -0,0 +1,85 @@
+#ifndef HEAPWORKER_H
+#define HEAPWORKER_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+#include <memory>
+#include <random>
+#include <vector>
+#include "AnimationRecord.hpp"
+#include "FibonacciHeap.hpp"
+#include "HeapScene.h"
+#include "TidyTreeLayout.hpp"
+
+// The visualized heap keeps its own tree layout up to date (see
+// TidyTreeLayout) and records what it does for playback
+using VisualHeap = FibonacciHeap<int, AnimationRecorder<TidyTreeLayout>>;
+
+/**
+ * Owns the visualized heap on a thread of its own.
+ *
+ * The object is moved to a QThread, and its event queue is the command
+ * queue: the GUI calls the command methods through queued invocations
+ * (see MainWindow::post()), and each runs on the worker thread in order.
+ * After changes the worker lays the heap out and publishes a HeapScene
+ * through sceneReady(); commands arriving meanwhile are coalesced into one
+ * scene, and during bulk work scenes are sent at most every
+ * PUBLISH_INTERVAL_MS, so the GUI thread only ever swaps a pointer.
+ * Each scene also notes where it differs from the one before it, so the
+ * canvas redraws only those parts of its cached rendering.
+ * Operations run at full speed; each scene carries the animation records
+ * of what happened since the previous one, for AnimationSystem to play
+ * back at its own pace.
+ *
+ * Commands on a node take the node's id and the version of the scene it
+ * was picked from. If the heap has changed since, the id may be stale and
+ * the command is refused rather than touching a freed node.
+ */
+class HeapWorker : public QObject {
+    Q_OBJECT
+
+private:
+    VisualHeap heap;
+    uint64_t version;        // bumped by every change
+    HeapScenePtr published;  // the last scene sent, which the next is compared to
+    bool publishQueued;
+    QElapsedTimer sincePublish;
+    std::mt19937 random;
+    long long pendingInserts;  // left of the random inserts in progress
+    long long bulkInserted;
+
+    static constexpr int BULK_CHUNK = 20000;
+    static constexpr int PUBLISH_INTERVAL_MS = 100;
+    static constexpr int RANDOM_KEY_RANGE = 1000000;
+
+    void changed();
+    void publish();
+    void continueInsertRandom();
+    VisualHeap::Node* nodeFor(const void* id, quint64 sceneVersion);
+
+public:
+    explicit HeapWorker(QObject* parent = nullptr);
+
+    // Lays heap out into a new scene without records; the worker's own
+    // publishing step, also timed by canvas_bench
+    static std::shared_ptr<HeapScene> layOut(VisualHeap& heap, uint64_t version);
+    // Fills in scene's changes since previous: the areas of nodes drawn
+    // differently, and the bounds of subtrees that changed shape
+    static void noteChanges(HeapScene& scene, const HeapScene& previous);
+
+    // Commands; call through a queued invocation from other threads
+    void insert(int value);
+    void insertRandom(int count);
+    void extractMin();
+    void decreaseKey(const void* id, int newKey, quint64 sceneVersion);
+    void deleteNode(const void* id, quint64 sceneVersion);
+    void merge(const std::vector<int>& keys);
+    void reset();
+
+signals:
+    void sceneReady(HeapScenePtr scene);
+    void commandDone(const QString& message);
+};
+
+#endif // HEAPWORKER_H
@@ -4,57 +4,91 @@
 #include "HeapInterface.h"
 #include "FibonacciHeap.hpp"
 #include <QString>
+#include <algorithm>
 #include <string>
 #include <sstream>
 
-// Template wrapper for FibonacciHeap nodes
+// Payload as a HeapWrapper<T> stores it: the value plus its display
+// string, formatted on first use. The string lives in the node, so it
+// goes when the node is extracted or deleted, a reused pool slot starts
+// without one, and an increased key (which re-inserts the value) carries
+// it over to the new node. Like the heap, it is used from one thread.
 template<typename T>
-class HeapNodeWrapper : public IHeapNode {
-private:
-    typename FibonacciHeap<T>::Node* node;
-    
-public:
-    explicit HeapNodeWrapper(typename FibonacciHeap<T>::Node* n) : node(n) {}
+struct DisplayedValue {
+    T value;
+    mutable QString text;
+    mutable bool formatted = false;
+
+    explicit DisplayedValue(const T& v) : value(v) {}
+    bool operator==(const DisplayedValue& other) const { return value == other.value; }
+};
+
+// Accessor table for HeapWrapper<T> nodes; &HeapNodeOpsFor<T>::table is
+// the type tag of every handle into a HeapWrapper<T>
+template<typename T>
+struct HeapNodeOpsFor {
+    using Node = typename FibonacciHeap<DisplayedValue<T>>::Node;
     
-    typename FibonacciHeap<T>::Node* getActualNode() const { return node; }
+    static const Node* cast(const void* p) { return static_cast<const Node*>(p); }
     
-    QString getDisplayValue() const override {
-        if (!node) return "";
-        std::ostringstream oss;
-        oss << node->value;
-        return QString::fromStdString(oss.str());
+    // The payload types the GUI offers convert directly, without a stream
+    static QString format(const T& value) {
+        if constexpr (std::is_same_v<T, int>) {
+            return QString::number(value);
+        } else if constexpr (std::is_same_v<T, char>) {
+            return QString(QChar::fromLatin1(value));
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            return QString::fromStdString(value);
+        } else {
+            std::ostringstream oss;
+            oss << value;
+            return QString::fromStdString(oss.str());
+        }
     }
     
-    int getKey() const override { return node ? node->key : 0; }
-    int getDegree() const override { return node ? node->degree : 0; }
-    bool isMarked() const override { return node ? node->marked : false; }
-    
-    IHeapNode* getParent() const override {
-        if (!node || !node->parent) return nullptr;
-        return new HeapNodeWrapper<T>(node->parent);
+    static QString displayValue(const void* p) {
+        const DisplayedValue<T>& payload = cast(p)->value;
+        if (!payload.formatted) {
+            payload.text = format(payload.value);
+            payload.formatted = true;
+        }
+        return payload.text;
     }
     
-    IHeapNode* getChild() const override {
-        if (!node || !node->child) return nullptr;
-        return new HeapNodeWrapper<T>(node->child);
-    }
+    static int key(const void* p) { return cast(p)->key; }
+    static int degree(const void* p) { return cast(p)->degree; }
+    static bool marked(const void* p) { return cast(p)->marked; }
+    static void* parent(const void* p) { return cast(p)->parent; }
+    static void* child(const void* p) { return cast(p)->child; }
+    static void* left(const void* p) { return cast(p)->left; }
+    static void* right(const void* p) { return cast(p)->right; }
     
-    IHeapNode* getLeft() const override {
-        if (!node || !node->left) return nullptr;
-        return new HeapNodeWrapper<T>(node->left);
-    }
+    static const HeapNodeOps table;
     
-    IHeapNode* getRight() const override {
-        if (!node || !node->right) return nullptr;
-        return new HeapNodeWrapper<T>(node->right);
-    }
+    static HeapNodeHandle handle(Node* node) { return HeapNodeHandle(node, &table); }
+};
+
+template<typename T>
+const HeapNodeOps HeapNodeOpsFor<T>::table = {
+    &HeapNodeOpsFor<T>::displayValue,
+    &HeapNodeOpsFor<T>::key,
+    &HeapNodeOpsFor<T>::degree,
+    &HeapNodeOpsFor<T>::marked,
+    &HeapNodeOpsFor<T>::parent,
+    &HeapNodeOpsFor<T>::child,
+    &HeapNodeOpsFor<T>::left,
+    &HeapNodeOpsFor<T>::right,
 };
 
 // Template wrapper for FibonacciHeap
 template<typename T>
 class HeapWrapper : public IFibonacciHeap {
 private:
-    FibonacciHeap<T> heap;
+    using Ops = HeapNodeOpsFor<T>;
+    using Heap = FibonacciHeap<DisplayedValue<T>>;
+    using Node = typename Heap::Node;
+    
+    Heap heap;
     
     T parseValue(const QString& str) {
         if constexpr (std::is_same_v<T, int>) {
@@ -69,17 +103,13 @@ private:
     
 public:
     HeapWrapper() = default;
-    ~HeapWrapper() override = default;
     
-    IHeapNode* insert(const QString& value, int key) override {
-        T val = parseValue(value);
-        auto* node = heap.insert(val, key);
-        return new HeapNodeWrapper<T>(node);
+    HeapNodeHandle insert(const QString& value, int key) override {
+        return Ops::handle(heap.insert(DisplayedValue<T>(parseValue(value)), key));
     }
     
-    IHeapNode* getMin() const override {
-        auto* node = heap.getMin();
-        return node ? new HeapNodeWrapper<T>(node) : nullptr;
+    HeapNodeHandle getMin() const override {
+        return Ops::handle(heap.getMin());
     }
     
     bool isEmpty() const override {
@@ -90,51 +120,80 @@ public:
         return heap.getSize();
     }
     
-    IHeapNode* extractMin() override {
+    std::optional<HeapEntry> extractMin() override {
         auto* node = heap.extractMin();
-        if (!node) return nullptr;
-        auto* wrapper = new HeapNodeWrapper<T>(node);
-        delete node;  // Clean up the actual node
-        return wrapper;
+        if (!node) return std::nullopt;
+        HeapEntry entry{Ops::displayValue(node), node->key};
+        heap.release(node);  // Clean up the actual node
+        return entry;
+    }
+    
+    void decreaseKey(HeapNodeHandle node, int newKey) override {
+        if (Node* actual = nodeOf(node)) {
+            heap.decreaseKey(actual, newKey);
+        }
+    }
+    
+    void deleteNode(HeapNodeHandle node) override {
+        if (Node* actual = nodeOf(node)) {
+            heap.deleteNode(actual);
+        }
+    }
+    
+    void insertBatch(const QStringList& values, const std::vector<int>& keys,
+                     std::vector<HeapNodeHandle>* inserted) override {
+        size_t count = std::min(static_cast<size_t>(values.size()), keys.size());
+        if (inserted) inserted->reserve(inserted->size() + count);
+        for (size_t i = 0; i < count; ++i) {
+            Node* node = heap.insert(DisplayedValue<T>(parseValue(values[static_cast<int>(i)])), keys[i]);
+            if (inserted) inserted->push_back(Ops::handle(node));
+        }
     }
     
-    void decreaseKey(IHeapNode* node, int newKey) override {
-        auto* wrapper = dynamic_cast<HeapNodeWrapper<T>*>(node);
-        if (wrapper && wrapper->getActualNode()) {
-            heap.decreaseKey(wrapper->getActualNode(), newKey);
+    void updateKeys(KeyUpdate* updates, size_t count) override {
+        for (size_t i = 0; i < count; ++i) {
+            if (Node* actual = nodeOf(updates[i].node)) {
+                // an increase re-inserts the value in a new node
+                updates[i].node = Ops::handle(heap.updateKey(actual, updates[i].newKey));
+            }
         }
     }
     
-    void deleteNode(IHeapNode* node) override {
-        auto* wrapper = dynamic_cast<HeapNodeWrapper<T>*>(node);
-        if (wrapper && wrapper->getActualNode()) {
-            heap.deleteNode(wrapper->getActualNode());
+    void collectNodes(std::vector<HeapNodeHandle>& out) const override {
+        out.reserve(out.size() + static_cast<size_t>(heap.getSize()));
+        for (auto* node : heap.nodes()) {
+            out.push_back(Ops::handle(node));
         }
     }
     
     void merge(IFibonacciHeap* other) override {
-        auto* otherWrapper = dynamic_cast<HeapWrapper<T>*>(other);
-        if (otherWrapper) {
-            heap.merge(otherWrapper->heap);
+        if (other && other != this && other->nodeType() == nodeType()) {
+            heap.merge(static_cast<HeapWrapper<T>*>(other)->heap);
         }
     }
     
-    std::vector<IHeapNode*> getRootList() const override {
-        Vector<typename FibonacciHeap<T>::Node*> roots = heap.getRootList();
-        std::vector<IHeapNode*> result;
-        for (size_t i = 0; i < roots.size(); ++i) {
-            result.push_back(new HeapNodeWrapper<T>(roots[i]));
+    const HeapNodeOps* nodeType() const override {
+        return &Ops::table;
+    }
+    
+    std::vector<HeapNodeHandle> getRootList() const override {
+        std::vector<HeapNodeHandle> result;
+        for (auto* root : heap.roots()) {
+            result.push_back(Ops::handle(root));
         }
         return result;
     }
     
-    IHeapNode* search(const QString& value) override {
-        T val = parseValue(value);
-        auto* node = heap.search(val);
-        return node ? new HeapNodeWrapper<T>(node) : nullptr;
+    HeapNodeHandle search(const QString& value) override {
+        return Ops::handle(heap.search(DisplayedValue<T>(parseValue(value))));
+    }
+    
+    // Typed node behind a handle, or nullptr if it belongs to another payload type
+    static Node* nodeOf(HeapNodeHandle handle) {
+        return handle.type() == &Ops::table ? static_cast<Node*>(handle.get()) : nullptr;
     }
     
-    FibonacciHeap<T>& getActualHeap() { return heap; }
+    Heap& getActualHeap() { return heap; }
 };
 
 #endif // HEAP_WRAPPER_H
@@ -2,6 +2,8 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
+#include <QCheckBox>
+#include <QElapsedTimer>
 #include <QWidget>
 #include <QPushButton>
 #include <QLineEdit>
@@ -12,50 +14,113 @@
 #include <QSlider>
 #include <QTimer>
 #include <QMouseEvent>
-#include <map>
-#include "FibonacciHeap.hpp"
+#include <QPixmap>
+#include <QWheelEvent>
+#include <QThread>
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
 #include "AnimationSystem.h"
+#include "HeapScene.h"
+#include "HeapWorker.h"
 
 /**
- * Canvas widget for drawing the Fibonacci Heap with animation and interaction support
+ * Canvas widget for drawing the Fibonacci Heap with animation and interaction support.
+ * It draws HeapScenes published by the HeapWorker and never touches the
+ * heap itself: while recorded operations play back, the scene they ran
+ * in (see AnimationFrame), and the latest one once playback catches up.
  */
 class HeapCanvas : public QWidget {
     Q_OBJECT
     
 private:
-    FibonacciHeap<int>* heap;
+    HeapScenePtr scene;   // the one drawn and hit-tested
+    HeapScenePtr latest;  // the heap as it is now
     AnimationSystem* animationSystem;
-    std::map<FibonacciHeap<int>::Node*, QPointF> nodePositions;
-    FibonacciHeap<int>::Node* selectedNode;
-    FibonacciHeap<int>::Node* highlightedNode;
+    // Selection and highlight follow the node across scenes by id; the
+    // index is its entry in the current scene, -1 if it is not in it
+    const void* selectedId;
+    const void* highlightedId;
+    int selectedIndex;
+    int highlightedIndex;
+
+    // View transform: screen = layout * zoom + pan
+    float zoom;
+    QPoint pan;
+    QPoint lastDragPos;
+    bool dragging;
+
+    // Rendered scene (heap without selection and highlight) in tiles of
+    // TILE_SIZE screen pixels at the current zoom, keyed by tile column
+    // and row; dropped when the zoom changes, and where the scene does
+    std::unordered_map<uint64_t, QPixmap> tiles;
+
+    // Frame-time overlay: the last FRAME_SAMPLES painted frames
+    struct FrameSample {
+        float paintMs;      // the whole paintEvent()
+        float animationMs;  // of which the animation and its caption
+        float intervalMs;   // since the previous frame
+    };
+    static constexpr size_t FRAME_SAMPLES = 120;
+    std::array<FrameSample, FRAME_SAMPLES> frameSamples;
+    size_t frameCount;
+    bool showFrameStats;
+    QElapsedTimer sinceLastFrame;
+    float lastAnimationMs;
     
-    // Constants - Increased spacing to prevent node overlap
-    static constexpr float NODE_RADIUS = 30.0f;
-    static constexpr float HORIZONTAL_SPACING = 150.0f;
-    static constexpr float VERTICAL_SPACING = 120.0f;
-    static constexpr float SIBLING_SPACING = 100.0f;
+    // Constants - spacing between nodes is set by TidyTreeLayout
+    static constexpr float NODE_RADIUS = HeapScene::NODE_RADIUS;
+
+    static constexpr int TILE_SIZE = 512;
+    static constexpr size_t MAX_TILES = 96;
+    static constexpr float MIN_ZOOM = 0.01f;
+    static constexpr float MAX_ZOOM = 4.0f;
+    // Subtrees smaller than this on screen are drawn as one summary glyph
+    static constexpr float SUMMARY_EXTENT = 24.0f;
+    // Keys are drawn only while a node is at least this large on screen
+    static constexpr float TEXT_MIN_RADIUS = 7.0f;
     
-    void calculateNodePositions();
-    void positionSubtree(FibonacciHeap<int>::Node* node, float x, float y, float& maxX, int depth = 0);
-    void drawNode(QPainter& painter, FibonacciHeap<int>::Node* node, float x, float y, bool isRoot);
-    void drawConnections(QPainter& painter);
-    void drawPointerLines(QPainter& painter);
-    FibonacciHeap<int>::Node* findNodeAtPosition(const QPointF& pos);
+    void showScene(const HeapScenePtr& shown);
+    void locateSelection();
+    void drawHeap(QPainter& painter, const QRect& exposedRect, const AnimationFrame& frame);
+    void drawScene(QPainter& painter, const QRectF& area);
+    void drawSubtree(QPainter& painter, int index, const QRectF& area);
+    void drawNode(QPainter& painter, int index, bool decorate);
+    void drawAnimation(QPainter& painter, const AnimationFrame& frame);
+    void drawCaption(QPainter& painter, const AnimationFrame& frame);
+    void drawFrameStats(QPainter& painter);
+    const QPixmap& tileAt(int column, int row);
+    void invalidateTiles(const HeapScene& next);  // the ones next draws differently
+    QPointF toLayout(const QPointF& screenPos) const;
+    int findNodeAtPosition(const QPointF& pos) const;
     
 protected:
     void paintEvent(QPaintEvent* event) override;
     void mousePressEvent(QMouseEvent* event) override;
     void mouseMoveEvent(QMouseEvent* event) override;
+    void mouseReleaseEvent(QMouseEvent* event) override;
+    void wheelEvent(QWheelEvent* event) override;
     
 public:
-    explicit HeapCanvas(FibonacciHeap<int>* h, AnimationSystem* anim, QWidget* parent = nullptr);
+    explicit HeapCanvas(AnimationSystem* anim, QWidget* parent = nullptr);
+    void invalidateTiles();  // all of them; the next paint renders from scratch
     
-    FibonacciHeap<int>::Node* getSelectedNode() const { return selectedNode; }
-    void setHighlightedNode(FibonacciHeap<int>::Node* node);
+    // The scene on screen, which is older than the latest during playback;
+    // node commands carry its version, so the worker refuses stale ones
+    const HeapScene& getScene() const { return *scene; }
+    const HeapScene& getLatestScene() const { return *latest; }
+    const HeapScene::Node* getSelectedNode() const;
+    void setHighlightedNode(const void* id);
     void clearSelection();
+    // Shows a newer scene from the worker; plain update() only repaints
+    void setScene(HeapScenePtr newScene);
+    // Zooms and pans so the whole heap is in view
+    void zoomToFit();
+    void setFrameStatsVisible(bool visible);
     
 signals:
-    void nodeSelected(FibonacciHeap<int>::Node* node);
+    void nodeSelected(const HeapScene::Node* node);
 };
 
 /**
@@ -66,16 +131,19 @@ class MainWindow : public QMainWindow {
     Q_OBJECT
     
 private:
-    FibonacciHeap<int> heap;
-    FibonacciHeap<int> heap2;  // For union operation
+    // The heap lives on workerThread; see HeapWorker
+    QThread workerThread;
+    HeapWorker* worker;
     AnimationSystem* animationSystem;
     
     // UI Elements - Input
     QLineEdit* inputField;
     QSpinBox* keySpinBox;
+    QSpinBox* randomCountSpinBox;
     
     // UI Elements - Buttons
     QPushButton* insertButton;
+    QPushButton* insertRandomButton;
     QPushButton* findMinButton;
     QPushButton* extractMinButton;
     QPushButton* decreaseKeyButton;
@@ -85,7 +153,13 @@ private:
     
     // Animation controls
     QSlider* speedSlider;
+    QLabel* speedInfoLabel;
     QPushButton* pauseResumeButton;
+    QPushButton* skipButton;
+    QPushButton* liveButton;
+    QSlider* scrubSlider;
+    QCheckBox* frameStatsBox;
+    QPushButton* fitButton;
     
     // Display elements
     QLabel* statusLabel;
@@ -93,13 +167,14 @@ private:
     HeapCanvas* canvas;
     
     void setupUI();
+    template <typename Command> void post(Command command);
     void updateStatus(const QString& message);
     void updateInfo();
-    void setupAnimationForExtractMin();
-    void setupAnimationForDecreaseKey();
+    void updatePlaybackControls();
     
 private slots:
     void onInsertClicked();
+    void onInsertRandomClicked();
     void onFindMinClicked();
     void onExtractMinClicked();
     void onDecreaseKeyClicked();
@@ -108,9 +183,13 @@ private slots:
     void onResetClicked();
     void onPauseResumeClicked();
     void onSpeedChanged(int value);
+    void onSkipClicked();
+    void onLiveClicked();
+    void onScrubMoved(int value);
     void onAnimationUpdate();
     void onAnimationCompleted();
-    void onNodeSelected(FibonacciHeap<int>::Node* node);
+    void onNodeSelected(const HeapScene::Node* node);
+    void onSceneReady(HeapScenePtr scene);
     
 public:
     MainWindow(QWidget* parent = nullptr);
@@ -0,0 +1,87 @@
+#ifndef SPATIAL_HASH_GRID_HPP
+#define SPATIAL_HASH_GRID_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Uniform grid over a set of points, for finding the points near a
+ * position in O(1) expected time.
+ *
+ * Points are numbered 0..count-1 by the caller and binned by the cell
+ * that contains them. Cells are hashed into a bucket table about as large
+ * as the point set, so the grid needs no bounds and its memory follows
+ * the number of points rather than the area they cover. Buckets are
+ * stored as one flat array (counting sort), rebuilt from scratch by
+ * build(). With a cell size of at least twice the search radius, every
+ * point within that radius of a position is in the 3x3 cells around it.
+ */
+class SpatialHashGrid {
+private:
+    float cellSize;
+    uint32_t mask = 0;                   // bucket count - 1
+    std::vector<uint32_t> bucketStart;   // bucket b is items[bucketStart[b], bucketStart[b + 1])
+    std::vector<uint32_t> items;
+    std::vector<uint32_t> itemBucket;    // scratch for build()
+
+    int32_t cellOf(float v) const { return static_cast<int32_t>(std::floor(v / cellSize)); }
+
+    uint32_t bucketOf(int32_t cx, int32_t cy) const {
+        uint32_t h = static_cast<uint32_t>(cx) * 0x9E3779B1u ^ static_cast<uint32_t>(cy) * 0x85EBCA77u;
+        return (h ^ (h >> 15)) & mask;
+    }
+
+public:
+    explicit SpatialHashGrid(float cell = 64.0f) : cellSize(cell) {}
+
+    void setCellSize(float cell) { cellSize = cell; }
+    float getCellSize() const { return cellSize; }
+    size_t size() const { return items.size(); }
+
+    // pointAt(i) returns the position of point i as anything with x() and y()
+    template <typename PointAt>
+    void build(size_t count, PointAt pointAt) {
+        uint32_t buckets = 1;
+        while (buckets < count) buckets <<= 1;
+        mask = buckets - 1;
+
+        bucketStart.assign(buckets + 1, 0);
+        itemBucket.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            auto p = pointAt(i);
+            uint32_t b = bucketOf(cellOf(static_cast<float>(p.x())), cellOf(static_cast<float>(p.y())));
+            itemBucket[i] = b;
+            bucketStart[b + 1]++;
+        }
+        for (uint32_t b = 0; b < buckets; ++b) bucketStart[b + 1] += bucketStart[b];
+
+        items.resize(count);
+        std::vector<uint32_t> fill(bucketStart.begin(), bucketStart.end() - 1);
+        for (size_t i = 0; i < count; ++i) items[fill[itemBucket[i]]++] = static_cast<uint32_t>(i);
+    }
+
+    void clear() {
+        bucketStart.clear();
+        items.clear();
+        mask = 0;
+    }
+
+    // Calls visit(i) for every point in the 3x3 cells around (x, y). Points
+    // of other cells sharing a bucket are visited too, and a bucket shared
+    // by two of the nine cells is visited twice; callers test the distance.
+    template <typename Visit>
+    void forEachNear(float x, float y, Visit visit) const {
+        if (items.empty()) return;
+        int32_t cx = cellOf(x);
+        int32_t cy = cellOf(y);
+        for (int32_t dy = -1; dy <= 1; ++dy) {
+            for (int32_t dx = -1; dx <= 1; ++dx) {
+                uint32_t b = bucketOf(cx + dx, cy + dy);
+                for (uint32_t k = bucketStart[b]; k < bucketStart[b + 1]; ++k) visit(items[k]);
+            }
+        }
+    }
+};
+
+#endif // SPATIAL_HASH_GRID_HPP
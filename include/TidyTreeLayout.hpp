@@ -0,0 +1,160 @@
+#ifndef TIDY_TREE_LAYOUT_HPP
+#define TIDY_TREE_LAYOUT_HPP
+
+#include "HeapObserver.hpp"
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Reingold-Tilford style layout of a heap's trees, kept up to date
+ * through the heap's observer hooks.
+ *
+ * Each subtree has a cached Shape: the horizontal extent of every level
+ * relative to the subtree's root (its contour) and the offset of each
+ * child. A parent's shape is built from its children's shapes by sliding
+ * each child right until its contour clears the ones before it by
+ * siblingGap, then centring the parent over the first and last child, so
+ * subtrees never overlap and a node costs O(degree * height).
+ *
+ * Used as the heap's Observer: linked() and cut() mark the parent and its
+ * ancestors dirty, and only dirty shapes are rebuilt by the next place().
+ * A subtree that moves as a whole (cut off, linked under a new root or
+ * merged in from another heap) keeps its cached shape.
+ */
+class TidyTreeLayout : public NullHeapObserver {
+public:
+    struct Shape {
+        std::vector<float> left;         // per level, relative to the subtree root
+        std::vector<float> right;
+        std::vector<float> childOffset;  // in child ring order
+        bool dirty = true;
+
+        float minLeft() const { return *std::min_element(left.begin(), left.end()); }
+        float maxRight() const { return *std::max_element(right.begin(), right.end()); }
+        int height() const { return static_cast<int>(left.size()); }
+    };
+
+private:
+    float nodeRadius;
+    float siblingGap;
+    float treeGap;
+    float levelHeight;
+    std::unordered_map<const void*, Shape> shapes;
+    size_t rebuilt = 0;  // shapes rebuilt so far, for profiling
+
+    // Marks node and its ancestors dirty. A dirty ancestor already has
+    // dirty ancestors, so the walk stops there.
+    template <typename Node>
+    void invalidate(const Node* node) {
+        for (; node; node = node->parent) {
+            auto it = shapes.find(node);
+            if (it == shapes.end()) continue;
+            if (it->second.dirty) return;
+            it->second.dirty = true;
+        }
+    }
+
+    template <typename Node>
+    const Shape& shapeOf(const Node* node) {
+        // references into an unordered_map survive rehashing, so shape
+        // stays valid while the children's shapes are built
+        Shape& shape = shapes[node];
+        if (!shape.dirty) return shape;
+        rebuilt++;
+
+        shape.left.assign(1, -nodeRadius);
+        shape.right.assign(1, nodeRadius);
+        shape.childOffset.clear();
+
+        const Node* first = node->child;
+        if (first) {
+            // contour of the children placed so far, one level below node
+            std::vector<float> accLeft;
+            std::vector<float> accRight;
+            const Node* child = first;
+            do {
+                const Shape& sub = shapeOf(child);
+                float offset = 0.0f;
+                if (!accRight.empty()) {
+                    size_t common = std::min(accRight.size(), sub.left.size());
+                    offset = accRight[0] - sub.left[0] + siblingGap;
+                    for (size_t l = 1; l < common; ++l) {
+                        offset = std::max(offset, accRight[l] - sub.left[l] + siblingGap);
+                    }
+                }
+                for (size_t l = 0; l < sub.left.size(); ++l) {
+                    if (l < accRight.size()) {
+                        accRight[l] = offset + sub.right[l];
+                    } else {
+                        accLeft.push_back(offset + sub.left[l]);
+                        accRight.push_back(offset + sub.right[l]);
+                    }
+                }
+                shape.childOffset.push_back(offset);
+                child = child->right;
+            } while (child != first);
+
+            float mid = (shape.childOffset.front() + shape.childOffset.back()) / 2.0f;
+            for (float& offset : shape.childOffset) offset -= mid;
+            for (size_t l = 0; l < accLeft.size(); ++l) {
+                shape.left.push_back(accLeft[l] - mid);
+                shape.right.push_back(accRight[l] - mid);
+            }
+        }
+        shape.dirty = false;
+        return shape;
+    }
+
+    template <typename Node, typename Visit>
+    void placeSubtree(const Node* node, float x, float y, int parent, int& next, Visit& visit) {
+        const Shape& shape = shapes.find(node)->second;
+        int index = next++;
+        visit(node, x, y, parent, shape, x + shape.minLeft(), x + shape.maxRight());
+        if (!node->child) return;
+        const Node* child = node->child;
+        size_t i = 0;
+        do {
+            placeSubtree(child, x + shape.childOffset[i++], y + levelHeight, index, next, visit);
+            child = child->right;
+        } while (child != node->child);
+    }
+
+public:
+    TidyTreeLayout(float radius = 30.0f, float gap = 40.0f, float rootGap = 120.0f, float level = 120.0f)
+        : nodeRadius(radius), siblingGap(gap), treeGap(rootGap), levelHeight(level) {}
+
+    // Observer hooks
+    template <typename Node> void linked(const Node*, const Node* parent) { invalidate(parent); }
+    template <typename Node> void cut(const Node*, const Node* parent) { invalidate(parent); }
+    template <typename Node> void extracted(const Node* node) { shapes.erase(node); }
+    // merged trees arrive whole, so the source's shapes are still right
+    template <typename Node> void merged(const Node*, TidyTreeLayout& source) { shapes.merge(source.shapes); }
+    void cleared() { shapes.clear(); }
+
+    float getLevelHeight() const { return levelHeight; }
+    size_t shapesRebuilt() const { return rebuilt; }
+
+    /**
+     * Rebuilds the dirty shapes, then lays the trees of roots out left to
+     * right from (startX, startY) and calls, in preorder,
+     *   visit(node, x, y, parentIndex, shape, subtreeLeft, subtreeRight)
+     * where indices count visited nodes and parentIndex is -1 for roots.
+     */
+    template <typename Roots, typename Visit>
+    void place(const Roots& roots, float startX, float startY, Visit visit) {
+        float edge = startX;  // right edge of the trees placed so far
+        bool firstTree = true;
+        int next = 0;
+        for (const auto* root : roots) {
+            const Shape& shape = shapeOf(root);
+            // the first tree's leftmost node is centred on startX
+            float x = (firstTree ? startX - nodeRadius : edge + treeGap) - shape.minLeft();
+            firstTree = false;
+            edge = x + shape.maxRight();
+            placeSubtree(root, x, startY, -1, next, visit);
+        }
+    }
+};
+
+#endif // TIDY_TREE_LAYOUT_HPP
@@ -3,72 +3,216 @@
 
 #include <stdexcept>
 #include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
 
-template <typename T>
+/**
+ * Dynamic array on raw, uninitialized storage.
+ *
+ * The first InlineCapacity elements live inside the object itself, so
+ * short vectors (root lists, the degree table in consolidate) never touch
+ * the allocator; larger ones spill to storage obtained from Allocator.
+ * Elements are only constructed when they are added, and moved to new
+ * storage with move_if_noexcept, so a throwing copy during growth leaves
+ * the vector unchanged.
+ */
+template <typename T, size_t InlineCapacity = 16, typename Allocator = std::allocator<T>>
 class Vector {
 private:
-    T* data;
+    using Traits = std::allocator_traits<Allocator>;
+    static constexpr size_t INLINE_SLOTS = InlineCapacity > 0 ? InlineCapacity : 1;
+
+    Allocator alloc;
+    T* data_ptr;
     size_t capacity_size;
     size_t current_size;
+    alignas(T) unsigned char inline_buf[sizeof(T) * INLINE_SLOTS];
+
+    T* inlineData() { return reinterpret_cast<T*>(inline_buf); }
+    bool isInline() const { return data_ptr == reinterpret_cast<const T*>(inline_buf); }
+
+    void destroyRange(T* first, T* last) {
+        for (; first != last; ++first) Traits::destroy(alloc, first);
+    }
+
+    void freeStorage() {
+        if (!isInline()) Traits::deallocate(alloc, data_ptr, capacity_size);
+        data_ptr = inlineData();
+        capacity_size = INLINE_SLOTS;
+    }
 
     void reallocate(size_t new_cap) {
-        T* new_data = new T[new_cap];
-        for (size_t i = 0; i < current_size; ++i) {
-            new_data[i] = std::move(data[i]);
+        T* new_data = Traits::allocate(alloc, new_cap);
+        size_t built = 0;
+        try {
+            for (; built < current_size; ++built) {
+                Traits::construct(alloc, new_data + built, std::move_if_noexcept(data_ptr[built]));
+            }
+        } catch (...) {
+            destroyRange(new_data, new_data + built);
+            Traits::deallocate(alloc, new_data, new_cap);
+            throw;
         }
-        delete[] data;
-        data = new_data;
+        destroyRange(data_ptr, data_ptr + current_size);
+        if (!isInline()) Traits::deallocate(alloc, data_ptr, capacity_size);
+        data_ptr = new_data;
         capacity_size = new_cap;
     }
 
-public:
-    Vector() : data(nullptr), capacity_size(0), current_size(0) {
-        reallocate(2);
+    void growFor(size_t needed) {
+        if (needed > capacity_size) reallocate(std::max(needed, capacity_size * 2));
     }
 
-    // Constructor for specific size with default values (used in consolidate)
-    Vector(size_t n, const T& val = T()) : data(new T[n]), capacity_size(n), current_size(n) {
-        for (size_t i = 0; i < n; ++i) {
-            data[i] = val;
+    // takes other's heap buffer or moves its inline elements one by one
+    void takeFrom(Vector& other) {
+        if (other.isInline()) {
+            for (size_t i = 0; i < other.current_size; ++i) {
+                Traits::construct(alloc, data_ptr + i, std::move(other.data_ptr[i]));
+            }
+            current_size = other.current_size;
+            other.clear();
+        } else {
+            data_ptr = other.data_ptr;
+            capacity_size = other.capacity_size;
+            current_size = other.current_size;
+            other.data_ptr = other.inlineData();
+            other.capacity_size = INLINE_SLOTS;
+            other.current_size = 0;
         }
     }
 
+public:
+    explicit Vector(const Allocator& a = Allocator())
+        : alloc(a), data_ptr(inlineData()), capacity_size(INLINE_SLOTS), current_size(0) {}
+
+    // Constructor for specific size with default values (used in consolidate)
+    Vector(size_t n, const T& val = T(), const Allocator& a = Allocator()) : Vector(a) {
+        resize(n, val);
+    }
+
+    Vector(const Vector& other)
+        : Vector(Traits::select_on_container_copy_construction(other.alloc)) {
+        reserve(other.current_size);
+        for (size_t i = 0; i < other.current_size; ++i) emplace_back(other.data_ptr[i]);
+    }
+
+    Vector(Vector&& other) noexcept(std::is_nothrow_move_constructible<T>::value)
+        : Vector(other.alloc) {
+        takeFrom(other);
+    }
+
     ~Vector() {
-        delete[] data;
+        clear();
+        freeStorage();
+    }
+
+    Vector& operator=(const Vector& other) {
+        if (this == &other) return *this;
+        clear();
+        if (Traits::propagate_on_container_copy_assignment::value && alloc != other.alloc) {
+            freeStorage();
+            alloc = other.alloc;
+        }
+        reserve(other.current_size);
+        for (size_t i = 0; i < other.current_size; ++i) emplace_back(other.data_ptr[i]);
+        return *this;
+    }
+
+    // Unequal allocators that do not propagate force an element-wise move
+    // into newly allocated storage, which can throw
+    Vector& operator=(Vector&& other) noexcept(
+        (Traits::propagate_on_container_move_assignment::value || Traits::is_always_equal::value) &&
+        std::is_nothrow_move_constructible<T>::value) {
+        if (this == &other) return *this;
+        clear();
+        if (Traits::propagate_on_container_move_assignment::value || alloc == other.alloc) {
+            freeStorage();
+            if (Traits::propagate_on_container_move_assignment::value) alloc = std::move(other.alloc);
+            takeFrom(other);
+        } else {
+            // storage cannot change hands between unequal allocators
+            reserve(other.current_size);
+            for (size_t i = 0; i < other.current_size; ++i) emplace_back(std::move(other.data_ptr[i]));
+            other.clear();
+        }
+        return *this;
+    }
+
+    void reserve(size_t new_cap) {
+        if (new_cap > capacity_size) reallocate(new_cap);
     }
 
-    void push_back(const T& value) {
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
         if (current_size == capacity_size) {
+            // args may refer to an element of this vector, so build the
+            // new element before the old storage is released
+            T value(std::forward<Args>(args)...);
             reallocate(capacity_size * 2);
+            Traits::construct(alloc, data_ptr + current_size, std::move(value));
+        } else {
+            Traits::construct(alloc, data_ptr + current_size, std::forward<Args>(args)...);
         }
-        data[current_size++] = value;
+        return data_ptr[current_size++];
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    void pop_back() {
+        Traits::destroy(alloc, data_ptr + --current_size);
     }
 
     void resize(size_t new_size, const T& val = T()) {
+        if (new_size < current_size) {
+            destroyRange(data_ptr + new_size, data_ptr + current_size);
+            current_size = new_size;
+            return;
+        }
         if (new_size > capacity_size) {
-            reallocate(new_size);
+            T fill(val);  // val may live in the storage being replaced
+            growFor(new_size);
+            for (; current_size < new_size; ++current_size) {
+                Traits::construct(alloc, data_ptr + current_size, fill);
+            }
+            return;
         }
-        for (size_t i = current_size; i < new_size; ++i) {
-            data[i] = val;
+        for (; current_size < new_size; ++current_size) {
+            Traits::construct(alloc, data_ptr + current_size, val);
         }
-        current_size = new_size;
+    }
+
+    void clear() {
+        destroyRange(data_ptr, data_ptr + current_size);
+        current_size = 0;
     }
 
     T& operator[](size_t index) {
-        return data[index];
+        return data_ptr[index];
     }
 
     const T& operator[](size_t index) const {
-        return data[index];
+        return data_ptr[index];
     }
 
+    T& back() { return data_ptr[current_size - 1]; }
+    const T& back() const { return data_ptr[current_size - 1]; }
+
     size_t size() const { return current_size; }
+    size_t capacity() const { return capacity_size; }
+    bool empty() const { return current_size == 0; }
+    T* data() { return data_ptr; }
+    const T* data() const { return data_ptr; }
+    Allocator get_allocator() const { return alloc; }
 
     // Iterators for range-based for loops (used in consolidate)
-    T* begin() { return data; }
-    T* end() { return data + current_size; }
-    const T* begin() const { return data; }
-    const T* end() const { return data + current_size; }
+    T* begin() { return data_ptr; }
+    T* end() { return data_ptr + current_size; }
+    const T* begin() const { return data_ptr; }
+    const T* end() const { return data_ptr + current_size; }
 };
 
-#endif // VECTOR_HPP
\ No newline at end of file
+#endif // VECTOR_HPP
@@ -1,116 +1,207 @@
 #include "AnimationSystem.h"
+#include <algorithm>
+#include <utility>
 
 AnimationSystem::AnimationSystem(QObject* parent)
-    : QObject(parent), currentStep(-1), elapsedTime(0), isPlaying(false), animationSpeed(1) {
-    
+    : QObject(parent), sceneNodes(0), endTime(0.0), anchorTime(0.0), animationSpeed(1.0),
+      paused(false), running(false) {
+    // setSpeed() and seek() restart the clock before playback ever
+    // starts, and Qt leaves that undefined on a timer never started
+    clock.start();
+
     timer = new QTimer(this);
     timer->setInterval(16);  // ~60 FPS
     connect(timer, &QTimer::timeout, this, &AnimationSystem::onTimerTick);
 }
 
 AnimationSystem::~AnimationSystem() {
-    stop();
+    timer->stop();
 }
 
-void AnimationSystem::addStep(const AnimationStep& step) {
-    steps.push_back(step);
+double AnimationSystem::durationOf(const AnimationRecord& record) {
+    switch (record.type) {
+        case AnimationRecord::OPERATION: return 600;
+        case AnimationRecord::INSERT: return 300;
+        case AnimationRecord::EXTRACT: return 500;
+        case AnimationRecord::KEY_CHANGE: return 500;
+        case AnimationRecord::LINK: return 400;
+        case AnimationRecord::CUT: return 400;
+        case AnimationRecord::MARK: return 250;
+        case AnimationRecord::UNMARK: return 250;
+        case AnimationRecord::MERGE: return 500;
+        case AnimationRecord::CLEAR: return 500;
+        default: return 300;
+    }
 }
 
-void AnimationSystem::clearSteps() {
-    stop();
-    steps.clear();
-    currentStep = -1;
-    elapsedTime = 0;
+void AnimationSystem::append(HeapScenePtr scene) {
+    HeapScenePtr before = std::exchange(latest, scene);
+    const std::vector<AnimationRecord>& batch = scene->records;
+    if (batch.empty()) return;
+
+    // Consecutive spans share a scene as one's scene and the next's before
+    size_t nodes = scene->nodes.size();
+    if (before && (spans.empty() || spans.back().scene != before)) nodes += before->nodes.size();
+
+    if (records.size() + batch.size() > MAX_RECORDS || sceneNodes + nodes > MAX_SCENE_NODES) {
+        // Drop whole spans, the oldest half (or more) at once, so trimming
+        // stays amortized O(1)
+        size_t dropSpans = 0;
+        size_t droppedNodes = 0;
+        while (dropSpans < spans.size() &&
+               (dropSpans < (spans.size() + 1) / 2 ||
+                records.size() - spans[dropSpans].first + batch.size() > MAX_RECORDS ||
+                sceneNodes - droppedNodes + nodes > MAX_SCENE_NODES)) {
+            droppedNodes += spans[dropSpans++].nodes;
+        }
+        size_t drop = dropSpans < spans.size() ? spans[dropSpans].first : records.size();
+        records.erase(records.begin(), records.begin() + drop);
+        startTimes.erase(startTimes.begin(), startTimes.begin() + drop);
+        spans.erase(spans.begin(), spans.begin() + dropSpans);
+        for (Span& span : spans) span.first -= drop;
+        sceneNodes -= droppedNodes;
+        if (position() < startTime()) setPosition(startTime());
+    }
+
+    spans.push_back(Span{records.size(), std::move(scene), std::move(before), nodes});
+    sceneNodes += nodes;
+    for (const AnimationRecord& record : batch) {
+        records.push_back(record);
+        startTimes.push_back(endTime);
+        endTime += durationOf(record);
+    }
+
+    if (!paused && !running) start();
 }
 
-void AnimationSystem::play() {
-    if (steps.empty()) return;
-    
-    isPlaying = true;
-    currentStep = 0;
-    elapsedTime = 0;
+void AnimationSystem::clear() {
+    timer->stop();
+    records.clear();
+    startTimes.clear();
+    spans.clear();
+    sceneNodes = 0;
+    anchorTime = endTime;
+    running = false;
+    emit animationUpdate();
+}
+
+double AnimationSystem::position() const {
+    if (!running) return anchorTime;
+    double elapsed = static_cast<double>(clock.nsecsElapsed()) / 1e6;
+    return std::min(endTime, anchorTime + elapsed * animationSpeed);
+}
+
+void AnimationSystem::setPosition(double time) {
+    anchorTime = std::clamp(time, startTime(), endTime);
+    clock.restart();
+}
+
+void AnimationSystem::start() {
+    if (anchorTime >= endTime) return;
+    clock.restart();
+    running = true;
     timer->start();
     emit animationStarted();
-    emit animationStepChanged(currentStep);
 }
 
 void AnimationSystem::pause() {
-    if (isPlaying) {
-        isPlaying = false;
-        timer->stop();
-    }
+    if (paused) return;
+    anchorTime = position();
+    paused = true;
+    running = false;
+    timer->stop();
+    emit animationUpdate();
 }
 
 void AnimationSystem::resume() {
-    if (!isPlaying && currentStep >= 0 && currentStep < static_cast<int>(steps.size())) {
-        isPlaying = true;
-        timer->start();
-    }
+    if (!paused) return;
+    paused = false;
+    start();
 }
 
-void AnimationSystem::stop() {
-    isPlaying = false;
-    timer->stop();
-    currentStep = -1;
-    elapsedTime = 0;
+void AnimationSystem::seek(double time) {
+    setPosition(time);
+    if (!paused && !running) start();
+    emit animationUpdate();
+}
+
+void AnimationSystem::skipOperation() {
+    double now = position();
+    size_t i = static_cast<size_t>(std::upper_bound(startTimes.begin(), startTimes.end(), now) - startTimes.begin());
+    while (i < records.size() && records[i].type != AnimationRecord::OPERATION) ++i;
+    seek(i < records.size() ? startTimes[i] : endTime);
+}
+
+void AnimationSystem::skipToEnd() {
+    seek(endTime);
 }
 
-void AnimationSystem::setSpeed(int speed) {
-    animationSpeed = std::max(1, std::min(3, speed));
+void AnimationSystem::setSpeed(double speed) {
+    // Restart the clock from here, so the position does not jump
+    anchorTime = position();
+    clock.restart();
+    animationSpeed = std::clamp(speed, MIN_SPEED, MAX_SPEED);
 }
 
-float AnimationSystem::getCurrentProgress() const {
-    if (currentStep < 0 || currentStep >= static_cast<int>(steps.size())) {
-        return 0.0f;
+AnimationFrame AnimationSystem::currentFrame() const {
+    AnimationFrame frame;
+    double now = position();
+    if (records.empty() || now >= endTime) return frame;
+
+    auto it = std::upper_bound(startTimes.begin(), startTimes.end(), now);
+    if (it == startTimes.begin()) return frame;
+    size_t i = static_cast<size_t>(it - startTimes.begin()) - 1;
+
+    frame.record = &records[i];
+    frame.progress = static_cast<float>(std::min(1.0, (now - startTimes[i]) / durationOf(records[i])));
+
+    auto span = std::upper_bound(spans.begin(), spans.end(), i,
+        [](size_t index, const Span& s) { return index < s.first; });
+    if (span != spans.begin()) {
+        --span;
+        frame.scene = span->scene;
+        frame.before = span->before;
     }
-    
-    const AnimationStep& step = steps[currentStep];
-    if (step.duration == 0) return 1.0f;
-    
-    float progress = static_cast<float>(elapsedTime) / static_cast<float>(step.duration);
-    return std::min(1.0f, progress);
+    return frame;
 }
 
-const AnimationStep* AnimationSystem::getCurrentStep() const {
-    if (currentStep >= 0 && currentStep < static_cast<int>(steps.size())) {
-        return &steps[currentStep];
+QString AnimationSystem::describe(const AnimationRecord& record) {
+    switch (record.type) {
+        case AnimationRecord::OPERATION:
+            switch (record.operation) {
+                case AnimationRecord::OP_INSERT: return QString("Insert %1").arg(record.key);
+                case AnimationRecord::OP_INSERT_RANDOM: return QString("Insert %1 random values").arg(record.key);
+                case AnimationRecord::OP_EXTRACT_MIN: return "Extract min";
+                case AnimationRecord::OP_DECREASE_KEY: return QString("Decrease key to %1").arg(record.key);
+                case AnimationRecord::OP_DELETE: return QString("Delete %1").arg(record.key);
+                case AnimationRecord::OP_MERGE: return "Union with new heap";
+                case AnimationRecord::OP_RESET: return "Reset";
+                default: return QString();
+            }
+        case AnimationRecord::INSERT: return QString("%1 added as a root").arg(record.key);
+        case AnimationRecord::EXTRACT: return QString("%1 removed").arg(record.key);
+        case AnimationRecord::KEY_CHANGE: return QString("Key %1 lowered to %2").arg(record.otherKey).arg(record.key);
+        case AnimationRecord::LINK: return QString("%1 linked under %2").arg(record.key).arg(record.otherKey);
+        case AnimationRecord::CUT: return QString("%1 cut from %2").arg(record.key).arg(record.otherKey);
+        case AnimationRecord::MARK: return QString("%1 marked").arg(record.key);
+        case AnimationRecord::UNMARK: return QString("%1 unmarked").arg(record.key);
+        case AnimationRecord::MERGE: return "Root lists merged";
+        case AnimationRecord::CLEAR: return "All nodes removed";
+        default: return QString();
     }
-    return nullptr;
 }
 
 void AnimationSystem::onTimerTick() {
-    if (!isPlaying || currentStep < 0 || currentStep >= static_cast<int>(steps.size())) {
-        return;
-    }
-    
-    const AnimationStep& step = steps[currentStep];
-    
-    // Increment elapsed time based on speed
-    elapsedTime += 16 * animationSpeed;
-    
+    if (!running) return;
+
     // Emit update for smooth animation
     emit animationUpdate();
-    
-    // Check if current step is complete
-    if (elapsedTime >= step.duration) {
-        // Execute callback if present
-        if (step.callback) {
-            step.callback();
-        }
-        
-        nextStep();
-    }
-}
 
-void AnimationSystem::nextStep() {
-    currentStep++;
-    elapsedTime = 0;
-    
-    if (currentStep >= static_cast<int>(steps.size())) {
-        // Animation complete
-        stop();
+    if (position() >= endTime) {
+        // Caught up: wait for more records
+        anchorTime = endTime;
+        running = false;
+        timer->stop();
         emit animationCompleted();
-    } else {
-        emit animationStepChanged(currentStep);
     }
 }
@@ -0,0 +1,309 @@
+#include "HeapWorker.h"
+#include "HeapReclaimer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <functional>
+#include <utility>
+
+namespace {
+
+// Longest change lists a scene carries; longer ones are merged down
+constexpr size_t MAX_CHANGES = 256;
+// How far the node outlines and lines reach beyond their geometry
+constexpr float PEN_REACH = 2.0f;
+
+void mergeInto(QRectF& into, const QRectF& area) { into = into.united(area); }
+
+void mergeInto(HeapScene::ShapeChange& into, const HeapScene::ShapeChange& shape) {
+    into.area = into.area.united(shape.area);
+    into.extent = std::min(into.extent, shape.extent);
+}
+
+// Appends to a list of at most MAX_CHANGES entries. Past that, entries
+// added one after another are merged, and as the scene is walked in
+// preorder those lie close together, so the merged ones stay small where
+// few nodes changed.
+template <typename Change>
+class ChangeList {
+    std::vector<Change>& list;
+    size_t perEntry = 1;  // changes merged into each entry
+    size_t inLast = 0;    // changes merged into the last entry so far
+public:
+    explicit ChangeList(std::vector<Change>& out) : list(out) { list.clear(); }
+    void add(const Change& change) {
+        if (inLast == 0) list.push_back(change);
+        else mergeInto(list.back(), change);
+        if (++inLast < perEntry) return;
+        inLast = 0;
+        if (list.size() < MAX_CHANGES) return;
+        for (size_t i = 0; i < MAX_CHANGES / 2; ++i) {
+            list[i] = list[i * 2];
+            mergeInto(list[i], list[i * 2 + 1]);
+        }
+        list.resize(MAX_CHANGES / 2);
+        perEntry *= 2;
+    }
+};
+
+} // namespace
+
+HeapWorker::HeapWorker(QObject* parent)
+    : QObject(parent), version(0), publishQueued(false),
+      random(std::random_device{}()), pendingInserts(0), bulkInserted(0) {
+    sincePublish.start();
+}
+
+void HeapWorker::changed() {
+    version++;
+    // Posted behind the commands already queued, so a burst of them is
+    // published as one scene
+    if (publishQueued) return;
+    publishQueued = true;
+    QMetaObject::invokeMethod(this, &HeapWorker::publish, Qt::QueuedConnection);
+}
+
+void HeapWorker::publish() {
+    publishQueued = false;
+    // While random inserts are running, every chunk asks for a scene;
+    // send them at a rate the GUI can lay eyes on. The last chunk always
+    // publishes, since nothing is pending by then.
+    if (pendingInserts > 0 && sincePublish.elapsed() < PUBLISH_INTERVAL_MS) return;
+    sincePublish.restart();
+
+    std::shared_ptr<HeapScene> scene = layOut(heap, version);
+    scene->records = heap.getObserver().takeRecords();
+    if (published) noteChanges(*scene, *published);
+    published = scene;
+    emit sceneReady(std::move(scene));
+}
+
+std::shared_ptr<HeapScene> HeapWorker::layOut(VisualHeap& heap, uint64_t version) {
+    QElapsedTimer timer;
+    timer.start();
+
+    auto scene = std::make_shared<HeapScene>();
+    scene->version = version;
+    scene->nodes.reserve(static_cast<size_t>(heap.getSize()));
+
+    float startX = 150;
+    float startY = 100;
+    float levelHeight = heap.getObserver().getLevelHeight();
+    float radius = HeapScene::NODE_RADIUS;
+
+    // Only the subtrees the heap reported as changed are laid out again;
+    // every other node is placed from its cached subtree shape
+    std::vector<HeapScene::Node>& nodes = scene->nodes;
+    heap.getObserver().place(heap.roots(), startX, startY,
+        [&](const VisualHeap::Node* node, float x, float y, int parent,
+            const TidyTreeLayout::Shape& shape, float left, float right) {
+            int index = static_cast<int>(nodes.size());
+            QRectF bounds(left, y - radius, right - left,
+                          (shape.height() - 1) * levelHeight + radius * 2);
+            nodes.push_back(HeapScene::Node{node, QPointF(x, y), parent, index + 1, bounds,
+                                            node->key, node->value, node->degree, node->marked});
+        });
+
+    // In preorder a subtree ends where its last descendant's entry ends
+    for (int i = static_cast<int>(nodes.size()) - 1; i > 0; --i) {
+        int parent = nodes[i].parent;
+        if (parent >= 0) nodes[parent].end = std::max(nodes[parent].end, nodes[i].end);
+    }
+
+    // roots() starts at the minimum
+    scene->minIndex = nodes.empty() ? -1 : 0;
+    scene->indexNodes();
+    scene->layoutMs = static_cast<double>(timer.nsecsElapsed()) / 1e6;
+    return scene;
+}
+
+void HeapWorker::noteChanges(HeapScene& scene, const HeapScene& previous) {
+    // Match the entries of the two scenes by id, walking both id indices
+    std::vector<int> match(scene.nodes.size(), -1);  // entry in previous
+    std::vector<bool> kept(previous.nodes.size(), false);
+    std::less<const void*> before;
+    for (size_t a = 0, b = 0; a < previous.byId.size() && b < scene.byId.size();) {
+        const void* oldId = previous.nodes[previous.byId[a]].id;
+        const void* newId = scene.nodes[scene.byId[b]].id;
+        if (before(oldId, newId)) {
+            a++;
+        } else if (before(newId, oldId)) {
+            b++;
+        } else {
+            match[scene.byId[b++]] = static_cast<int>(previous.byId[a]);
+            kept[previous.byId[a++]] = true;
+        }
+    }
+
+    ChangeList<QRectF> areas(scene.changedAreas);
+    ChangeList<HeapScene::ShapeChange> shapes(scene.changedShapes);
+    // A node's circle and the line from its parent
+    auto addNode = [&](const HeapScene& in, int index) {
+        const HeapScene::Node& node = in.nodes[index];
+        float reach = HeapScene::NODE_RADIUS + PEN_REACH;
+        areas.add(QRectF(node.pos.x() - reach, node.pos.y() - reach, reach * 2, reach * 2));
+        if (node.parent >= 0) {
+            QRectF line = QRectF(in.nodes[node.parent].pos, node.pos).normalized();
+            areas.add(line.adjusted(-PEN_REACH, -PEN_REACH, PEN_REACH, PEN_REACH));
+        }
+    };
+    // Only subtrees with children are ever drawn as a glyph
+    auto addShape = [&](const HeapScene::Node* old, bool hadChildren,
+                        const HeapScene::Node* now, bool hasChildren) {
+        HeapScene::ShapeChange change{QRectF(), HUGE_VALF};
+        for (auto [node, children] : {std::pair(old, hadChildren), std::pair(now, hasChildren)}) {
+            if (!node || !children) continue;
+            change.area = change.area.united(node->bounds);
+            change.extent = std::min(change.extent, static_cast<float>(
+                std::max(node->bounds.width(), node->bounds.height())));
+        }
+        if (!change.area.isNull()) shapes.add(change);
+    };
+    auto parentId = [](const HeapScene& in, const HeapScene::Node& node) {
+        return node.parent >= 0 ? in.nodes[node.parent].id : nullptr;
+    };
+
+    for (int i = 0; i < scene.size(); ++i) {
+        const HeapScene::Node& node = scene.nodes[i];
+        bool hasChildren = node.end > i + 1;
+        int j = match[i];
+        if (j < 0) {
+            addNode(scene, i);
+            addShape(nullptr, false, &node, hasChildren);
+            continue;
+        }
+        const HeapScene::Node& old = previous.nodes[j];
+        bool hadChildren = old.end > j + 1;
+        bool redrawn = old.pos != node.pos || old.key != node.key || old.marked != node.marked ||
+                       (j == previous.minIndex) != (i == scene.minIndex) ||
+                       parentId(previous, old) != parentId(scene, node) ||
+                       (node.parent >= 0 && previous.nodes[old.parent].pos != scene.nodes[node.parent].pos);
+        if (redrawn) {
+            addNode(previous, j);
+            addNode(scene, i);
+        }
+        if (old.bounds != node.bounds || hadChildren != hasChildren) {
+            addShape(&old, hadChildren, &node, hasChildren);
+        }
+    }
+    for (int j = 0; j < previous.size(); ++j) {
+        if (kept[j]) continue;
+        addNode(previous, j);
+        addShape(&previous.nodes[j], previous.nodes[j].end > j + 1, nullptr, false);
+    }
+
+    scene.changesSince = previous.version;
+    scene.hasChanges = true;
+}
+
+VisualHeap::Node* HeapWorker::nodeFor(const void* id, quint64 sceneVersion) {
+    // Every node of an up-to-date scene is alive; an older scene may name
+    // nodes that have been freed since
+    if (!id || sceneVersion != version) return nullptr;
+    return static_cast<VisualHeap::Node*>(const_cast<void*>(id));
+}
+
+void HeapWorker::insert(int value) {
+    heap.getObserver().beginOperation(AnimationRecord::OP_INSERT, value);
+    heap.insert(value, value);  // Use value as both value and key
+    changed();
+    emit commandDone(QString("Inserted: %1").arg(value));
+}
+
+void HeapWorker::insertRandom(int count) {
+    if (count <= 0) return;
+    bool running = pendingInserts > 0;
+    pendingInserts += count;
+    // A run already in progress picks the new inserts up
+    heap.getObserver().beginOperation(AnimationRecord::OP_INSERT_RANDOM, count);
+    if (!running) {
+        bulkInserted = 0;
+        continueInsertRandom();
+    }
+}
+
+void HeapWorker::continueInsertRandom() {
+    if (pendingInserts <= 0) return;  // cancelled by reset()
+
+    // One chunk per event, so commands queued meanwhile are not held up
+    // behind the whole run. The run is recorded as a single operation:
+    // a million new roots are not worth watching one by one.
+    std::uniform_int_distribution<int> keys(0, RANDOM_KEY_RANGE);
+    long long chunk = std::min<long long>(pendingInserts, BULK_CHUNK);
+    heap.getObserver().setRecording(false);
+    for (long long i = 0; i < chunk; ++i) {
+        int value = keys(random);
+        heap.insert(value, value);
+    }
+    heap.getObserver().setRecording(true);
+    pendingInserts -= chunk;
+    bulkInserted += chunk;
+    changed();
+
+    if (pendingInserts > 0) {
+        QMetaObject::invokeMethod(this, &HeapWorker::continueInsertRandom, Qt::QueuedConnection);
+    } else {
+        emit commandDone(QString("Inserted %1 random values").arg(bulkInserted));
+    }
+}
+
+void HeapWorker::extractMin() {
+    if (heap.isEmpty()) {
+        emit commandDone("Heap is empty");
+        return;
+    }
+    heap.getObserver().beginOperation(AnimationRecord::OP_EXTRACT_MIN);
+    auto* extracted = heap.extractMin();
+    int key = extracted->key;
+    heap.release(extracted);
+    changed();
+    emit commandDone(QString("Extracted min: %1").arg(key));
+}
+
+void HeapWorker::decreaseKey(const void* id, int newKey, quint64 sceneVersion) {
+    VisualHeap::Node* node = nodeFor(id, sceneVersion);
+    if (!node) {
+        emit commandDone("The heap changed since the node was selected - please select it again");
+        return;
+    }
+    try {
+        heap.getObserver().beginOperation(AnimationRecord::OP_DECREASE_KEY, newKey);
+        heap.decreaseKey(node, newKey);
+        changed();
+        emit commandDone(QString("Decreased key to %1").arg(newKey));
+    } catch (const std::exception& e) {
+        emit commandDone(QString("Error: %1").arg(e.what()));
+    }
+}
+
+void HeapWorker::deleteNode(const void* id, quint64 sceneVersion) {
+    VisualHeap::Node* node = nodeFor(id, sceneVersion);
+    if (!node) {
+        emit commandDone("The heap changed since the node was selected - please select it again");
+        return;
+    }
+    int key = node->key;
+    heap.getObserver().beginOperation(AnimationRecord::OP_DELETE, key);
+    heap.deleteNode(node);
+    changed();
+    emit commandDone(QString("Deleted node with key %1").arg(key));
+}
+
+void HeapWorker::merge(const std::vector<int>& keys) {
+    VisualHeap other;
+    for (int key : keys) other.insert(key, key);
+    heap.getObserver().beginOperation(AnimationRecord::OP_MERGE);
+    heap.merge(other);
+    changed();
+    emit commandDone(QString("Merged with new heap containing %1 nodes").arg(keys.size()));
+}
+
+void HeapWorker::reset() {
+    pendingInserts = 0;  // stops a random insert run after its current chunk
+    heap.getObserver().beginOperation(AnimationRecord::OP_RESET);
+    // Millions of nodes are freed on the reclaimer thread, so commands
+    // queued behind the reset are not held up
+    HeapReclaimer::instance().post(heap.detach());
+    changed();
+    emit commandDone("Heap reset - Ready to insert new values");
+}
@@ -11,137 +11,366 @@
 #include <QPainterPath>
 #include <cmath>
 #include <algorithm>
+#include <iterator>
 
 // UI Constants
 namespace {
     constexpr int TITLE_FONT_SIZE = 18;
     constexpr int EMPTY_HEAP_FONT_SIZE = 16;
     constexpr int NODE_TEXT_FONT_SIZE = 11;
+    constexpr int CAPTION_FONT_SIZE = 12;
+
+    // Playback speed is 2^(value / SPEED_STEPS_PER_DOUBLING) times MIN_SPEED
+    constexpr double MIN_SPEED = 0.25;
+    constexpr int SPEED_STEPS_PER_DOUBLING = 4;
+    constexpr int SPEED_SLIDER_MAX = 56;      // 4096x
+    constexpr int SPEED_SLIDER_DEFAULT = 8;   // 1x
+    constexpr int SCRUB_STEPS = 1000;
+
+    double speedFor(int sliderValue) {
+        return MIN_SPEED * std::pow(2.0, sliderValue / double(SPEED_STEPS_PER_DOUBLING));
+    }
+
+    QColor animationColor(AnimationRecord::Type type) {
+        switch (type) {
+            case AnimationRecord::INSERT: return QColor(46, 204, 113);
+            case AnimationRecord::LINK: return QColor(39, 174, 96);
+            case AnimationRecord::EXTRACT:
+            case AnimationRecord::CLEAR: return QColor(220, 20, 60);
+            case AnimationRecord::CUT: return QColor(231, 76, 60);
+            case AnimationRecord::KEY_CHANGE: return QColor(52, 152, 219);
+            case AnimationRecord::MARK:
+            case AnimationRecord::UNMARK: return QColor(255, 140, 0);
+            case AnimationRecord::MERGE: return QColor(147, 112, 219);
+            default: return QColor(120, 120, 120);
+        }
+    }
 }
 
 // =====================================================================
 // HeapCanvas Implementation
 // =====================================================================
 
-HeapCanvas::HeapCanvas(FibonacciHeap<int>* h, AnimationSystem* anim, QWidget* parent)
-    : QWidget(parent), heap(h), animationSystem(anim), 
-      selectedNode(nullptr), highlightedNode(nullptr) {
+HeapCanvas::HeapCanvas(AnimationSystem* anim, QWidget* parent)
+    : QWidget(parent), scene(std::make_shared<HeapScene>()), latest(scene), animationSystem(anim), 
+      selectedId(nullptr), highlightedId(nullptr), selectedIndex(-1), highlightedIndex(-1),
+      zoom(1.0f), dragging(false), frameSamples(), frameCount(0), showFrameStats(false),
+      lastAnimationMs(0.0f) {
     setMinimumSize(1400, 700);
     setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
     setMouseTracking(true);
 }
 
+void HeapCanvas::setScene(HeapScenePtr newScene) {
+    latest = std::move(newScene);
+    // A node that has left the heap is deselected for good, as its id may
+    // be reused; older scenes shown during playback only hide the selection
+    if (latest->indexOf(selectedId) < 0) selectedId = nullptr;
+    if (latest->indexOf(highlightedId) < 0) highlightedId = nullptr;
+    locateSelection();
+    update();
+}
+
+void HeapCanvas::showScene(const HeapScenePtr& shown) {
+    if (shown == scene) return;
+    // Following the worker's scenes one by one, only the tiles the changes
+    // reach are drawn again; jumping between scenes redraws them all
+    if (shown->hasChanges && shown->changesSince == scene->version) {
+        invalidateTiles(*shown);
+    } else {
+        invalidateTiles();
+    }
+    scene = shown;
+    locateSelection();
+}
+
+void HeapCanvas::locateSelection() {
+    selectedIndex = scene->indexOf(selectedId);
+    highlightedIndex = scene->indexOf(highlightedId);
+}
+
+void HeapCanvas::invalidateTiles() {
+    tiles.clear();
+}
+
+void HeapCanvas::invalidateTiles(const HeapScene& next) {
+    float extent = TILE_SIZE / zoom;
+    float blend = 1.0f / zoom;  // antialiased edges spill into the next pixel
+    auto stale = [&](const QRectF& area) {
+        for (const QRectF& changed : next.changedAreas) {
+            if (changed.intersects(area)) return true;
+        }
+        for (const HeapScene::ShapeChange& shape : next.changedShapes) {
+            if (shape.extent * zoom < SUMMARY_EXTENT && shape.area.intersects(area)) return true;
+        }
+        return false;
+    };
+    for (auto it = tiles.begin(); it != tiles.end();) {
+        int column = static_cast<int32_t>(it->first >> 32);
+        int row = static_cast<int32_t>(static_cast<uint32_t>(it->first));
+        QRectF area(column * extent - blend, row * extent - blend, extent + blend * 2, extent + blend * 2);
+        it = stale(area) ? tiles.erase(it) : std::next(it);
+    }
+}
+
+QPointF HeapCanvas::toLayout(const QPointF& screenPos) const {
+    return (screenPos - QPointF(pan)) / zoom;
+}
+
 void HeapCanvas::paintEvent(QPaintEvent* event) {
+    QElapsedTimer paintTimer;
+    paintTimer.start();
     QPainter painter(this);
-    painter.setRenderHint(QPainter::Antialiasing);
     
     // Clean white background
     painter.fillRect(rect(), Qt::white);
+
+    // The playback position is read once per frame, from the clock, and
+    // decides which scene is drawn
+    AnimationFrame frame = animationSystem->currentFrame();
+    showScene(frame.scene ? frame.scene : latest);
     
-    if (heap->isEmpty()) {
+    if (scene->empty()) {
+        painter.setRenderHint(QPainter::Antialiasing);
         painter.setPen(Qt::gray);
         QFont font = painter.font();
         font.setPointSize(EMPTY_HEAP_FONT_SIZE);
         painter.setFont(font);
         painter.drawText(rect(), Qt::AlignCenter, "Heap is empty - Click Insert to add nodes");
-        return;
+        drawCaption(painter, frame);
+        lastAnimationMs = 0.0f;
+    } else {
+        drawHeap(painter, event->rect(), frame);
     }
-    
-    calculateNodePositions();
-    
-    // Draw pointer lines (sibling relationships)
-    drawPointerLines(painter);
-    
-    // Draw parent-child connections
-    drawConnections(painter);
-    
-    // Draw nodes
-    for (const auto& [node, pos] : nodePositions) {
-        drawNode(painter, node, pos.x(), pos.y(), node->parent == nullptr);
+
+    if (showFrameStats) {
+        FrameSample& sample = frameSamples[frameCount++ % FRAME_SAMPLES];
+        sample.paintMs = static_cast<float>(paintTimer.nsecsElapsed() / 1e6);
+        sample.animationMs = lastAnimationMs;
+        sample.intervalMs = static_cast<float>(sinceLastFrame.restart());
+        drawFrameStats(painter);
     }
 }
 
-void HeapCanvas::calculateNodePositions() {
-    nodePositions.clear();
-    
-    if (heap->isEmpty()) return;
-    
-    Vector<FibonacciHeap<int>::Node*> roots = heap->getRootList();
-    
-    float startX = 150;
-    float startY = 100;
-    float currentX = startX;
-    
-    for (size_t i = 0; i < roots.size(); ++i) {
-        float maxX = currentX;
-        positionSubtree(roots[i], currentX, startY, maxX, 0);
-        currentX = maxX + HORIZONTAL_SPACING * 1.5f;
+void HeapCanvas::drawHeap(QPainter& painter, const QRect& exposedRect, const AnimationFrame& frame) {
+    // Blit the cached tiles covering the exposed area; only missing tiles
+    // are rendered, and those only draw the subtrees that reach into them
+    QRect exposed = exposedRect.translated(-pan);
+    int firstColumn = static_cast<int>(std::floor(exposed.left() / double(TILE_SIZE)));
+    int lastColumn = static_cast<int>(std::floor(exposed.right() / double(TILE_SIZE)));
+    int firstRow = static_cast<int>(std::floor(exposed.top() / double(TILE_SIZE)));
+    int lastRow = static_cast<int>(std::floor(exposed.bottom() / double(TILE_SIZE)));
+
+    size_t visibleTiles = static_cast<size_t>(lastColumn - firstColumn + 1) * static_cast<size_t>(lastRow - firstRow + 1);
+    if (tiles.size() + visibleTiles > MAX_TILES) invalidateTiles();
+
+    for (int row = firstRow; row <= lastRow; ++row) {
+        for (int column = firstColumn; column <= lastColumn; ++column) {
+            painter.drawPixmap(QPoint(column * TILE_SIZE, row * TILE_SIZE) + pan, tileAt(column, row));
+        }
     }
+
+    // Selection and highlight change without the heap, so they are drawn
+    // over the tiles instead of into them
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.translate(pan);
+    painter.scale(zoom, zoom);
+    for (int index : {highlightedIndex, selectedIndex}) {
+        if (index >= 0) drawNode(painter, index, true);
+    }
+
+    QElapsedTimer animationTimer;
+    animationTimer.start();
+    if (frame.record) drawAnimation(painter, frame);
+    painter.resetTransform();
+    drawCaption(painter, frame);
+    lastAnimationMs = static_cast<float>(animationTimer.nsecsElapsed() / 1e6);
 }
 
-void HeapCanvas::positionSubtree(FibonacciHeap<int>::Node* node, float x, float y, float& maxX, int depth) {
-    if (!node) return;
-    
-    nodePositions[node] = QPointF(x, y);
-    maxX = std::max(maxX, x);
-    
-    // Position children
-    if (node->child) {
-        FibonacciHeap<int>::Node* child = node->child;
-        FibonacciHeap<int>::Node* start = child;
-        
-        // Count children
-        int childCount = 0;
-        FibonacciHeap<int>::Node* temp = child;
-        do {
-            childCount++;
-            temp = temp->right;
-        } while (temp != start);
-        
-        // Calculate spacing
-        float totalChildWidth = (childCount - 1) * SIBLING_SPACING;
-        float childX = x - totalChildWidth / 2.0f;
-        
-        do {
-            positionSubtree(child, childX, y + VERTICAL_SPACING, maxX, depth + 1);
-            childX += SIBLING_SPACING;
-            child = child->right;
-        } while (child != start);
-    }
-}
-
-void HeapCanvas::drawConnections(QPainter& painter) {
-    // Simple line connections without arrows for cleaner look
-    QPen pen(QColor(150, 150, 150), 1.5);
-    painter.setPen(pen);
-    
-    for (const auto& [node, pos] : nodePositions) {
-        if (node->child) {
-            // Draw simple lines to children
-            FibonacciHeap<int>::Node* child = node->child;
-            FibonacciHeap<int>::Node* start = child;
-            do {
-                if (nodePositions.find(child) != nodePositions.end()) {
-                    QPointF childPos = nodePositions[child];
-                    painter.drawLine(pos, childPos);
-                }
-                child = child->right;
-            } while (child != start);
+void HeapCanvas::drawFrameStats(QPainter& painter) {
+    size_t count = std::min(frameCount, FRAME_SAMPLES);
+    float paintSum = 0, paintMax = 0, animationSum = 0, animationMax = 0, intervalSum = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const FrameSample& sample = frameSamples[i];
+        paintSum += sample.paintMs;
+        paintMax = std::max(paintMax, sample.paintMs);
+        animationSum += sample.animationMs;
+        animationMax = std::max(animationMax, sample.animationMs);
+        intervalSum += sample.intervalMs;
+    }
+    // The first interval is measured from an unstarted clock
+    float intervalAverage = count > 1 ? intervalSum / count : 0;
+
+    QString text = QString("%1 nodes, last %2 frames (avg / max)\n"
+                           "layout     %3 ms (worker, last scene)\n"
+                           "paint      %4 / %5 ms\n"
+                           "animation  %6 / %7 ms\n"
+                           "repaints   %8 per s")
+        .arg(scene->size()).arg(count)
+        .arg(scene->layoutMs, 0, 'f', 2)
+        .arg(paintSum / count, 0, 'f', 2).arg(paintMax, 0, 'f', 2)
+        .arg(animationSum / count, 0, 'f', 2).arg(animationMax, 0, 'f', 2)
+        .arg(intervalAverage > 0 ? 1000.0f / intervalAverage : 0.0f, 0, 'f', 0);
+
+    painter.resetTransform();
+    QFont font("Monospace");
+    font.setStyleHint(QFont::TypeWriter);
+    font.setPointSize(9);
+    painter.setFont(font);
+    QRect box = painter.fontMetrics().boundingRect(QRect(0, 0, width(), height()), Qt::AlignLeft, text)
+                    .adjusted(-6, -4, 6, 4);
+    box.moveBottomLeft(QPoint(10, height() - 10));
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QColor(0, 0, 0, 170));
+    painter.drawRect(box);
+    painter.setPen(Qt::white);
+    painter.drawText(box.adjusted(6, 4, -6, -4), Qt::AlignLeft, text);
+}
+
+void HeapCanvas::setFrameStatsVisible(bool visible) {
+    showFrameStats = visible;
+    frameCount = 0;
+    sinceLastFrame.start();
+    update();
+}
+
+void HeapCanvas::zoomToFit() {
+    if (scene->empty()) return;
+    QRectF extent;
+    for (int i = 0; i < scene->size(); i = scene->nodes[i].end) {
+        extent = extent.united(scene->nodes[i].bounds);
+    }
+    extent.adjust(-NODE_RADIUS, -NODE_RADIUS, NODE_RADIUS, NODE_RADIUS);
+    float fit = static_cast<float>(std::min(width() / extent.width(), height() / extent.height()));
+    zoom = std::clamp(fit, MIN_ZOOM, MAX_ZOOM);
+    pan = (QPointF(width(), height()) / 2 - extent.center() * zoom).toPoint();
+    invalidateTiles();
+    update();
+}
+
+void HeapCanvas::drawAnimation(QPainter& painter, const AnimationFrame& frame) {
+    // Records name nodes by id. A node the operation removed is only in
+    // the scene before it, and is ringed where it was drawn there.
+    auto locate = [&](const void* id, QPointF& pos) {
+        for (const HeapScene* in : {scene.get(), frame.before.get()}) {
+            int index = in ? in->indexOf(id) : -1;
+            if (index >= 0) {
+                pos = in->nodes[index].pos;
+                return true;
+            }
         }
+        return false;
+    };
+    const AnimationRecord& record = *frame.record;
+    QPointF nodePos, otherPos;
+    bool hasNode = locate(record.node, nodePos);
+    bool hasOther = locate(record.other, otherPos);
+    float t = frame.progress;
+    QColor color = animationColor(record.type);
+    color.setAlphaF(1.0f - 0.7f * t);
+
+    painter.setBrush(Qt::NoBrush);
+    if (hasNode && hasOther) {
+        // The edge grows in for a link and drains away for a cut
+        float reach = record.type == AnimationRecord::CUT ? 1.0f - t : t;
+        painter.setPen(QPen(color, 4));
+        painter.drawLine(otherPos, otherPos + (nodePos - otherPos) * reach);
+        painter.drawEllipse(otherPos, NODE_RADIUS + 4, NODE_RADIUS + 4);
+    }
+    if (hasNode) {
+        float radius = NODE_RADIUS + 4 + 12 * t;
+        painter.setPen(QPen(color, 4));
+        painter.drawEllipse(nodePos, radius, radius);
+    }
+}
+
+void HeapCanvas::drawCaption(QPainter& painter, const AnimationFrame& frame) {
+    if (!frame.record) return;
+    QString text = AnimationSystem::describe(*frame.record);
+    if (text.isEmpty()) return;
+
+    QFont font = painter.font();
+    font.setPointSize(CAPTION_FONT_SIZE);
+    font.setBold(frame.record->type == AnimationRecord::OPERATION);
+    painter.setFont(font);
+    QRect box = painter.fontMetrics().boundingRect(text).adjusted(-8, -4, 8, 4);
+    box.moveTopLeft(QPoint(10, 10));
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QColor(255, 255, 255, 220));
+    painter.drawRoundedRect(box, 3, 3);
+    painter.setPen(animationColor(frame.record->type).darker(130));
+    painter.drawText(box, Qt::AlignCenter, text);
+}
+
+const QPixmap& HeapCanvas::tileAt(int column, int row) {
+    uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(column)) << 32) | static_cast<uint32_t>(row);
+    auto it = tiles.find(key);
+    if (it != tiles.end()) return it->second;
+
+    qreal ratio = devicePixelRatioF();
+    QPixmap tile(QSize(TILE_SIZE, TILE_SIZE) * ratio);
+    tile.setDevicePixelRatio(ratio);
+    tile.fill(Qt::white);
+
+    QPainter painter(&tile);
+    painter.translate(-column * TILE_SIZE, -row * TILE_SIZE);
+    painter.scale(zoom, zoom);
+    QRectF area(column * TILE_SIZE / zoom, row * TILE_SIZE / zoom, TILE_SIZE / zoom, TILE_SIZE / zoom);
+    drawScene(painter, area);
+    painter.end();
+
+    return tiles.emplace(key, std::move(tile)).first->second;
+}
+
+void HeapCanvas::drawScene(QPainter& painter, const QRectF& area) {
+    // Antialiasing only pays off while nodes are more than a few pixels wide
+    painter.setRenderHint(QPainter::Antialiasing, NODE_RADIUS * zoom >= TEXT_MIN_RADIUS);
+
+    // A node reaches at most NODE_RADIUS beyond its centre
+    QRectF reach = area.adjusted(-NODE_RADIUS, -NODE_RADIUS, NODE_RADIUS, NODE_RADIUS);
+    for (int i = 0; i < scene->size(); i = scene->nodes[i].end) {
+        drawSubtree(painter, i, reach);
     }
 }
 
-void HeapCanvas::drawPointerLines(QPainter& painter) {
-    // Intentionally empty - sibling lines removed for simpler visualization
-    // This function is kept for potential future use and API compatibility
+void HeapCanvas::drawSubtree(QPainter& painter, int index, const QRectF& area) {
+    const HeapScene::Node& entry = scene->nodes[index];
+    if (!entry.bounds.intersects(area)) return;
+
+    // Level of detail: a subtree too small to read becomes a single glyph
+    bool hasChildren = entry.end > index + 1;
+    float extent = static_cast<float>(std::max(entry.bounds.width(), entry.bounds.height())) * zoom;
+    if (hasChildren && extent < SUMMARY_EXTENT) {
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(QColor(100, 150, 255, 110));
+        painter.drawRect(entry.bounds);
+        return;
+    }
+
+    // Simple line connections without arrows for cleaner look, drawn
+    // before the node so it covers the line ends
+    painter.setPen(QPen(QColor(150, 150, 150), 1.5));
+    for (int child = index + 1; child < entry.end; child = scene->nodes[child].end) {
+        painter.drawLine(entry.pos, scene->nodes[child].pos);
+    }
+
+    drawNode(painter, index, false);
+
+    for (int child = index + 1; child < entry.end; child = scene->nodes[child].end) {
+        drawSubtree(painter, child, area);
+    }
 }
 
-void HeapCanvas::drawNode(QPainter& painter, FibonacciHeap<int>::Node* node, float x, float y, bool isRoot) {
+void HeapCanvas::drawNode(QPainter& painter, int index, bool decorate) {
+    const HeapScene::Node& node = scene->nodes[index];
+    float x = node.pos.x();
+    float y = node.pos.y();
+
     // Simplified color scheme
     QColor fillColor;
-    bool isMin = (node == heap->getMin());
-    bool isSelected = (node == selectedNode);
-    bool isHighlighted = (node == highlightedNode);
+    bool isMin = (index == scene->minIndex);
+    bool isSelected = decorate && (index == selectedIndex);
+    bool isHighlighted = decorate && (index == highlightedIndex);
     
     // Simple color scheme: light gray for regular nodes, blue for minimum/highlighted
     if (isHighlighted || isMin) {
@@ -162,57 +391,87 @@ void HeapCanvas::drawNode(QPainter& painter, FibonacciHeap<int>::Node* node, flo
     painter.setBrush(QBrush(fillColor));
     painter.drawEllipse(QPointF(x, y), NODE_RADIUS, NODE_RADIUS);
     
-    // Draw key value
-    painter.setPen(QColor(30, 30, 30));
-    QFont font = painter.font();
-    font.setPointSize(NODE_TEXT_FONT_SIZE);
-    font.setBold(true);
-    painter.setFont(font);
-    
-    QString text = QString::number(node->key);
-    QRectF textRect(x - NODE_RADIUS, y - NODE_RADIUS, NODE_RADIUS * 2, NODE_RADIUS * 2);
-    painter.drawText(textRect, Qt::AlignCenter, text);
+    // Draw key value, once it is large enough to read
+    if (NODE_RADIUS * zoom >= TEXT_MIN_RADIUS) {
+        painter.setPen(QColor(30, 30, 30));
+        QFont font = painter.font();
+        font.setPointSize(NODE_TEXT_FONT_SIZE);
+        font.setBold(true);
+        painter.setFont(font);
+        
+        QString text = QString::number(node.key);
+        QRectF textRect(x - NODE_RADIUS, y - NODE_RADIUS, NODE_RADIUS * 2, NODE_RADIUS * 2);
+        painter.drawText(textRect, Qt::AlignCenter, text);
+    }
     
     // Small indicator for marked nodes (keep this subtle for important info)
-    if (node->marked) {
+    if (node.marked) {
         painter.setPen(QPen(QColor(200, 100, 100), 2));
         painter.setBrush(Qt::NoBrush);
         painter.drawEllipse(QPointF(x, y), NODE_RADIUS - 3, NODE_RADIUS - 3);
     }
 }
 
-FibonacciHeap<int>::Node* HeapCanvas::findNodeAtPosition(const QPointF& pos) {
-    for (const auto& [node, nodePos] : nodePositions) {
-        float dx = pos.x() - nodePos.x();
-        float dy = pos.y() - nodePos.y();
+int HeapCanvas::findNodeAtPosition(const QPointF& screenPos) const {
+    // Only the grid cells around pos can hold a node within NODE_RADIUS
+    QPointF pos = toLayout(screenPos);
+    int found = -1;
+    float bestDistance = NODE_RADIUS * NODE_RADIUS;
+    scene->grid.forEachNear(pos.x(), pos.y(), [&](uint32_t i) {
+        const HeapScene::Node& entry = scene->nodes[i];
+        float dx = pos.x() - entry.pos.x();
+        float dy = pos.y() - entry.pos.y();
         float distanceSquared = dx * dx + dy * dy;
-        if (distanceSquared <= NODE_RADIUS * NODE_RADIUS) {
-            return node;
+        if (distanceSquared <= bestDistance) {
+            bestDistance = distanceSquared;
+            found = static_cast<int>(i);
         }
-    }
-    return nullptr;
+    });
+    return found;
 }
 
 void HeapCanvas::mousePressEvent(QMouseEvent* event) {
     if (event->button() == Qt::LeftButton) {
-        FibonacciHeap<int>::Node* node = findNodeAtPosition(event->position());
-        if (node) {
-            selectedNode = node;
-            emit nodeSelected(node);
+        int index = findNodeAtPosition(event->position());
+        if (index >= 0) {
+            selectedIndex = index;
+            selectedId = scene->nodes[index].id;
+            emit nodeSelected(&scene->nodes[index]);
             update();
+        } else {
+            // Dragging the background pans the view
+            dragging = true;
+            lastDragPos = event->position().toPoint();
+            setCursor(Qt::ClosedHandCursor);
         }
     }
 }
 
+void HeapCanvas::mouseReleaseEvent(QMouseEvent* event) {
+    if (event->button() == Qt::LeftButton && dragging) {
+        dragging = false;
+        setCursor(Qt::ArrowCursor);
+    }
+}
+
 void HeapCanvas::mouseMoveEvent(QMouseEvent* event) {
-    FibonacciHeap<int>::Node* node = findNodeAtPosition(event->position());
-    if (node) {
+    if (dragging) {
+        QPoint position = event->position().toPoint();
+        pan += position - lastDragPos;
+        lastDragPos = position;
+        update();  // tiles are kept: panning only moves them
+        return;
+    }
+
+    int index = findNodeAtPosition(event->position());
+    if (index >= 0) {
         // Show tooltip with node information
+        const HeapScene::Node& node = scene->nodes[index];
         QString tooltip = QString("Key: %1\nValue: %2\nDegree: %3\nMarked: %4")
-            .arg(node->key)
-            .arg(node->value)
-            .arg(node->degree)
-            .arg(node->marked ? "Yes" : "No");
+            .arg(node.key)
+            .arg(node.value)
+            .arg(node.degree)
+            .arg(node.marked ? "Yes" : "No");
         QToolTip::showText(event->globalPosition().toPoint(), tooltip, this);
         setCursor(Qt::PointingHandCursor);
     } else {
@@ -220,14 +479,36 @@ void HeapCanvas::mouseMoveEvent(QMouseEvent* event) {
     }
 }
 
-void HeapCanvas::setHighlightedNode(FibonacciHeap<int>::Node* node) {
-    highlightedNode = node;
+void HeapCanvas::wheelEvent(QWheelEvent* event) {
+    float steps = event->angleDelta().y() / 120.0f;
+    float newZoom = std::clamp(zoom * std::pow(1.2f, steps), MIN_ZOOM, MAX_ZOOM);
+    if (newZoom == zoom) return;
+
+    // Zoom about the cursor: the layout point under it stays put
+    QPointF cursor = event->position();
+    QPointF anchor = toLayout(cursor);
+    zoom = newZoom;
+    pan = (cursor - anchor * zoom).toPoint();
+    invalidateTiles();
+    update();
+    event->accept();
+}
+
+const HeapScene::Node* HeapCanvas::getSelectedNode() const {
+    return selectedIndex >= 0 ? &scene->nodes[selectedIndex] : nullptr;
+}
+
+void HeapCanvas::setHighlightedNode(const void* id) {
+    highlightedId = id;
+    highlightedIndex = scene->indexOf(id);
     update();
 }
 
 void HeapCanvas::clearSelection() {
-    selectedNode = nullptr;
-    highlightedNode = nullptr;
+    selectedId = nullptr;
+    highlightedId = nullptr;
+    selectedIndex = -1;
+    highlightedIndex = -1;
     update();
 }
 
@@ -236,6 +517,14 @@ void HeapCanvas::clearSelection() {
 // =====================================================================
 
 MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
+    qRegisterMetaType<HeapScenePtr>();
+    worker = new HeapWorker();
+    worker->moveToThread(&workerThread);
+    connect(&workerThread, &QThread::finished, worker, &QObject::deleteLater);
+    connect(worker, &HeapWorker::sceneReady, this, &MainWindow::onSceneReady);
+    connect(worker, &HeapWorker::commandDone, this, &MainWindow::updateStatus);
+    workerThread.start();
+
     animationSystem = new AnimationSystem(this);
     connect(animationSystem, &AnimationSystem::animationUpdate, this, &MainWindow::onAnimationUpdate);
     connect(animationSystem, &AnimationSystem::animationCompleted, this, &MainWindow::onAnimationCompleted);
@@ -245,7 +534,18 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
     resize(1600, 900);
 }
 
-MainWindow::~MainWindow() = default;
+MainWindow::~MainWindow() {
+    // Commands still queued are dropped; the worker and its heap are
+    // destroyed on the worker thread once it stops
+    workerThread.quit();
+    workerThread.wait();
+}
+
+template <typename Command>
+void MainWindow::post(Command command) {
+    // Runs on the worker thread, after every command posted before it
+    QMetaObject::invokeMethod(worker, std::move(command), Qt::QueuedConnection);
+}
 
 void MainWindow::setupUI() {
     // Create central widget
@@ -274,7 +574,6 @@ void MainWindow::setupUI() {
     
     infoLabel = new QLabel(this);
     infoLabel->setAlignment(Qt::AlignRight);
-    updateInfo();
     statusLayout->addWidget(infoLabel);
     mainLayout->addLayout(statusLayout);
     
@@ -298,6 +597,21 @@ void MainWindow::setupUI() {
     controlLayout->addWidget(insertButton, row, 2);
     row++;
     
+    // Bulk random inserts, run by the worker in chunks
+    QLabel* randomLabel = new QLabel("Random Values:", this);
+    controlLayout->addWidget(randomLabel, row, 0);
+    
+    randomCountSpinBox = new QSpinBox(this);
+    randomCountSpinBox->setRange(1, 5000000);
+    randomCountSpinBox->setValue(10000);
+    randomCountSpinBox->setMaximumWidth(100);
+    controlLayout->addWidget(randomCountSpinBox, row, 1);
+    
+    insertRandomButton = new QPushButton("Insert Random", this);
+    insertRandomButton->setStyleSheet("QPushButton { background-color: #4682B4; color: white; padding: 8px 16px; font-weight: bold; }");
+    controlLayout->addWidget(insertRandomButton, row, 2);
+    row++;
+    
     // Find Min button
     findMinButton = new QPushButton("Find Min (Highlight)", this);
     findMinButton->setStyleSheet("QPushButton { background-color: #FFD700; color: black; padding: 8px 16px; font-weight: bold; }");
@@ -356,27 +670,52 @@ void MainWindow::setupUI() {
     animLayout->addWidget(speedLabel);
     
     speedSlider = new QSlider(Qt::Horizontal, this);
-    speedSlider->setRange(1, 3);
-    speedSlider->setValue(1);
+    speedSlider->setRange(0, SPEED_SLIDER_MAX);
+    speedSlider->setValue(SPEED_SLIDER_DEFAULT);
     speedSlider->setTickPosition(QSlider::TicksBelow);
-    speedSlider->setTickInterval(1);
+    speedSlider->setTickInterval(SPEED_STEPS_PER_DOUBLING * 2);
     speedSlider->setMaximumWidth(150);
     animLayout->addWidget(speedSlider);
     
-    QLabel* speedInfo = new QLabel("1=Slow  2=Normal  3=Fast", this);
-    animLayout->addWidget(speedInfo);
+    speedInfoLabel = new QLabel(this);
+    speedInfoLabel->setMinimumWidth(60);
+    animLayout->addWidget(speedInfoLabel);
     
     pauseResumeButton = new QPushButton("Pause", this);
-    pauseResumeButton->setEnabled(false);
     pauseResumeButton->setStyleSheet("QPushButton { padding: 8px 16px; }");
     animLayout->addWidget(pauseResumeButton);
     
-    animLayout->addStretch();
+    skipButton = new QPushButton("Skip Operation", this);
+    skipButton->setStyleSheet("QPushButton { padding: 8px 16px; }");
+    skipButton->setToolTip("Jump to the start of the next operation");
+    animLayout->addWidget(skipButton);
+    
+    liveButton = new QPushButton("Skip to End", this);
+    liveButton->setStyleSheet("QPushButton { padding: 8px 16px; }");
+    liveButton->setToolTip("Catch playback up with the heap");
+    animLayout->addWidget(liveButton);
+    
+    // Drag to scrub through the recorded operations
+    scrubSlider = new QSlider(Qt::Horizontal, this);
+    scrubSlider->setRange(0, SCRUB_STEPS);
+    scrubSlider->setToolTip("Replay earlier operations on the heap as it was then");
+    animLayout->addWidget(scrubSlider, 1);
+    
+    fitButton = new QPushButton("Fit View", this);
+    fitButton->setStyleSheet("QPushButton { padding: 8px 16px; }");
+    fitButton->setToolTip("Zoom out until the whole heap is visible");
+    animLayout->addWidget(fitButton);
+    
+    frameStatsBox = new QCheckBox("Frame Stats", this);
+    frameStatsBox->setToolTip("Show layout, paint and animation time per frame");
+    animLayout->addWidget(frameStatsBox);
     mainLayout->addWidget(animGroup);
     
     // Canvas for heap visualization
-    canvas = new HeapCanvas(&heap, animationSystem, this);
+    canvas = new HeapCanvas(animationSystem, this);
     mainLayout->addWidget(canvas, 1);  // Stretch factor 1
+    updateInfo();
+    onSpeedChanged(SPEED_SLIDER_DEFAULT);
     
     // Legend - Simplified
     QGroupBox* legendGroup = new QGroupBox("Legend", this);
@@ -403,6 +742,7 @@ void MainWindow::setupUI() {
     
     // Connect signals and slots
     connect(insertButton, &QPushButton::clicked, this, &MainWindow::onInsertClicked);
+    connect(insertRandomButton, &QPushButton::clicked, this, &MainWindow::onInsertRandomClicked);
     connect(findMinButton, &QPushButton::clicked, this, &MainWindow::onFindMinClicked);
     connect(extractMinButton, &QPushButton::clicked, this, &MainWindow::onExtractMinClicked);
     connect(decreaseKeyButton, &QPushButton::clicked, this, &MainWindow::onDecreaseKeyClicked);
@@ -411,6 +751,11 @@ void MainWindow::setupUI() {
     connect(resetButton, &QPushButton::clicked, this, &MainWindow::onResetClicked);
     connect(pauseResumeButton, &QPushButton::clicked, this, &MainWindow::onPauseResumeClicked);
     connect(speedSlider, &QSlider::valueChanged, this, &MainWindow::onSpeedChanged);
+    connect(skipButton, &QPushButton::clicked, this, &MainWindow::onSkipClicked);
+    connect(liveButton, &QPushButton::clicked, this, &MainWindow::onLiveClicked);
+    connect(scrubSlider, &QSlider::sliderMoved, this, &MainWindow::onScrubMoved);
+    connect(fitButton, &QPushButton::clicked, canvas, &HeapCanvas::zoomToFit);
+    connect(frameStatsBox, &QCheckBox::toggled, canvas, &HeapCanvas::setFrameStatsVisible);
     connect(inputField, &QLineEdit::returnPressed, this, &MainWindow::onInsertClicked);
     connect(canvas, &HeapCanvas::nodeSelected, this, &MainWindow::onNodeSelected);
 }
@@ -431,72 +776,45 @@ void MainWindow::onInsertClicked() {
         return;
     }
     
-    heap.insert(value, value);  // Use value as both value and key
-    updateStatus(QString("Inserted: %1").arg(value));
+    post([w = worker, value] { w->insert(value); });
     inputField->clear();
-    updateInfo();
-    canvas->update();
+}
+
+void MainWindow::onInsertRandomClicked() {
+    int count = randomCountSpinBox->value();
+    post([w = worker, count] { w->insertRandom(count); });
+    updateStatus(QString("Inserting %1 random values...").arg(count));
 }
 
 void MainWindow::onFindMinClicked() {
-    if (heap.isEmpty()) {
+    const HeapScene::Node* minNode = canvas->getLatestScene().min();
+    if (!minNode) {
         updateStatus("Heap is empty");
         return;
     }
     
-    auto* minNode = heap.getMin();
-    if (minNode) {
-        canvas->setHighlightedNode(minNode);
-        updateStatus(QString("Minimum value: %1 (highlighted in blue)").arg(minNode->key));
-    }
+    canvas->setHighlightedNode(minNode->id);
+    updateStatus(QString("Minimum value: %1 (highlighted in blue)").arg(minNode->key));
 }
 
 void MainWindow::onExtractMinClicked() {
-    if (heap.isEmpty()) {
+    if (canvas->getLatestScene().empty()) {
         updateStatus("Heap is empty");
         return;
     }
     
-    if (animationSystem->isAnimating()) {
-        updateStatus("Animation in progress. Please wait...");
-        return;
-    }
-    
-    auto* minNode = heap.getMin();
-    if (!minNode) {
-        updateStatus("Error: Heap min node is null");
-        return;
-    }
-    
-    int minValue = minNode->key;
-    
-    // Setup animation
-    setupAnimationForExtractMin();
-    
-    // Perform actual extraction
-    auto* extracted = heap.extractMin();
-    delete extracted;
-    
-    // Start animation
-    animationSystem->play();
-    pauseResumeButton->setEnabled(true);
-    
-    updateStatus(QString("Extracting min: %1 - Watch the animation!").arg(minValue));
-    updateInfo();
+    // The worker extracts and reports the key; the canvas follows with
+    // the next scene, and the animation with its records
+    post([w = worker] { w->extractMin(); });
 }
 
 void MainWindow::onDecreaseKeyClicked() {
-    auto* selectedNode = canvas->getSelectedNode();
+    const HeapScene::Node* selectedNode = canvas->getSelectedNode();
     if (!selectedNode) {
         updateStatus("Please select a node first by clicking on it");
         return;
     }
     
-    if (animationSystem->isAnimating()) {
-        updateStatus("Animation in progress. Please wait...");
-        return;
-    }
-    
     int newKey = keySpinBox->value();
     
     if (newKey >= selectedNode->key) {
@@ -505,102 +823,85 @@ void MainWindow::onDecreaseKeyClicked() {
         return;
     }
     
-    // Setup animation
-    setupAnimationForDecreaseKey();
-    
-    // Perform actual decrease key
-    try {
-        heap.decreaseKey(selectedNode, newKey);
-        animationSystem->play();
-        pauseResumeButton->setEnabled(true);
-        updateStatus(QString("Decreasing key to %1 - Watch for cuts and cascading cuts!").arg(newKey));
-        updateInfo();
-    } catch (const std::exception& e) {
-        updateStatus(QString("Error: %1").arg(e.what()));
-    }
+    const void* id = selectedNode->id;
+    quint64 version = canvas->getScene().version;
+    post([w = worker, id, newKey, version] { w->decreaseKey(id, newKey, version); });
 }
 
 void MainWindow::onDeleteNodeClicked() {
-    auto* selectedNode = canvas->getSelectedNode();
+    const HeapScene::Node* selectedNode = canvas->getSelectedNode();
     if (!selectedNode) {
         updateStatus("Please select a node first by clicking on it");
         return;
     }
     
-    if (animationSystem->isAnimating()) {
-        updateStatus("Animation in progress. Please wait...");
-        return;
-    }
-    
-    int key = selectedNode->key;
-    
-    heap.deleteNode(selectedNode);
+    const void* id = selectedNode->id;
+    quint64 version = canvas->getScene().version;
+    post([w = worker, id, version] { w->deleteNode(id, version); });
     canvas->clearSelection();
-    updateStatus(QString("Deleted node with key %1").arg(key));
-    updateInfo();
-    canvas->update();
 }
 
 void MainWindow::onUnionClicked() {
-    if (animationSystem->isAnimating()) {
-        updateStatus("Animation in progress. Please wait...");
-        return;
-    }
-    
-    // Create a new heap with some values
-    heap2 = FibonacciHeap<int>();
-    heap2.insert(100, 100);
-    heap2.insert(50, 50);
-    heap2.insert(75, 75);
-    
-    int heap2Size = heap2.getSize();
-    heap.merge(heap2);
-    
-    updateStatus(QString("Merged with new heap containing %1 nodes (50, 75, 100)").arg(heap2Size));
-    updateInfo();
-    canvas->update();
+    // Merge with a new heap holding some values
+    post([w = worker] { w->merge({100, 50, 75}); });
 }
 
 void MainWindow::onResetClicked() {
-    if (animationSystem->isAnimating()) {
-        animationSystem->stop();
-        pauseResumeButton->setEnabled(false);
-    }
-    
-    heap = FibonacciHeap<int>();
+    // Nothing before the reset is worth playing back
+    animationSystem->clear();
+    post([w = worker] { w->reset(); });
     canvas->clearSelection();
-    updateStatus("Heap reset - Ready to insert new values");
-    updateInfo();
-    canvas->update();
 }
 
 void MainWindow::onPauseResumeClicked() {
-    if (animationSystem->isAnimating()) {
-        animationSystem->pause();
-        pauseResumeButton->setText("Resume");
-    } else {
+    if (animationSystem->isPaused()) {
         animationSystem->resume();
         pauseResumeButton->setText("Pause");
+    } else {
+        animationSystem->pause();
+        pauseResumeButton->setText("Resume");
     }
 }
 
 void MainWindow::onSpeedChanged(int value) {
-    animationSystem->setSpeed(value);
-    updateStatus(QString("Animation speed set to %1").arg(value));
+    double speed = speedFor(value);
+    animationSystem->setSpeed(speed);
+    speedInfoLabel->setText(speed < 1.0 ? QString("%1x").arg(speed, 0, 'g', 2) : QString("%1x").arg(static_cast<int>(speed)));
+}
+
+void MainWindow::onSkipClicked() {
+    animationSystem->skipOperation();
+}
+
+void MainWindow::onLiveClicked() {
+    animationSystem->skipToEnd();
+}
+
+void MainWindow::onScrubMoved(int value) {
+    double start = animationSystem->startTime();
+    double end = animationSystem->getEndTime();
+    animationSystem->seek(start + (end - start) * value / SCRUB_STEPS);
 }
 
 void MainWindow::onAnimationUpdate() {
+    updatePlaybackControls();
     canvas->update();
 }
 
 void MainWindow::onAnimationCompleted() {
-    pauseResumeButton->setEnabled(false);
-    pauseResumeButton->setText("Pause");
+    updatePlaybackControls();
     canvas->update();
-    updateStatus("Animation completed");
 }
 
-void MainWindow::onNodeSelected(FibonacciHeap<int>::Node* node) {
+void MainWindow::updatePlaybackControls() {
+    if (scrubSlider->isSliderDown()) return;  // the user is scrubbing
+    double start = animationSystem->startTime();
+    double end = animationSystem->getEndTime();
+    double fraction = end > start ? (animationSystem->position() - start) / (end - start) : 1.0;
+    scrubSlider->setValue(static_cast<int>(std::lround(fraction * SCRUB_STEPS)));
+}
+
+void MainWindow::onNodeSelected(const HeapScene::Node* node) {
     if (node) {
         updateStatus(QString("Node selected: key=%1, degree=%2, marked=%3")
             .arg(node->key)
@@ -609,69 +910,22 @@ void MainWindow::onNodeSelected(FibonacciHeap<int>::Node* node) {
     }
 }
 
+void MainWindow::onSceneReady(HeapScenePtr scene) {
+    animationSystem->append(scene);
+    canvas->setScene(std::move(scene));
+    updateInfo();
+    updatePlaybackControls();
+}
+
 void MainWindow::updateStatus(const QString& message) {
     statusLabel->setText(message);
 }
 
 void MainWindow::updateInfo() {
-    QString info = QString("Heap Size: %1").arg(heap.getSize());
-    if (!heap.isEmpty()) {
-        info += QString(" | Min Key: %1").arg(heap.getMin()->key);
+    const HeapScene& scene = canvas->getLatestScene();
+    QString info = QString("Heap Size: %1").arg(scene.size());
+    if (const HeapScene::Node* minNode = scene.min()) {
+        info += QString(" | Min Key: %1").arg(minNode->key);
     }
     infoLabel->setText(info);
 }
-
-void MainWindow::setupAnimationForExtractMin() {
-    animationSystem->clearSteps();
-    
-    // Add animation steps for extract min operation
-    // Step 1: Highlight the min node
-    AnimationStep step1;
-    step1.type = AnimationStep::HIGHLIGHT_NODE;
-    step1.nodePtr = heap.getMin();
-    step1.duration = 500;
-    animationSystem->addStep(step1);
-    
-    // Step 2: Show removal
-    AnimationStep step2;
-    step2.type = AnimationStep::REMOVE_NODE;
-    step2.nodePtr = heap.getMin();
-    step2.duration = 800;
-    animationSystem->addStep(step2);
-    
-    // Step 3: Pause to show consolidation
-    AnimationStep step3;
-    step3.type = AnimationStep::PAUSE;
-    step3.duration = 1000;
-    animationSystem->addStep(step3);
-}
-
-void MainWindow::setupAnimationForDecreaseKey() {
-    animationSystem->clearSteps();
-    
-    auto* node = canvas->getSelectedNode();
-    if (!node) return;
-    
-    // Add animation steps for decrease key operation
-    // Step 1: Highlight the node
-    AnimationStep step1;
-    step1.type = AnimationStep::HIGHLIGHT_NODE;
-    step1.nodePtr = node;
-    step1.duration = 500;
-    animationSystem->addStep(step1);
-    
-    // Step 2: Show color change (marking)
-    AnimationStep step2;
-    step2.type = AnimationStep::CHANGE_COLOR;
-    step2.nodePtr = node;
-    step2.startColor = QColor(173, 216, 230);
-    step2.endColor = QColor(255, 140, 0);
-    step2.duration = 800;
-    animationSystem->addStep(step2);
-    
-    // Step 3: Pause to show cut
-    AnimationStep step3;
-    step3.type = AnimationStep::PAUSE;
-    step3.duration = 1000;
-    animationSystem->addStep(step3);
-}
@@ -42,7 +42,6 @@ features=(
     "selectedNode:Node Selection"
     "highlightedNode:Node Highlighting"
     "speedSlider:Animation Speed Control"
-    "drawPointerLines:Pointer Visualization"
 )
 
 for feature in "${features[@]}"; do
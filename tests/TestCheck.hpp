@@ -0,0 +1,29 @@
+#ifndef TEST_CHECK_HPP
+#define TEST_CHECK_HPP
+
+#include <cstdio>
+#include <cstdlib>
+
+// Minimal checks for the test executables: unlike assert() they stay on
+// in release builds, and a failure ends the test with a non-zero status.
+#define CHECK(cond)                                                        \
+    do {                                                                   \
+        if (!(cond)) {                                                     \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n",              \
+                         __FILE__, __LINE__, #cond);                       \
+            std::exit(1);                                                  \
+        }                                                                  \
+    } while (0)
+
+#define CHECK_THROWS(expr)                                                 \
+    do {                                                                   \
+        bool threw = false;                                                \
+        try { expr; } catch (...) { threw = true; }                        \
+        if (!threw) {                                                      \
+            std::fprintf(stderr, "%s:%d: %s did not throw\n",              \
+                         __FILE__, __LINE__, #expr);                       \
+            std::exit(1);                                                  \
+        }                                                                  \
+    } while (0)
+
+#endif // TEST_CHECK_HPP
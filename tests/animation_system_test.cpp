@@ -0,0 +1,201 @@
+// animation_system_test - AnimationSystem's timeline: every record at its
+// place, played back on the scene it arrived in, with seeking, skipping,
+// trimming of old records and a clock that can be paused and sped up
+
+#include "AnimationSystem.h"
+#include "TestCheck.hpp"
+#include <QCoreApplication>
+#include <QEventLoop>
+#include <QThread>
+#include <QTimer>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+namespace {
+
+AnimationRecord operation(AnimationRecord::Operation op, int key = 0) {
+    AnimationRecord record;
+    record.operation = op;
+    record.key = key;
+    return record;
+}
+
+AnimationRecord event(AnimationRecord::Type type, int key = 0) {
+    AnimationRecord record;
+    record.type = type;
+    record.key = key;
+    return record;
+}
+
+HeapScenePtr sceneWith(std::vector<AnimationRecord> records) {
+    auto scene = std::make_shared<HeapScene>();
+    scene->records = std::move(records);
+    return scene;
+}
+
+// Paused, the position only moves when it is set, so every frame is known
+void testTimeline() {
+    AnimationSystem animation;
+    animation.pause();
+    CHECK(animation.currentFrame().record == nullptr);
+
+    HeapScenePtr first = sceneWith({operation(AnimationRecord::OP_INSERT, 5), event(AnimationRecord::INSERT, 5)});
+    animation.append(first);
+    CHECK(!animation.isAnimating() && animation.position() == 0 && animation.getEndTime() == 900);
+    AnimationFrame frame = animation.currentFrame();
+    CHECK(frame.record && frame.record->operation == AnimationRecord::OP_INSERT && frame.progress == 0);
+    CHECK(frame.scene == first && !frame.before);
+    CHECK(AnimationSystem::describe(*frame.record).toStdString() == "Insert 5");
+    animation.seek(750);
+    frame = animation.currentFrame();
+    CHECK(frame.record && frame.record->type == AnimationRecord::INSERT && frame.progress == 0.5f);
+    CHECK(AnimationSystem::describe(*frame.record).toStdString() == "5 added as a root");
+
+    // the next scene's records play out between it and the one before
+    HeapScenePtr second = sceneWith({operation(AnimationRecord::OP_EXTRACT_MIN), event(AnimationRecord::EXTRACT, 5),
+                                     event(AnimationRecord::LINK, 7)});
+    animation.append(second);
+    CHECK(animation.getEndTime() == 2400);
+    animation.seek(1000);
+    frame = animation.currentFrame();
+    CHECK(frame.record->operation == AnimationRecord::OP_EXTRACT_MIN);
+    CHECK(frame.scene == second && frame.before == first);
+    animation.seek(100);
+    CHECK(animation.currentFrame().scene == first);
+
+    animation.skipOperation();
+    CHECK(animation.position() == 900);
+    animation.skipOperation();
+    CHECK(animation.position() == 2400 && animation.currentFrame().record == nullptr);
+    animation.seek(-100);
+    CHECK(animation.position() == 0);
+    animation.seek(5000);
+    CHECK(animation.position() == 2400);
+
+    // a scene without records adds nothing to play, but is where the
+    // next records start from
+    HeapScenePtr empty = sceneWith({});
+    animation.append(empty);
+    CHECK(animation.getEndTime() == 2400);
+    HeapScenePtr third = sceneWith({operation(AnimationRecord::OP_DELETE, 3), event(AnimationRecord::EXTRACT, 3)});
+    animation.append(third);
+    frame = animation.currentFrame();
+    CHECK(frame.scene == third && frame.before == empty);
+    CHECK(AnimationSystem::describe(*frame.record).toStdString() == "Delete 3");
+
+    // cleared, the timeline goes on from where it ended
+    animation.clear();
+    CHECK(animation.startTime() == 3500 && animation.position() == 3500);
+    CHECK(animation.currentFrame().record == nullptr);
+    HeapScenePtr fourth = sceneWith({operation(AnimationRecord::OP_RESET)});
+    animation.append(fourth);
+    frame = animation.currentFrame();
+    CHECK(frame.scene == fourth && frame.before == third);
+    CHECK(animation.getEndTime() == 4100);
+}
+
+// Past the record limit the oldest half of the scenes goes, with their
+// records, and the position moves up to what is left
+void testTrimming() {
+    const size_t perScene = size_t(1) << 18;  // a quarter of the limit
+    AnimationSystem animation;
+    animation.pause();
+    std::vector<HeapScenePtr> scenes;
+    for (int i = 0; i < 5; ++i) {
+        scenes.push_back(sceneWith(std::vector<AnimationRecord>(perScene, event(AnimationRecord::INSERT))));
+        animation.append(scenes.back());
+        if (i < 4) CHECK(animation.startTime() == 0);
+    }
+    double dropped = 2 * static_cast<double>(perScene) * 300;
+    CHECK(animation.startTime() == dropped && animation.position() == dropped);
+    CHECK(animation.getEndTime() == 5 * static_cast<double>(perScene) * 300);
+    AnimationFrame frame = animation.currentFrame();
+    CHECK(frame.scene == scenes[2] && frame.before == scenes[1]);
+    animation.seek(0);
+    CHECK(animation.position() == dropped);
+    animation.seek(animation.getEndTime() - 1);
+    CHECK(animation.currentFrame().scene == scenes[4]);
+
+    // more than half the limit at once drops as many scenes as it takes
+    double end = animation.getEndTime();
+    scenes.push_back(sceneWith(std::vector<AnimationRecord>(perScene * 3 + 1, event(AnimationRecord::INSERT))));
+    animation.append(scenes.back());
+    CHECK(animation.startTime() == end && animation.position() == end);
+    frame = animation.currentFrame();
+    CHECK(frame.scene == scenes[5] && frame.before == scenes[4]);
+}
+
+// Running, the clock moves the position until it catches up
+void testPlayback() {
+    AnimationSystem animation;
+    int started = 0;
+    int completed = 0;
+    QObject::connect(&animation, &AnimationSystem::animationStarted, &animation, [&] { started++; });
+    QObject::connect(&animation, &AnimationSystem::animationCompleted, &animation, [&] { completed++; });
+    auto waitForCompleted = [&] {
+        QEventLoop loop;
+        QObject::connect(&animation, &AnimationSystem::animationCompleted, &loop, &QEventLoop::quit);
+        QTimer::singleShot(30000, &loop, &QEventLoop::quit);
+        loop.exec();
+    };
+
+    animation.setSpeed(1e9);
+    CHECK(animation.getSpeed() == 4096);
+    animation.append(sceneWith({operation(AnimationRecord::OP_INSERT, 1), event(AnimationRecord::INSERT, 1)}));
+    CHECK(animation.isAnimating() && started == 1);
+    animation.resume();  // not paused: nothing to do
+    CHECK(started == 1);
+    waitForCompleted();
+    CHECK(completed == 1 && !animation.isAnimating());
+    CHECK(animation.position() == animation.getEndTime() && animation.currentFrame().record == nullptr);
+    // caught up, there is nothing to resume
+    animation.pause();
+    animation.resume();
+    CHECK(!animation.isAnimating() && started == 1);
+
+    // paused, new records wait and the position stands still
+    animation.pause();
+    animation.append(sceneWith({operation(AnimationRecord::OP_EXTRACT_MIN), event(AnimationRecord::EXTRACT, 1)}));
+    double at = animation.position();
+    QThread::msleep(20);
+    CHECK(!animation.isAnimating() && started == 1 && animation.position() == at);
+    CHECK(animation.currentFrame().record->operation == AnimationRecord::OP_EXTRACT_MIN);
+
+    // slowed down, playback takes seconds; a change of speed or a pause
+    // keeps the position where it was
+    animation.setSpeed(0.25);
+    animation.resume();
+    CHECK(animation.isAnimating() && started == 2);
+    QThread::msleep(200);
+    double slow = animation.position();
+    CHECK(slow > at && slow < animation.getEndTime());
+    animation.setSpeed(4);
+    CHECK(animation.position() >= slow && animation.position() < slow + 400);
+    QThread::msleep(50);
+    animation.pause();
+    double paused = animation.position();
+    CHECK(paused > slow + 100);
+    QThread::msleep(20);
+    CHECK(animation.position() == paused);
+    animation.resume();
+    CHECK(animation.position() >= paused);
+
+    // skipped to the end it is done
+    animation.skipToEnd();
+    CHECK(animation.position() == animation.getEndTime());
+    waitForCompleted();
+    CHECK(completed == 2 && !animation.isAnimating());
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    testTimeline();
+    testTrimming();
+    testPlayback();
+    std::puts("animation_system_test passed");
+    return 0;
+}
@@ -0,0 +1,233 @@
+// clone_test - FibonacciHeap::clone() copies a heap tree for tree, marks and
+// all; the copy and the original then change independently, and a payload
+// that fails to copy leaves nothing behind
+
+#include "FibonacciHeap.hpp"
+#include "TestCheck.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// A payload that counts its copies alive, and can be told to fail a copy
+struct Patient {
+    static int live;
+    static int copiesLeft;  // copies allowed before one throws; -1: any
+    int id;
+    explicit Patient(int i) : id(i) { live++; }
+    Patient(const Patient& other) : id(other.id) {
+        if (copiesLeft == 0) throw std::runtime_error("copy failed");
+        if (copiesLeft > 0) copiesLeft--;
+        live++;
+    }
+    ~Patient() { live--; }
+};
+int Patient::live = 0;
+int Patient::copiesLeft = -1;
+
+struct InsertCounter : NullHeapObserver {
+    int inserts = 0;
+    template <typename Node> void inserted(const Node*) { inserts++; }
+};
+
+using Heap = FibonacciHeap<Patient, InsertCounter>;
+using NodeMap = std::unordered_map<const Heap::Node*, Heap::Node*>;
+
+// Trees several levels deep with marked nodes; returns the live nodes
+std::vector<Heap::Node*> build(Heap& heap, int count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::vector<Heap::Node*> nodes;
+    for (int i = 0; i < count; ++i) nodes.push_back(heap.insert(Patient(i), static_cast<int>(rng() % 100000)));
+    Heap::Node* min = heap.extractMin();
+    nodes.erase(std::find(nodes.begin(), nodes.end(), min));
+    heap.release(min);
+    for (size_t i = 0; i < nodes.size(); i += 5) heap.decreaseKey(nodes[i], nodes[i]->key - static_cast<int>(rng() % 1000));
+    return nodes;
+}
+
+// The copy has the same shape, node for node in nodes() order, and shares
+// none of them; returns the original's nodes mapped to the copies
+NodeMap checkSameShape(const Heap& original, const Heap& copy) {
+    CHECK(copy.getSize() == original.getSize());
+    CHECK(copy.getConsolidationBudget() == original.getConsolidationBudget());
+    NodeMap map;
+    std::vector<Heap::Node*> copies;
+    for (Heap::Node* node : copy.nodes()) copies.push_back(node);
+    CHECK(copies.size() == static_cast<size_t>(original.getSize()));
+    size_t i = 0;
+    for (Heap::Node* node : original.nodes()) {
+        Heap::Node* clone = copies[i++];
+        CHECK(clone != node);
+        CHECK(clone->key == node->key && clone->value.id == node->value.id);
+        CHECK(clone->degree == node->degree && clone->marked == node->marked);
+        map[node] = clone;
+    }
+    CHECK(map.size() == copies.size());
+    for (const auto& entry : map) {
+        const Heap::Node* node = entry.first;
+        Heap::Node* clone = entry.second;
+        CHECK(clone->parent == (node->parent ? map[node->parent] : nullptr));
+        CHECK(clone->child == (node->child ? map[node->child] : nullptr));
+        CHECK(clone->left == map[node->left] && clone->right == map[node->right]);
+    }
+    CHECK(copy.getMin() == (original.getMin() ? map[original.getMin()] : nullptr));
+    return map;
+}
+
+std::vector<int> keysInOrder(const Heap& heap) {
+    std::vector<int> keys;
+    for (Heap::Node* node : heap.nodes()) keys.push_back(node->key);
+    return keys;
+}
+
+void drainInOrder(Heap& heap, std::multiset<int>& keys) {
+    for (int key : keys) {
+        Heap::Node* min = heap.extractMin();
+        CHECK(min->key == key);
+        heap.release(min);
+    }
+    CHECK(heap.isEmpty());
+}
+
+void testSameShape() {
+    Heap empty;
+    empty.setConsolidationBudget(3);
+    Heap none = empty.clone();
+    CHECK(none.isEmpty() && none.getMin() == nullptr && none.getConsolidationBudget() == 3);
+
+    Heap heap;
+    build(heap, 5000, 50);
+    int inserts = heap.getObserver().inserts;
+    Heap copy = heap.clone();
+    checkSameShape(heap, copy);
+    CHECK(copy.getObserver().inserts == copy.getSize());  // a fresh observer
+    CHECK(heap.getObserver().inserts == inserts);
+
+    // a clone of a clone, and clones outliving their original
+    Heap second = copy.clone();
+    {
+        Heap gone;
+        build(gone, 1000, 51);
+        Heap kept = gone.clone();
+        std::multiset<int> keys;
+        for (Heap::Node* node : gone.nodes()) keys.insert(node->key);
+        gone.clear();
+        drainInOrder(kept, keys);
+    }
+    checkSameShape(heap, second);
+}
+
+// The copy and the original go separate ways; neither sees the other's
+// changes, and the original's nodes map to the copy's for decreaseKey()
+void testIndependent(int budget) {
+    std::mt19937 rng(52 + static_cast<unsigned>(budget));
+    Heap heap;
+    heap.setConsolidationBudget(budget);
+    std::vector<Heap::Node*> live = build(heap, 3000, 53);
+    std::multiset<int> keys;
+    for (Heap::Node* node : live) keys.insert(node->key);
+
+    Heap copy = heap.clone();
+    NodeMap map = checkSameShape(heap, copy);
+    std::vector<int> before = keysInOrder(heap);
+    std::vector<Heap::Node*> copyLive;
+    for (Heap::Node* node : live) copyLive.push_back(map[node]);
+    std::multiset<int> copyKeys = keys;
+
+    // what if three more arrive, and others get worse
+    for (int step = 0; step < 5000; ++step) {
+        int op = static_cast<int>(rng() % 4);
+        if (copyLive.empty() || op == 0) {
+            int key = static_cast<int>(rng() % 100000);
+            copyLive.push_back(copy.insert(Patient(-step), key));
+            copyKeys.insert(key);
+        } else if (op == 1) {
+            Heap::Node* min = copy.extractMin();
+            copyKeys.erase(copyKeys.find(min->key));
+            copyLive.erase(std::find(copyLive.begin(), copyLive.end(), min));
+            copy.release(min);
+        } else if (op == 2) {
+            Heap::Node* node = copyLive[rng() % copyLive.size()];
+            copyKeys.erase(copyKeys.find(node->key));
+            copy.decreaseKey(node, node->key - 1 - static_cast<int>(rng() % 5000));
+            copyKeys.insert(node->key);
+        } else {
+            size_t i = rng() % copyLive.size();
+            copyKeys.erase(copyKeys.find(copyLive[i]->key));
+            copy.deleteNode(copyLive[i]);
+            copyLive.erase(copyLive.begin() + static_cast<std::ptrdiff_t>(i));
+        }
+        CHECK(copy.getSize() == static_cast<int>(copyKeys.size()));
+        if (!copyKeys.empty()) CHECK(copy.getMin()->key == *copyKeys.begin());
+    }
+    CHECK(keysInOrder(heap) == before && heap.getSize() == static_cast<int>(keys.size()));
+
+    for (int i = 0; i < 1000; ++i) {
+        Heap::Node* min = heap.extractMin();
+        keys.erase(keys.find(min->key));
+        heap.release(min);
+    }
+    copy.consolidate();
+    std::set<int> degrees;
+    for (Heap::Node* root : copy.roots()) CHECK(degrees.insert(root->degree).second);
+    drainInOrder(copy, copyKeys);
+    drainInOrder(heap, keys);
+}
+
+// Many branches of one heap, each with its own outcome
+void testManyBranches() {
+    Heap heap;
+    build(heap, 2000, 54);
+    std::vector<int> before = keysInOrder(heap);
+    std::vector<Heap> branches;
+    for (int i = 0; i < 200; ++i) {
+        branches.push_back(heap.clone());
+        Heap& branch = branches.back();
+        for (int j = 0; j < 3; ++j) branch.insert(Patient(-i), -1000000 - i - j);
+        Heap::Node* min = branch.extractMin();
+        CHECK(min->key == -1000000 - i - 2 && min->value.id == -i);
+        branch.release(min);
+    }
+    for (size_t i = 0; i < branches.size(); ++i) {
+        CHECK(branches[i].getSize() == heap.getSize() + 2);
+        CHECK(branches[i].getMin()->key == -1000000 - static_cast<int>(i) - 1);
+    }
+    CHECK(keysInOrder(heap) == before);
+}
+
+// A payload copy that throws leaves the original as it was and the
+// copies made so far destroyed
+void testFailedCopy() {
+    Heap heap;
+    build(heap, 1000, 55);
+    std::vector<int> before = keysInOrder(heap);
+    int live = Patient::live;
+    Patient::copiesLeft = 500;
+    CHECK_THROWS(heap.clone());
+    Patient::copiesLeft = -1;
+    CHECK(Patient::live == live);
+    CHECK(keysInOrder(heap) == before);
+    Heap copy = heap.clone();
+    checkSameShape(heap, copy);
+    CHECK(Patient::live == 2 * live);
+}
+
+} // namespace
+
+int main() {
+    testSameShape();
+    testIndependent(0);
+    testIndependent(2);
+    testManyBranches();
+    testFailedCopy();
+    CHECK(Patient::live == 0);
+    std::puts("clone_test passed");
+    return 0;
+}
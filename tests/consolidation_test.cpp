@@ -0,0 +1,222 @@
+// consolidation_test - FibonacciHeap's incremental consolidation: with any
+// budget the minimum stays exact and the trees heap-ordered, each
+// operation links only its share, and the work left is finished by
+// consolidate() or by extractMin()s after a large merge
+
+#include "FibonacciHeap.hpp"
+#include "TestCheck.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace {
+
+struct LinkCounter : NullHeapObserver {
+    size_t links = 0;
+    size_t cuts = 0;
+    template <typename Node> void linked(const Node*, const Node*) { links++; }
+    template <typename Node> void cut(const Node*, const Node*) { cuts++; }
+};
+
+using Heap = FibonacciHeap<int, LinkCounter>;
+
+size_t checkSubtree(const Heap& heap, const Heap::Node* node) {
+    size_t count = 1;
+    int degree = 0;
+    for (Heap::Node* child : heap.children(node)) {
+        CHECK(child->parent == node && child->key >= node->key);
+        degree++;
+        count += checkSubtree(heap, child);
+    }
+    CHECK(degree == node->degree);
+    return count;
+}
+
+// Heap order, degrees and parent links of every tree, with the minimum
+// among the roots; returns the number of roots
+size_t checkTrees(const Heap& heap) {
+    size_t roots = 0;
+    size_t count = 0;
+    for (Heap::Node* root : heap.roots()) {
+        CHECK(root->parent == nullptr && root->key >= heap.getMin()->key);
+        roots++;
+        count += checkSubtree(heap, root);
+    }
+    CHECK(count == static_cast<size_t>(heap.getSize()));
+    return roots;
+}
+
+// After consolidate() no two roots have the same degree
+void checkConsolidated(Heap& heap) {
+    heap.consolidate();
+    std::set<int> degrees;
+    for (Heap::Node* root : heap.roots()) CHECK(degrees.insert(root->degree).second);
+    checkTrees(heap);
+}
+
+void testRandomOperations(int budget) {
+    std::mt19937 rng(47 + static_cast<unsigned>(budget));
+    Heap heap;
+    heap.setConsolidationBudget(budget);
+    CHECK(heap.getConsolidationBudget() == budget);
+    std::multiset<int> keys;
+    std::vector<Heap::Node*> live;
+    auto forget = [&](Heap::Node* node) {
+        keys.erase(keys.find(node->key));
+        live.erase(std::find(live.begin(), live.end(), node));
+    };
+    for (int step = 0; step < 20000; ++step) {
+        LinkCounter& counter = heap.getObserver();
+        size_t links = counter.links;
+        size_t cuts = counter.cuts;
+        int op = static_cast<int>(rng() % 20);
+        if (live.empty() || op < 8) {
+            int key = static_cast<int>(rng() % 100000);
+            live.push_back(heap.insert(step, key));
+            keys.insert(key);
+            // its share: at most budget links for the one new root
+            CHECK(counter.links - links <= static_cast<size_t>(budget));
+        } else if (op < 12) {
+            Heap::Node* min = heap.extractMin();
+            CHECK(min->key == *keys.begin());
+            forget(min);
+            heap.release(min);
+        } else if (op < 16) {
+            Heap::Node* node = live[rng() % live.size()];
+            keys.erase(keys.find(node->key));
+            heap.decreaseKey(node, node->key - 1 - static_cast<int>(rng() % 20000));
+            keys.insert(node->key);
+            // each cut adds a root, and may send its parent back to pending
+            size_t added = std::max<size_t>(2 * (counter.cuts - cuts), 1);
+            CHECK(counter.links - links <= static_cast<size_t>(budget) * added);
+        } else if (op < 19) {
+            Heap::Node* node = live[rng() % live.size()];
+            forget(node);
+            heap.deleteNode(node);
+        } else {
+            Heap other;
+            other.setConsolidationBudget(static_cast<int>(rng() % 3));
+            for (int i = 0; i < 30; ++i) {
+                int key = static_cast<int>(rng() % 100000);
+                live.push_back(other.insert(-i, key));
+                keys.insert(key);
+            }
+            heap.merge(other);
+            CHECK(other.isEmpty());
+            // the emptied heap starts over
+            other.insert(0, 7);
+            other.insert(0, 3);
+            Heap::Node* min = other.extractMin();
+            CHECK(min->key == 3 && other.getMin()->key == 7 && other.getSize() == 1);
+            other.release(min);
+        }
+        CHECK(heap.getSize() == static_cast<int>(keys.size()));
+        if (!keys.empty()) CHECK(heap.getMin()->key == *keys.begin());
+        if (step % 50 == 0) checkTrees(heap);
+        if (step % 1000 == 0) checkConsolidated(heap);
+    }
+    checkConsolidated(heap);
+    for (int key : keys) {
+        Heap::Node* min = heap.extractMin();
+        CHECK(min->key == key);
+        heap.release(min);
+    }
+    CHECK(heap.isEmpty() && heap.getMin() == nullptr);
+}
+
+// Two or more steps per new root file the roots as they come, so runs of
+// inserts and of extractMin()s keep about one root per degree
+void testKeepingUp(int budget) {
+    Heap heap;
+    heap.setConsolidationBudget(budget);
+    for (int i = 1; i <= 50000; ++i) {
+        heap.insert(i, (i * 7919) % 50000);
+        if (i % 100 == 0) CHECK(checkTrees(heap) <= std::log2(i) + 2);
+    }
+    for (int i = 0; i < 20000; ++i) {
+        heap.release(heap.extractMin());
+        if (i % 100 == 0) CHECK(checkTrees(heap) <= std::log2(heap.getSize()) + 2);
+    }
+}
+
+// A large merge leaves a backlog of pending roots; every extractMin()
+// files a quarter of it, so it shrinks geometrically
+void testMergeBacklog() {
+    Heap heap;
+    heap.setConsolidationBudget(2);
+    for (int i = 0; i < 100; ++i) heap.insert(i, 50000 + i);
+    Heap other;  // eager, and never extracted from: 20000 single roots
+    for (int i = 0; i < 20000; ++i) other.insert(i, (i * 7919) % 20000);
+    heap.merge(other);
+    size_t roots = checkTrees(heap);
+    CHECK(roots > 20000);
+
+    int previous = -1;
+    for (int round = 0; round < 60; ++round) {
+        Heap::Node* min = heap.extractMin();
+        CHECK(min->key >= previous);
+        previous = min->key;
+        heap.release(min);
+        if (round % 10 == 9) {
+            size_t now = checkTrees(heap);
+            CHECK(now < roots);
+            roots = now;
+        }
+    }
+    CHECK(roots < 200);
+    checkConsolidated(heap);
+}
+
+// Switching between eager and incremental keeps the heap whole; roots
+// already there become pending work
+void testSwitchingBudget() {
+    Heap heap;
+    CHECK(heap.getConsolidationBudget() == 0);
+    CHECK_THROWS(heap.setConsolidationBudget(-1));
+    std::vector<Heap::Node*> nodes;
+    for (int i = 0; i < 1000; ++i) nodes.push_back(heap.insert(i, (i * 31) % 1000));
+    CHECK(checkTrees(heap) == 1000);  // eager inserts never link
+
+    heap.setConsolidationBudget(3);
+    for (int i = 0; i < 50; ++i) heap.insert(-i, 2000 + i);  // three steps each
+    size_t roots = checkTrees(heap);
+    CHECK(roots < 1050);
+    // even an operation that adds no root does its share
+    for (int i = 0; i < 100; ++i) heap.decreaseKey(nodes[static_cast<size_t>(i)], nodes[static_cast<size_t>(i)]->key);
+    CHECK(checkTrees(heap) < roots - 100);
+    heap.decreaseKey(nodes[500], -1);
+    CHECK(heap.getMin() == nodes[500]);
+    heap.release(heap.extractMin());
+    CHECK(heap.getMin()->key == 0);  // found among the roots still pending
+
+    heap.setConsolidationBudget(0);
+    heap.release(heap.extractMin());  // eager: the whole root list at once
+    std::set<int> degrees;
+    for (Heap::Node* root : heap.roots()) CHECK(degrees.insert(root->degree).second);
+    checkTrees(heap);
+
+    heap.setConsolidationBudget(1);
+    int previous = heap.getMin()->key;
+    while (!heap.isEmpty()) {
+        Heap::Node* min = heap.extractMin();
+        CHECK(min->key >= previous);
+        previous = min->key;
+        heap.release(min);
+    }
+}
+
+} // namespace
+
+int main() {
+    for (int budget = 0; budget <= 4; ++budget) testRandomOperations(budget);
+    testKeepingUp(2);
+    testKeepingUp(3);
+    testMergeBacklog();
+    testSwitchingBudget();
+    std::puts("consolidation_test passed");
+    return 0;
+}
@@ -0,0 +1,243 @@
+// delete_node_test - FibonacciHeap::deleteNode() removes a node in place:
+// its children become roots, its parent loses it with the usual cascading
+// cut, nothing is linked unless it was the minimum, and any key works
+
+#include "FibonacciHeap.hpp"
+#include "TestCheck.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstdio>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace {
+
+struct EventCounter : NullHeapObserver {
+    size_t links = 0;
+    size_t cuts = 0;
+    size_t marks = 0;
+    size_t extracted_ = 0;
+    size_t keyChanges = 0;
+    template <typename Node> void linked(const Node*, const Node*) { links++; }
+    template <typename Node> void cut(const Node*, const Node*) { cuts++; }
+    template <typename Node> void marked(const Node*) { marks++; }
+    template <typename Node> void extracted(const Node*) { extracted_++; }
+    template <typename Node> void keyChanged(const Node*, int) { keyChanges++; }
+};
+
+using Heap = FibonacciHeap<int, EventCounter>;
+
+size_t checkSubtree(const Heap& heap, const Heap::Node* node) {
+    size_t count = 1;
+    int degree = 0;
+    for (Heap::Node* child : heap.children(node)) {
+        CHECK(child->parent == node && child->key >= node->key);
+        degree++;
+        count += checkSubtree(heap, child);
+    }
+    CHECK(degree == node->degree);
+    return count;
+}
+
+// Heap order and degrees of every tree; returns the number of roots
+size_t checkTrees(const Heap& heap) {
+    size_t roots = 0;
+    size_t count = 0;
+    for (Heap::Node* root : heap.roots()) {
+        CHECK(root->parent == nullptr && root->key >= heap.getMin()->key);
+        roots++;
+        count += checkSubtree(heap, root);
+    }
+    CHECK(count == static_cast<size_t>(heap.getSize()));
+    return roots;
+}
+
+// A heap of a few tall trees, some nodes marked
+void build(Heap& heap, std::vector<Heap::Node*>& nodes, int count) {
+    for (int i = 0; i < count; ++i) nodes.push_back(heap.insert(i, (i * 7919) % count + 10));
+    Heap::Node* min = heap.extractMin();
+    nodes.erase(std::find(nodes.begin(), nodes.end(), min));
+    heap.release(min);
+}
+
+int depth(const Heap::Node* node) {
+    int d = 0;
+    for (; node->parent; node = node->parent) d++;
+    return d;
+}
+
+// Leaves, inner nodes and roots leave without any linking; their
+// children stay in the heap as roots
+void testInPlace() {
+    Heap heap;
+    std::vector<Heap::Node*> nodes;
+    build(heap, nodes, 2000);
+    EventCounter& events = heap.getObserver();
+    Heap::Node* min = heap.getMin();
+
+    // a leaf two levels down, under an unmarked parent: one cut, one mark
+    auto leaf = std::find_if(nodes.begin(), nodes.end(), [](Heap::Node* n) {
+        return !n->child && depth(n) >= 2 && !n->parent->marked;
+    });
+    CHECK(leaf != nodes.end());
+    Heap::Node* parent = (*leaf)->parent;
+    size_t roots = checkTrees(heap);
+    EventCounter before = events;
+    heap.deleteNode(*leaf);
+    nodes.erase(leaf);
+    CHECK(events.cuts == before.cuts + 1 && events.marks == before.marks + 1 && parent->marked);
+    CHECK(events.extracted_ == before.extracted_ + 1 && events.links == before.links);
+    CHECK(events.keyChanges == before.keyChanges);
+    CHECK(checkTrees(heap) == roots && heap.getMin() == min && heap.getSize() == 1998);
+
+    // an inner node: its children are cut and join the roots
+    auto inner = std::find_if(nodes.begin(), nodes.end(), [&](Heap::Node* n) {
+        return n->degree >= 2 && n->parent && !n->parent->marked && n->parent->parent;
+    });
+    CHECK(inner != nodes.end());
+    int degree = (*inner)->degree;
+    roots = checkTrees(heap);
+    before = events;
+    heap.deleteNode(*inner);
+    nodes.erase(inner);
+    CHECK(events.cuts == before.cuts + 1 + static_cast<size_t>(degree) && events.links == before.links);
+    CHECK(checkTrees(heap) == roots + static_cast<size_t>(degree) && heap.getMin() == min);
+
+    // a root other than the minimum: its children replace it
+    auto root = std::find_if(nodes.begin(), nodes.end(), [&](Heap::Node* n) {
+        return !n->parent && n != min && n->degree >= 2;
+    });
+    CHECK(root != nodes.end());
+    degree = (*root)->degree;
+    roots = checkTrees(heap);
+    before = events;
+    heap.deleteNode(*root);
+    nodes.erase(root);
+    CHECK(events.cuts == before.cuts + static_cast<size_t>(degree) && events.links == before.links);
+    CHECK(checkTrees(heap) == roots - 1 + static_cast<size_t>(degree) && heap.getMin() == min);
+
+    // the minimum goes through extractMin(), which consolidates
+    before = events;
+    heap.deleteNode(min);
+    nodes.erase(std::find(nodes.begin(), nodes.end(), min));
+    CHECK(events.links > before.links && events.extracted_ == before.extracted_ + 1);
+    std::set<int> degrees;
+    for (Heap::Node* r : heap.roots()) CHECK(degrees.insert(r->degree).second);
+    checkTrees(heap);
+    heap.deleteNode(nullptr);
+    CHECK(heap.getSize() == static_cast<int>(nodes.size()));
+}
+
+// A marked parent losing a second child is cut too, and so on up
+void testCascadingCut() {
+    Heap heap;
+    std::vector<Heap::Node*> nodes;
+    build(heap, nodes, 1024);
+    // a node two levels down with at least two children, none marked
+    auto found = std::find_if(nodes.begin(), nodes.end(), [](Heap::Node* n) {
+        return n->degree >= 2 && !n->marked && depth(n) >= 2 && !n->parent->marked;
+    });
+    CHECK(found != nodes.end());
+    Heap::Node* parent = *found;
+    Heap::Node* grandparent = parent->parent;
+    Heap::Node* first = parent->child;
+    Heap::Node* second = first->right;
+    heap.deleteNode(first);
+    CHECK(parent->marked && parent->parent == grandparent && !grandparent->marked);
+    heap.deleteNode(second);
+    CHECK(parent->parent == nullptr && !parent->marked && grandparent->marked);
+    checkTrees(heap);
+}
+
+// Keys far below any sentinel are deleted like the others
+void testAnyKey() {
+    Heap heap;
+    std::multiset<int> keys;
+    std::vector<Heap::Node*> nodes;
+    for (int key : {INT_MIN, INT_MIN + 1, -2000000, -1000000, -999999, 0, INT_MAX}) {
+        for (int i = 0; i < 3; ++i) {
+            nodes.push_back(heap.insert(i, key));
+            keys.insert(key);
+        }
+    }
+    Heap::Node* min = heap.extractMin();
+    CHECK(min->key == INT_MIN);
+    keys.erase(keys.begin());
+    nodes.erase(std::find(nodes.begin(), nodes.end(), min));
+    heap.release(min);
+    for (size_t i = 0; i < nodes.size(); i += 2) {
+        keys.erase(keys.find(nodes[i]->key));
+        heap.deleteNode(nodes[i]);
+        checkTrees(heap);
+        CHECK(heap.getMin()->key == *keys.begin());
+    }
+    for (int key : keys) {
+        Heap::Node* next = heap.extractMin();
+        CHECK(next->key == key);
+        heap.release(next);
+    }
+    CHECK(heap.isEmpty());
+}
+
+// Random deletes among the other operations, eager and incremental
+void testRandomOperations(int budget) {
+    std::mt19937 rng(48 + static_cast<unsigned>(budget));
+    Heap heap;
+    heap.setConsolidationBudget(budget);
+    std::multiset<int> keys;
+    std::vector<Heap::Node*> live;
+    for (int step = 0; step < 20000; ++step) {
+        int op = static_cast<int>(rng() % 10);
+        if (live.empty() || op < 4) {
+            int key = static_cast<int>(rng() % 2000000) - 1000000;
+            live.push_back(heap.insert(step, key));
+            keys.insert(key);
+        } else if (op < 5) {
+            Heap::Node* min = heap.extractMin();
+            keys.erase(keys.find(min->key));
+            live.erase(std::find(live.begin(), live.end(), min));
+            heap.release(min);
+        } else if (op < 7) {
+            size_t i = rng() % live.size();
+            keys.erase(keys.find(live[i]->key));
+            heap.decreaseKey(live[i], live[i]->key - static_cast<int>(rng() % 100000));
+            keys.insert(live[i]->key);
+        } else if (op < 8) {
+            // an increase deletes the node and inserts the value anew
+            size_t i = rng() % live.size();
+            int value = live[i]->value;
+            int key = live[i]->key + 1 + static_cast<int>(rng() % 100000);
+            keys.erase(keys.find(live[i]->key));
+            live[i] = heap.updateKey(live[i], key);
+            keys.insert(key);
+            CHECK(live[i]->key == key && live[i]->value == value);
+        } else {
+            size_t i = rng() % live.size();
+            keys.erase(keys.find(live[i]->key));
+            heap.deleteNode(live[i]);
+            live.erase(live.begin() + static_cast<std::ptrdiff_t>(i));
+        }
+        CHECK(heap.getSize() == static_cast<int>(keys.size()));
+        if (!keys.empty()) CHECK(heap.getMin()->key == *keys.begin());
+        if (step % 100 == 0) checkTrees(heap);
+    }
+    for (int key : keys) {
+        Heap::Node* min = heap.extractMin();
+        CHECK(min->key == key);
+        heap.release(min);
+    }
+}
+
+} // namespace
+
+int main() {
+    testInPlace();
+    testCascadingCut();
+    testAnyKey();
+    testRandomOperations(0);
+    testRandomOperations(2);
+    std::puts("delete_node_test passed");
+    return 0;
+}
@@ -0,0 +1,110 @@
+// heap_canvas_test - HeapCanvas on the offscreen platform: zoomToFit()
+// brings the whole heap into view, and the frame-time overlay draws only
+// over its corner of the canvas
+
+#include "MainWindow.h"
+#include "TestCheck.hpp"
+#include <QApplication>
+#include <QImage>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+
+namespace {
+
+const int WIDTH = 1600;
+const int HEIGHT = 900;
+
+// Wide enough to run off the canvas at 1x, small enough to fit above the
+// minimum zoom
+std::shared_ptr<HeapScene> layOutHeap(int nodes) {
+    VisualHeap heap;
+    heap.getObserver().setRecording(false);
+    std::mt19937 rng(46);
+    for (int i = 0; i < nodes; ++i) {
+        int key = static_cast<int>(rng() % 100000);
+        heap.insert(key, key);
+    }
+    heap.release(heap.extractMin());
+    return HeapWorker::layOut(heap, 1);
+}
+
+// The bounding box of everything drawn over the white background
+QRect inked(const QImage& image) {
+    QRect box;
+    for (int y = 0; y < image.height(); ++y) {
+        for (int x = 0; x < image.width(); ++x) {
+            if (image.pixel(x, y) != qRgb(255, 255, 255)) box |= QRect(x, y, 1, 1);
+        }
+    }
+    return box;
+}
+
+void testZoomToFit() {
+    std::shared_ptr<HeapScene> scene = layOutHeap(300);
+    CHECK(scene->layoutMs > 0);
+    AnimationSystem animation;
+    HeapCanvas canvas(&animation);
+    canvas.resize(WIDTH, HEIGHT);
+    QImage image(WIDTH, HEIGHT, QImage::Format_ARGB32_Premultiplied);
+
+    // nothing to fit on an empty canvas
+    canvas.zoomToFit();
+    canvas.render(&image);
+    CHECK(!inked(image).isEmpty());  // the empty-heap message
+
+    canvas.setScene(scene);
+    canvas.render(&image);
+    CHECK(inked(image).right() > WIDTH * 9 / 10);  // at 1x the heap runs off the canvas
+
+    // fitted, it is inside with a margin, centred and as large as fits
+    canvas.zoomToFit();
+    canvas.render(&image);
+    QRect fitted = inked(image);
+    CHECK(fitted.left() > 0 && fitted.top() > 0 && fitted.right() < WIDTH - 1 && fitted.bottom() < HEIGHT - 1);
+    CHECK(fitted.width() > WIDTH * 9 / 10 || fitted.height() > HEIGHT * 9 / 10);
+    CHECK(std::abs(fitted.center().x() - WIDTH / 2) < WIDTH / 20);
+    CHECK(std::abs(fitted.center().y() - HEIGHT / 2) < HEIGHT / 20);
+}
+
+// The overlay sits in the bottom left corner and leaves the rest alone
+void testFrameStats() {
+    AnimationSystem animation;
+    HeapCanvas canvas(&animation);
+    canvas.resize(WIDTH, HEIGHT);
+    canvas.setScene(layOutHeap(300));
+    QImage plain(WIDTH, HEIGHT, QImage::Format_ARGB32_Premultiplied);
+    canvas.render(&plain);
+    canvas.zoomToFit();
+    canvas.render(&plain);
+
+    canvas.setFrameStatsVisible(true);
+    QImage stats(WIDTH, HEIGHT, QImage::Format_ARGB32_Premultiplied);
+    for (int frame = 0; frame < 3; ++frame) canvas.render(&stats);
+    int changed = 0;
+    for (int y = 0; y < HEIGHT; ++y) {
+        for (int x = 0; x < WIDTH; ++x) {
+            if (stats.pixel(x, y) == plain.pixel(x, y)) continue;
+            CHECK(x < WIDTH / 2 && y > HEIGHT / 2);
+            changed++;
+        }
+    }
+    CHECK(changed > 1000);
+
+    canvas.setFrameStatsVisible(false);
+    QImage hidden(WIDTH, HEIGHT, QImage::Format_ARGB32_Premultiplied);
+    canvas.render(&hidden);
+    CHECK(hidden == plain);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+    testZoomToFit();
+    testFrameStats();
+    std::puts("heap_canvas_test passed");
+    return 0;
+}
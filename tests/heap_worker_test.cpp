@@ -0,0 +1,215 @@
+// heap_worker_test - HeapWorker on a thread of its own: bursts of commands
+// coalesced into one scene, commands on nodes from an old scene refused,
+// and random insert runs that queued commands can overtake or cancel
+
+#include "HeapWorker.h"
+#include "TestCheck.hpp"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QThread>
+#include <cstddef>
+#include <cstdio>
+#include <future>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Runs a worker as MainWindow does, and collects what it sends back
+struct Harness {
+    QThread thread;
+    HeapWorker* worker = new HeapWorker;
+    QObject receiver;  // on the test's thread, so signals arrive queued
+    std::vector<HeapScenePtr> scenes;
+    std::vector<std::string> messages;
+    std::promise<void> gate;
+
+    Harness() {
+        worker->moveToThread(&thread);
+        QObject::connect(&thread, &QThread::finished, worker, &QObject::deleteLater);
+        QObject::connect(worker, &HeapWorker::sceneReady, &receiver,
+                         [this](HeapScenePtr scene) { scenes.push_back(std::move(scene)); });
+        QObject::connect(worker, &HeapWorker::commandDone, &receiver,
+                         [this](const QString& message) { messages.push_back(message.toStdString()); });
+        thread.start();
+    }
+    ~Harness() {
+        thread.quit();
+        thread.wait();
+    }
+
+    template <typename Command> void post(Command command) {
+        QMetaObject::invokeMethod(worker, std::move(command), Qt::QueuedConnection);
+    }
+
+    // Holds the worker's queue until release(), so the commands posted
+    // meanwhile are all waiting when it resumes
+    void hold() {
+        gate = std::promise<void>();
+        post([ready = gate.get_future().share()] { ready.wait(); });
+    }
+    void release() { gate.set_value(); }
+
+    template <typename Done> void waitFor(Done done) {
+        QElapsedTimer timer;
+        timer.start();
+        while (!done()) {
+            CHECK(timer.elapsed() < 30000);
+            QCoreApplication::processEvents();
+            QThread::msleep(1);
+        }
+    }
+    void waitForVersion(uint64_t version) {
+        waitFor([&] { return !scenes.empty() && scenes.back()->version >= version; });
+        CHECK(scenes.back()->version == version);
+    }
+    void waitForMessage(const std::string& message) {
+        waitFor([&] { return !messages.empty() && messages.back() == message; });
+    }
+
+    const HeapScene& latest() const { return *scenes.back(); }
+};
+
+const char* const REFUSED = "The heap changed since the node was selected - please select it again";
+
+int entryWithKey(const HeapScene& scene, int key) {
+    for (int i = 0; i < scene.size(); ++i) {
+        if (scene.nodes[i].key == key) return i;
+    }
+    return -1;
+}
+
+// Commands queued together are published as one scene, carrying the
+// records of all of them
+void testCoalescedScenes() {
+    Harness h;
+    h.hold();
+    for (int i = 0; i < 50; ++i) h.post([w = h.worker, i] { w->insert(50 - i); });
+    h.release();
+    h.waitForVersion(50);
+    CHECK(h.scenes.size() == 1 && h.messages.size() == 50);
+    CHECK(h.messages.front() == "Inserted: 50" && h.messages.back() == "Inserted: 1");
+    const HeapScene& first = h.latest();
+    CHECK(first.size() == 50 && first.min()->key == 1 && !first.hasChanges);
+    int operations = 0;
+    int inserts = 0;
+    for (const AnimationRecord& record : first.records) {
+        operations += record.type == AnimationRecord::OPERATION && record.operation == AnimationRecord::OP_INSERT;
+        inserts += record.type == AnimationRecord::INSERT;
+    }
+    CHECK(operations == 50 && inserts == 50);
+
+    // the next scene only carries what happened since, and notes where
+    // it differs from the first
+    h.post([w = h.worker] { w->extractMin(); });
+    h.waitForVersion(51);
+    CHECK(h.scenes.size() == 2 && h.messages.back() == "Extracted min: 1");
+    const HeapScene& second = h.latest();
+    CHECK(second.size() == 49 && second.min()->key == 2);
+    CHECK(second.hasChanges && second.changesSince == 50 && !second.changedAreas.empty());
+    CHECK(second.records.front().operation == AnimationRecord::OP_EXTRACT_MIN);
+
+    h.post([w = h.worker] { w->extractMin(); });
+    h.waitForVersion(52);
+    for (int i = 0; i < 48; ++i) h.post([w = h.worker] { w->extractMin(); });
+    h.waitForVersion(100);
+    CHECK(h.latest().empty() && h.latest().min() == nullptr);
+    h.post([w = h.worker] { w->extractMin(); });
+    h.waitForMessage("Heap is empty");
+}
+
+// A node picked from an old scene is refused and the heap left alone;
+// picked from the current one it is changed
+void testStaleSelection() {
+    Harness h;
+    for (int key = 1; key <= 10; ++key) h.post([w = h.worker, key] { w->insert(key); });
+    h.post([w = h.worker] { w->extractMin(); });
+    h.waitForVersion(11);
+    const void* id = h.latest().nodes[entryWithKey(h.latest(), 9)].id;
+    quint64 old = h.latest().version;
+
+    h.post([w = h.worker] { w->insert(100); });
+    h.post([w = h.worker, id, old] { w->deleteNode(id, old); });
+    h.post([w = h.worker, id, old] { w->decreaseKey(id, -5, old); });
+    h.waitForVersion(12);
+    h.waitFor([&] { return h.messages.size() == 14; });
+    CHECK(h.messages[11] == "Inserted: 100" && h.messages[12] == REFUSED && h.messages[13] == REFUSED);
+    CHECK(h.latest().size() == 10 && h.latest().indexOf(id) == entryWithKey(h.latest(), 9));
+
+    // a key above the current one is an error that changes nothing
+    quint64 current = h.latest().version;
+    h.post([w = h.worker, id, current] { w->decreaseKey(id, 50, current); });
+    h.waitFor([&] { return h.messages.size() == 15; });
+    CHECK(h.messages.back().rfind("Error: ", 0) == 0);
+
+    h.post([w = h.worker, id, current] { w->decreaseKey(id, -5, current); });
+    h.waitForVersion(13);
+    CHECK(h.messages.back() == "Decreased key to -5");
+    CHECK(h.latest().min()->id == id && h.latest().min()->key == -5);
+
+    current = h.latest().version;
+    h.post([w = h.worker, id, current] { w->deleteNode(id, current); });
+    h.waitForVersion(14);
+    CHECK(h.messages.back() == "Deleted node with key -5");
+    CHECK(h.latest().size() == 9 && h.latest().indexOf(id) == -1 && h.latest().min()->key == 2);
+}
+
+// A random insert run goes chunk by chunk, and a command posted behind
+// it is done before the run is
+void testBulkInsert() {
+    Harness h;
+    h.hold();
+    h.post([w = h.worker] { w->insertRandom(50000); });
+    h.post([w = h.worker] { w->insert(-5); });
+    h.release();
+    h.waitForMessage("Inserted 50000 random values");
+    CHECK(h.messages.size() == 2 && h.messages.front() == "Inserted: -5");
+    h.waitForVersion(4);  // the insert and three chunks
+    CHECK(h.latest().size() == 50001 && h.latest().min()->key == -5);
+    for (size_t i = 1; i < h.scenes.size(); ++i) CHECK(h.scenes[i]->version > h.scenes[i - 1]->version);
+
+    // the run is recorded as one operation
+    int runs = 0;
+    int inserts = 0;
+    for (const HeapScenePtr& scene : h.scenes) {
+        for (const AnimationRecord& record : scene->records) {
+            runs += record.type == AnimationRecord::OPERATION && record.operation == AnimationRecord::OP_INSERT_RANDOM;
+            inserts += record.type == AnimationRecord::INSERT;
+        }
+    }
+    CHECK(runs == 1 && inserts == 1);
+}
+
+// reset() empties the heap and ends a run after its current chunk
+void testResetStopsRun() {
+    Harness h;
+    h.hold();
+    h.post([w = h.worker] { w->insertRandom(1000000); });
+    h.post([w = h.worker] { w->reset(); });
+    h.release();
+    h.waitForMessage("Heap reset - Ready to insert new values");
+    h.post([w = h.worker] { w->insert(3); });
+    h.waitForVersion(3);  // one chunk, the reset and the insert
+    CHECK(h.latest().size() == 1 && h.latest().min()->key == 3);
+    CHECK(h.messages.size() == 2 && h.messages.back() == "Inserted: 3");
+
+    // a new run starts from scratch
+    h.post([w = h.worker] { w->insertRandom(100); });
+    h.waitForMessage("Inserted 100 random values");
+    h.waitForVersion(4);
+    CHECK(h.latest().size() == 101 && h.messages.size() == 3);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    qRegisterMetaType<HeapScenePtr>();
+    testCoalescedScenes();
+    testStaleSelection();
+    testBulkInsert();
+    testResetStopsRun();
+    std::puts("heap_worker_test passed");
+    return 0;
+}
@@ -0,0 +1,201 @@
+// heap_wrapper_test - the type-erased heap interface (HeapInterface.h)
+// over HeapWrapper<T>: handles, batched inserts and key updates, and
+// collectNodes, all driven through IFibonacciHeap as the GUI would
+
+#include "HeapWrapper.h"
+#include "TestCheck.hpp"
+#include <QStringList>
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <vector>
+
+namespace {
+
+// Every handle reachable from the roots carries the heap's type tag and
+// agrees with the node it points at
+size_t checkTree(HeapNodeHandle first, HeapNodeHandle parent, const HeapNodeOps* type) {
+    size_t count = 0;
+    HeapNodeHandle node = first;
+    do {
+        CHECK(node.type() == type);
+        CHECK(node.getParent() == parent);
+        CHECK(node.getRight().getLeft() == node);
+        if (parent) CHECK(node.getKey() >= parent.getKey());
+        count++;
+        if (node.getChild()) count += checkTree(node.getChild(), node, type);
+        node = node.getRight();
+    } while (node != first);
+    return count;
+}
+
+void testBatchInsert() {
+    std::unique_ptr<IFibonacciHeap> heap(new HeapWrapper<int>());
+    std::vector<HeapNodeHandle> inserted;
+    heap->insertBatch(QStringList{"50", "30", "70", "10", "40"}, {50, 30, 70, 10, 40}, &inserted);
+
+    CHECK(heap->getSize() == 5);
+    CHECK(inserted.size() == 5);
+    for (HeapNodeHandle handle : inserted) CHECK(handle.type() == heap->nodeType());
+    CHECK(inserted[1].getDisplayValue() == QString::number(30));
+    CHECK(heap->getMin() == inserted[3]);
+    CHECK(heap->getMin().getKey() == 10);
+
+    // Mismatched lengths insert the common prefix; the output is optional
+    heap->insertBatch(QStringList{"1", "2", "3"}, {1, 2});
+    CHECK(heap->getSize() == 7);
+    CHECK(heap->getMin().getDisplayValue() == QString::number(1));
+}
+
+void testUpdateKeys() {
+    std::unique_ptr<IFibonacciHeap> heap(new HeapWrapper<int>());
+    std::vector<HeapNodeHandle> nodes;
+    QStringList values;
+    std::vector<int> keys;
+    for (int i = 0; i < 32; ++i) {
+        values << QString::number(i);
+        keys.push_back(100 + i);
+    }
+    heap->insertBatch(values, keys, &nodes);
+    // Build some trees, so decreases cut nodes out of them
+    std::optional<HeapEntry> first = heap->extractMin();
+    CHECK(first && first->key == 100 && first->displayValue == QString::number(0));
+
+    KeyUpdate updates[] = {
+        {nodes[20], 5},    // decrease to the new minimum
+        {nodes[5], 500},   // increase: the value moves to a new node
+        {nodes[9], 109},   // unchanged
+    };
+    heap->updateKeys(updates, 3);
+
+    CHECK(updates[0].node == nodes[20]);
+    CHECK(heap->getMin() == nodes[20]);
+    CHECK(updates[1].node.getKey() == 500);
+    CHECK(updates[1].node.getDisplayValue() == QString::number(5));
+    CHECK(updates[2].node.getKey() == 109);
+    CHECK(heap->getSize() == 31);
+    CHECK(checkTree(heap->getMin(), HeapNodeHandle(), heap->nodeType()) == 31);
+
+    // Handles from another payload type are ignored
+    HeapWrapper<std::string> other;
+    KeyUpdate foreign[] = {{other.insert("x", 1), 0}};
+    heap->updateKeys(foreign, 1);
+    CHECK(heap->getMin() == nodes[20]);
+
+    int previous = -1;
+    std::vector<QString> order;
+    while (!heap->isEmpty()) {
+        std::optional<HeapEntry> entry = heap->extractMin();
+        CHECK(entry && entry->key >= previous);
+        previous = entry->key;
+        order.push_back(entry->displayValue);
+    }
+    CHECK(order.size() == 31);
+    CHECK(order.front() == QString::number(20));
+    CHECK(order.back() == QString::number(5));
+    CHECK(!heap->extractMin());
+}
+
+void testCollectNodes() {
+    std::unique_ptr<IFibonacciHeap> heap(new HeapWrapper<std::string>());
+    QStringList values;
+    std::vector<int> keys;
+    for (int i = 0; i < 20; ++i) {
+        values << QString::fromStdString("patient-" + std::to_string(i));
+        keys.push_back((i * 7) % 20);
+    }
+    std::vector<HeapNodeHandle> inserted;
+    heap->insertBatch(values, keys, &inserted);
+    heap->extractMin();
+    heap->deleteNode(inserted[4]);
+
+    std::vector<HeapNodeHandle> collected;
+    heap->collectNodes(collected);
+    CHECK(collected.size() == 18);
+    CHECK(collected.front() == heap->getMin());
+    CHECK(checkTree(heap->getMin(), HeapNodeHandle(), heap->nodeType()) == 18);
+
+    std::vector<HeapNodeHandle> expected;
+    for (size_t i = 0; i < inserted.size(); ++i) {
+        if (i != 0 && i != 4) expected.push_back(inserted[i]);  // key 0 was extracted
+    }
+    auto byAddress = [](HeapNodeHandle a, HeapNodeHandle b) { return a.get() < b.get(); };
+    std::sort(collected.begin(), collected.end(), byAddress);
+    std::sort(expected.begin(), expected.end(), byAddress);
+    CHECK(collected == expected);
+
+    for (HeapNodeHandle root : heap->getRootList()) CHECK(!root.getParent());
+    CHECK(heap->search("patient-9").getKey() == 3);
+    CHECK(!heap->search("patient-4"));
+}
+
+void testMerge() {
+    HeapWrapper<int> a, b;
+    HeapWrapper<char> c;
+    a.insert("3", 3);
+    b.insert("1", 1);
+    b.insert("2", 2);
+    c.insert("z", 0);
+
+    a.merge(&c);  // different payload type: ignored
+    CHECK(a.getSize() == 1);
+    a.merge(&b);
+    CHECK(a.getSize() == 3);
+    CHECK(b.isEmpty());
+    CHECK(a.getMin().getDisplayValue() == QString::number(1));
+    CHECK(c.getMin().getDisplayValue() == "z");
+    CHECK(HeapWrapper<int>::nodeOf(c.getMin()) == nullptr);
+}
+
+// A payload that counts how often it is formatted for display
+struct Ticket {
+    static int formats;
+    int number = 0;
+    bool operator==(const Ticket& other) const { return number == other.number; }
+};
+int Ticket::formats = 0;
+
+std::ostream& operator<<(std::ostream& out, const Ticket& ticket) {
+    Ticket::formats++;
+    return out << "ticket " << ticket.number;
+}
+
+// A node's display string is formatted once and kept in the node: it
+// survives key changes, moves with an increased key, and a pool slot
+// reused after an extraction starts without it
+void testDisplayCache() {
+    HeapWrapper<Ticket> heap;
+    std::vector<HeapNodeHandle> nodes;
+    for (int i = 0; i < 8; ++i) nodes.push_back(heap.insert("", 10 + i));
+    CHECK(Ticket::formats == 0);
+    CHECK(nodes[3].getDisplayValue() == "ticket 0");
+    CHECK(nodes[3].getDisplayValue() == "ticket 0");
+    CHECK(Ticket::formats == 1);
+
+    heap.decreaseKey(nodes[3], 1);
+    KeyUpdate increase[] = {{nodes[3], 50}};
+    heap.updateKeys(increase, 1);
+    CHECK(increase[0].node.getKey() == 50);
+    CHECK(increase[0].node.getDisplayValue() == "ticket 0");
+    CHECK(Ticket::formats == 1);
+
+    std::optional<HeapEntry> min = heap.extractMin();
+    CHECK(min && min->key == 10 && min->displayValue == "ticket 0");
+    CHECK(Ticket::formats == 2);
+    HeapNodeHandle reused = heap.insert("", 5);  // may take the freed slot
+    CHECK(reused.getDisplayValue() == "ticket 0" && Ticket::formats == 3);
+}
+
+} // namespace
+
+int main() {
+    testBatchInsert();
+    testUpdateKeys();
+    testCollectNodes();
+    testMerge();
+    testDisplayCache();
+    std::puts("heap_wrapper_test passed");
+    return 0;
+}
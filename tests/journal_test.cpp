@@ -0,0 +1,248 @@
+// journal_test - recovery and durability ordering of the TaskManager's
+// snapshot + write-ahead log
+//
+// rename(), fsync() and fdatasync() are interposed to record the order in
+// which files and directory entries reach the disk, since a crash can
+// only be reasoned about through that order, and to inject sync failures.
+
+#include "TaskManager.h"
+#include "TestCheck.hpp"
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <dlfcn.h>
+#include <mutex>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+std::mutex eventsMutex;
+std::vector<std::string> events;  // "rename <to>" or "fsync <path>"
+std::atomic<bool> failDataSyncs(false);
+std::string failingFsync;  // fsync() of this path fails; guarded by eventsMutex
+
+std::string pathOfFd(int fd) {
+    char buffer[PATH_MAX];
+    std::string link = "/proc/self/fd/" + std::to_string(fd);
+    ssize_t n = ::readlink(link.c_str(), buffer, sizeof(buffer) - 1);
+    return n < 0 ? std::string() : std::string(buffer, static_cast<size_t>(n));
+}
+
+void record(const std::string& event) {
+    std::lock_guard<std::mutex> lock(eventsMutex);
+    events.push_back(event);
+}
+
+template <typename F>
+F real(const char* name) {
+    return reinterpret_cast<F>(::dlsym(RTLD_NEXT, name));
+}
+
+} // namespace
+
+extern "C" int rename(const char* from, const char* to) noexcept {
+    static auto next = real<int (*)(const char*, const char*)>("rename");
+    int result = next(from, to);
+    if (result == 0) {
+        char resolved[PATH_MAX];
+        record("rename " + std::string(::realpath(to, resolved) ? resolved : to));
+    }
+    return result;
+}
+
+extern "C" int fsync(int fd) {
+    static auto next = real<int (*)(int)>("fsync");
+    std::string path = pathOfFd(fd);
+    record("fsync " + path);
+    {
+        std::lock_guard<std::mutex> lock(eventsMutex);
+        if (!failingFsync.empty() && path == failingFsync) {
+            errno = EIO;
+            return -1;
+        }
+    }
+    return next(fd);
+}
+
+extern "C" int fdatasync(int fd) {
+    static auto next = real<int (*)(int)>("fdatasync");
+    record("fsync " + pathOfFd(fd));
+    if (failDataSyncs) {
+        errno = EIO;
+        return -1;
+    }
+    return next(fd);
+}
+
+namespace {
+
+struct TempDir {
+    std::string path;
+    TempDir() {
+        char name[] = "/tmp/journal_test.XXXXXX";
+        CHECK(::mkdtemp(name) != nullptr);
+        char resolved[PATH_MAX];
+        path = ::realpath(name, resolved);
+    }
+    ~TempDir() {
+        for (const char* file : {"tasks.wal", "tasks.wal.tmp", "tasks.snap", "tasks.snap.tmp"}) {
+            std::remove((path + "/" + file).c_str());
+        }
+        ::rmdir(path.c_str());
+    }
+};
+
+size_t indexOf(const std::vector<std::string>& log, const std::string& event, size_t from = 0) {
+    for (size_t i = from; i < log.size(); ++i) {
+        if (log[i] == event) return i;
+    }
+    return SIZE_MAX;
+}
+
+// A checkpoint may only rename the new snapshot into place once its data
+// is on disk, and only empty the log once the directory entry is durable; otherwise a crash can keep the empty log and the old
+// snapshot, losing everything logged in between.
+void testCheckpointOrder() {
+    TempDir dir;
+    TaskManager manager;
+    manager.enableJournal(dir.path, std::chrono::microseconds(0), 0);
+    manager.addPatient("alice", Urgency::URGENT);
+    manager.addPatient("bob", Urgency::MINOR);
+
+    {
+        std::lock_guard<std::mutex> lock(eventsMutex);
+        events.clear();
+    }
+    manager.checkpoint();
+    std::vector<std::string> log;
+    {
+        std::lock_guard<std::mutex> lock(eventsMutex);
+        log = events;
+    }
+
+    size_t snapshotRenamed = indexOf(log, "rename " + dir.path + "/tasks.snap");
+    size_t walRenamed = indexOf(log, "rename " + dir.path + "/tasks.wal");
+    CHECK(snapshotRenamed != SIZE_MAX);
+    CHECK(walRenamed != SIZE_MAX);
+    CHECK(indexOf(log, "fsync " + dir.path + "/tasks.snap.tmp") < snapshotRenamed);
+    size_t directorySynced = indexOf(log, "fsync " + dir.path, snapshotRenamed);
+    CHECK(directorySynced < walRenamed);
+}
+
+// Snapshot plus log replay restores the queue as it was left, including
+// changes made after the last checkpoint and a torn final record
+void testRecovery() {
+    TempDir dir;
+    {
+        TaskManager manager;
+        manager.enableJournal(dir.path, std::chrono::microseconds(1000), 0);
+        manager.addPatient("alice", Urgency::MODERATE);
+        manager.addPatient("bob", Urgency::MINOR);
+        manager.addPatient("carol", Urgency::URGENT);
+        manager.checkpoint();
+        manager.addPatient("dave", Urgency::CRITICAL);
+        manager.updatePatientStatus("bob", Urgency::MODERATE);
+        CHECK(manager.treatNext() == "dave");
+        manager.removeTask("alice");
+        manager.addPatient("erin", Urgency::MINOR);
+        manager.syncJournal();
+    }
+
+    // Half a record, as if the process died mid-write
+    FILE* wal = std::fopen((dir.path + "/tasks.wal").c_str(), "ab");
+    CHECK(wal != nullptr);
+    std::fwrite("\x20\x00\x00\x00\x01\x02", 1, 6, wal);
+    std::fclose(wal);
+
+    TaskManager recovered;
+    recovered.enableJournal(dir.path, std::chrono::microseconds(1000), 0);
+    CHECK(recovered.getPendingCount() == 3);
+    CHECK(recovered.findTask("alice") == nullptr);
+    CHECK(recovered.findTask("dave") == nullptr);
+    CHECK(recovered.findTask("bob") && recovered.findTask("bob")->urgency == Urgency::MODERATE);
+    CHECK(recovered.findTask("carol") && recovered.findTask("carol")->urgency == Urgency::URGENT);
+    CHECK(recovered.findTask("erin") && recovered.findTask("erin")->urgency == Urgency::MINOR);
+    CHECK(recovered.getNextUrgent() == "carol");
+}
+
+// A checkpoint whose snapshot or directory sync fails throws before the
+// log is emptied, and the old snapshot stays in place, so nothing is lost
+void testCheckpointFailure() {
+    TempDir dir;
+    {
+        TaskManager manager;
+        manager.enableJournal(dir.path, std::chrono::microseconds(0), 0);
+        manager.addPatient("alice", Urgency::MODERATE);
+        manager.checkpoint();
+        manager.addPatient("bob", Urgency::URGENT);
+
+        for (const std::string& failing : {dir.path + "/tasks.snap.tmp", dir.path}) {
+            {
+                std::lock_guard<std::mutex> lock(eventsMutex);
+                failingFsync = failing;
+            }
+            CHECK_THROWS(manager.checkpoint());
+            {
+                std::lock_guard<std::mutex> lock(eventsMutex);
+                failingFsync.clear();
+            }
+            int records = 0;
+            TaskJournal::replay(dir.path + "/tasks.wal", [&](JournalOp, const std::string&, int) { records++; });
+            CHECK(records == 1);
+            CHECK(::access((dir.path + "/tasks.snap").c_str(), F_OK) == 0);
+        }
+    }
+
+    TaskManager recovered;
+    recovered.enableJournal(dir.path, std::chrono::microseconds(0), 0);
+    CHECK(recovered.getPendingCount() == 2);
+    CHECK(recovered.getNextUrgent() == "bob");
+}
+
+// A failed write or sync on the flusher thread reaches the callers instead
+// of terminating the process, and nothing is reported durable after it
+void testFlusherError() {
+    TempDir dir;
+    TaskJournal journal(dir.path + "/tasks.wal", std::chrono::microseconds(1000));
+    journal.append(JournalOp::ADD, "alice", 2);
+    journal.sync();
+    uint64_t syncs = journal.syncCount();
+
+    failDataSyncs = true;
+    journal.append(JournalOp::ADD, "bob", 3);
+    CHECK_THROWS(journal.sync());
+    failDataSyncs = false;
+    CHECK(journal.syncCount() == syncs);
+    CHECK_THROWS(journal.sync());
+    CHECK_THROWS(journal.append(JournalOp::ADD, "carol", 1));
+}
+
+// Without a commit window the failing append() throws itself, and so does
+// every later one
+void testUnbatchedError() {
+    TempDir dir;
+    TaskJournal journal(dir.path + "/tasks.wal", std::chrono::microseconds(0));
+    journal.append(JournalOp::ADD, "alice", 2);
+
+    failDataSyncs = true;
+    CHECK_THROWS(journal.append(JournalOp::ADD, "bob", 3));
+    failDataSyncs = false;
+    CHECK_THROWS(journal.append(JournalOp::ADD, "carol", 1));
+    CHECK_THROWS(journal.sync());
+}
+
+} // namespace
+
+int main() {
+    testCheckpointOrder();
+    testRecovery();
+    testCheckpointFailure();
+    testFlusherError();
+    testUnbatchedError();
+    std::puts("journal_test passed");
+    return 0;
+}
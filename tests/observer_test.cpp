@@ -0,0 +1,184 @@
+// observer_test - FibonacciHeap's observer hooks: the events alone are
+// enough to follow the heap's structure exactly, through every operation
+
+#include "FibonacciHeap.hpp"
+#include "TestCheck.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// Rebuilds parent links, keys and marks from the events, and checks each
+// event against what it has seen so far
+struct ShadowObserver : NullHeapObserver {
+    struct Entry {
+        int key;
+        const void* parent;
+        bool marked;
+    };
+    std::unordered_map<const void*, Entry> nodes;
+    size_t events = 0;
+
+    template <typename Node> void inserted(const Node* node) {
+        // a new root, or a restored node whose parent was restored first
+        CHECK(nodes.count(node) == 0);
+        CHECK(!node->parent || nodes.count(node->parent) == 1);
+        nodes[node] = {node->key, node->parent, node->marked};
+        events++;
+    }
+    template <typename Node> void extracted(const Node* node) {
+        auto it = nodes.find(node);
+        CHECK(it != nodes.end() && it->second.parent == nullptr);
+        for (const auto& entry : nodes) CHECK(entry.second.parent != node);  // children were cut first
+        nodes.erase(it);
+        events++;
+    }
+    template <typename Node> void keyChanged(const Node* node, int oldKey) {
+        CHECK(nodes.at(node).key == oldKey && node->key < oldKey);
+        nodes.at(node).key = node->key;
+        events++;
+    }
+    template <typename Node> void linked(const Node* child, const Node* parent) {
+        CHECK(nodes.at(child).parent == nullptr && nodes.at(parent).parent == nullptr);
+        CHECK(!nodes.at(child).marked);  // unmarked() came first
+        nodes.at(child).parent = parent;
+        events++;
+    }
+    template <typename Node> void cut(const Node* child, const Node* parent) {
+        // children promoted by extractMin() or deleteNode() keep their mark
+        CHECK(nodes.at(child).parent == parent);
+        nodes.at(child).parent = nullptr;
+        events++;
+    }
+    template <typename Node> void marked(const Node* node) {
+        CHECK(!nodes.at(node).marked && nodes.at(node).parent != nullptr);
+        nodes.at(node).marked = true;
+        events++;
+    }
+    template <typename Node> void unmarked(const Node* node) {
+        CHECK(nodes.at(node).marked);
+        nodes.at(node).marked = false;
+        events++;
+    }
+    template <typename Node> void merged(const Node*, ShadowObserver& source) {
+        for (const auto& entry : source.nodes) CHECK(nodes.insert(entry).second);
+        events++;
+    }
+    void cleared() {
+        nodes.clear();
+        events++;
+    }
+};
+
+using Heap = FibonacciHeap<int, ShadowObserver>;
+
+void checkShadow(const Heap& heap) {
+    const ShadowObserver& shadow = heap.getObserver();
+    CHECK(shadow.nodes.size() == static_cast<size_t>(heap.getSize()));
+    for (auto* node : heap.nodes()) {
+        auto it = shadow.nodes.find(node);
+        CHECK(it != shadow.nodes.end());
+        CHECK(it->second.key == node->key);
+        CHECK(it->second.parent == node->parent);
+        CHECK(it->second.marked == node->marked);
+    }
+}
+
+void removeLive(std::vector<Heap::Node*>& live, Heap::Node* node) {
+    live.erase(std::find(live.begin(), live.end(), node));
+}
+
+void testRandomOperations(int budget) {
+    std::mt19937 rng(43 + static_cast<unsigned>(budget));
+    Heap heap;
+    heap.setConsolidationBudget(budget);
+    std::vector<Heap::Node*> live;
+    for (int step = 0; step < 4000; ++step) {
+        int op = static_cast<int>(rng() % 12);
+        if (live.empty() || op < 4) {
+            live.push_back(heap.insert(step, static_cast<int>(rng() % 10000)));
+        } else if (op < 6) {
+            Heap::Node* min = heap.extractMin();
+            removeLive(live, min);
+            heap.release(min);
+        } else if (op < 8) {
+            Heap::Node* node = live[rng() % live.size()];
+            heap.decreaseKey(node, node->key - 1 - static_cast<int>(rng() % 3000));
+        } else if (op < 9) {
+            // an increase moves the value to a new node
+            size_t i = rng() % live.size();
+            live[i] = heap.updateKey(live[i], live[i]->key + 1 + static_cast<int>(rng() % 3000));
+        } else if (op < 11) {
+            size_t i = rng() % live.size();
+            heap.deleteNode(live[i]);
+            live.erase(live.begin() + static_cast<std::ptrdiff_t>(i));
+        } else {
+            Heap other;
+            for (int i = 0; i < 10; ++i) live.push_back(other.insert(-i, static_cast<int>(rng() % 10000)));
+            Heap::Node* min = other.extractMin();
+            removeLive(live, min);
+            other.release(min);
+            heap.merge(other);
+            CHECK(other.getObserver().nodes.empty());
+            checkShadow(other);
+        }
+        checkShadow(heap);
+    }
+    CHECK(heap.getObserver().events > 10000);
+
+    // a clone reports its nodes to its own observer
+    Heap copy = heap.clone();
+    checkShadow(copy);
+    checkShadow(heap);
+
+    heap.clear();
+    checkShadow(heap);
+    // detached nodes have left the heap as well
+    Heap::DetachedNodes detached = copy.detach();
+    checkShadow(copy);
+}
+
+// A loaded snapshot clears the observer, then reports every node restored
+void testSnapshot() {
+    char name[] = "/tmp/observer_test.XXXXXX";
+    int fd = ::mkstemp(name);
+    CHECK(fd >= 0);
+    ::close(fd);
+    std::string path = name;
+
+    Heap heap;
+    std::vector<Heap::Node*> nodes;
+    for (int i = 0; i < 100; ++i) nodes.push_back(heap.insert(i, (i * 31) % 100));
+    Heap::Node* min = heap.extractMin();
+    removeLive(nodes, min);
+    heap.release(min);
+    for (Heap::Node* node : nodes) {
+        if (node->parent && node->parent->parent) heap.decreaseKey(node, node->key - 200);  // marks parents
+    }
+    heap.saveSnapshot(path);
+
+    Heap loaded;
+    loaded.insert(7, 7);
+    loaded.loadSnapshot(path);
+    checkShadow(loaded);
+    bool anyMarked = false;
+    for (const auto& entry : loaded.getObserver().nodes) anyMarked = anyMarked || entry.second.marked;
+    CHECK(anyMarked);
+    std::remove(path.c_str());
+}
+
+} // namespace
+
+int main() {
+    testRandomOperations(0);
+    testRandomOperations(2);
+    testSnapshot();
+    std::puts("observer_test passed");
+    return 0;
+}
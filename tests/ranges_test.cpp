@@ -0,0 +1,95 @@
+// ranges_test - roots(), children() and nodes(): they visit what the
+// rings hold, in place, without allocating
+
+#include "FibonacciHeap.hpp"
+#include "TestCheck.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <new>
+#include <set>
+#include <vector>
+
+namespace {
+size_t allocations = 0;
+} // namespace
+
+void* operator new(size_t size) {
+    allocations++;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+namespace {
+
+using Heap = FibonacciHeap<int>;
+
+void testEmpty() {
+    Heap heap;
+    CHECK(heap.roots().empty());
+    CHECK(heap.nodes().empty());
+    CHECK(heap.children(nullptr).empty());
+    CHECK(heap.getRootList().size() == 0);
+}
+
+void testRings() {
+    Heap heap;
+    for (int i = 0; i < 100; ++i) heap.insert(i, (i * 29) % 100);
+    heap.release(heap.extractMin());
+
+    // roots() walks the root ring from the minimum, as getRootList() lists it
+    Heap::RootList list = heap.getRootList();
+    std::vector<Heap::Node*> roots(heap.roots().begin(), heap.roots().end());
+    CHECK(roots.size() == list.size());
+    CHECK(std::equal(roots.begin(), roots.end(), list.begin()));
+    CHECK(roots.front() == heap.getMin());
+    for (size_t i = 0; i < roots.size(); ++i) CHECK(roots[i]->right == roots[(i + 1) % roots.size()]);
+
+    for (Heap::Node* root : heap.roots()) {
+        auto children = heap.children(root);
+        CHECK(std::distance(children.begin(), children.end()) == root->degree);
+        CHECK(children.empty() == (root->child == nullptr));
+        for (Heap::Node* child : children) CHECK(child->parent == root);
+    }
+
+    // nodes() is a preorder over every node
+    std::set<Heap::Node*> seen;
+    for (Heap::Node* node : heap.nodes()) {
+        CHECK(seen.insert(node).second);
+        if (node->parent) CHECK(seen.count(node->parent) == 1);
+    }
+    CHECK(seen.size() == 99);
+    auto found = std::find_if(heap.nodes().begin(), heap.nodes().end(),
+                              [](Heap::Node* node) { return node->key == 57; });
+    CHECK(found != heap.nodes().end() && (*found)->key == 57);
+}
+
+void testNoAllocation() {
+    Heap heap;
+    for (int i = 0; i < 1000; ++i) heap.insert(i, (i * 7919) % 1000);
+    heap.release(heap.extractMin());
+
+    size_t before = allocations;
+    long sum = 0;
+    for (Heap::Node* root : heap.roots()) {
+        for (Heap::Node* child : heap.children(root)) sum += child->key;
+    }
+    for (Heap::Node* node : heap.nodes()) sum += node->key;
+    Heap::RootList list = heap.getRootList();  // inline while there are few roots
+    CHECK(allocations == before);
+    CHECK(sum > 0 && list.size() > 0);
+}
+
+} // namespace
+
+int main() {
+    testEmpty();
+    testRings();
+    testNoAllocation();
+    std::puts("ranges_test passed");
+    return 0;
+}
@@ -0,0 +1,240 @@
+// reclaim_test - FibonacciHeap::detach() empties a heap in O(1) and hands
+// back its nodes; reclaim() destroys them in bounded steps and then frees
+// whole blocks, and HeapReclaimer does it all on a thread of its own
+
+#include "FibonacciHeap.hpp"
+#include "HeapReclaimer.hpp"
+#include "TestCheck.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// A payload that counts its copies alive and notes where they died
+struct Tracked {
+    static int live;
+    static std::thread::id destroyedOn;
+    int id;
+    explicit Tracked(int i) : id(i) { live++; }
+    Tracked(const Tracked& other) : id(other.id) { live++; }
+    ~Tracked() {
+        live--;
+        destroyedOn = std::this_thread::get_id();
+    }
+};
+int Tracked::live = 0;
+std::thread::id Tracked::destroyedOn;
+
+struct ClearCounter : NullHeapObserver {
+    int clears = 0;
+    void cleared() { clears++; }
+};
+
+using Heap = FibonacciHeap<Tracked, ClearCounter>;
+
+// Trees several levels deep, with marked nodes, so every child ring has
+// to be walked
+void fill(Heap& heap, int count) {
+    std::vector<Heap::Node*> nodes;
+    for (int i = 0; i < count; ++i) nodes.push_back(heap.insert(Tracked(i), (i * 7919) % count));
+    heap.release(heap.extractMin());
+    for (size_t i = 1; i < nodes.size(); i += 7) {
+        if (nodes[i]->key != 0) heap.decreaseKey(nodes[i], nodes[i]->key - 1);
+    }
+}
+
+// detach() takes everything at once and destroys nothing
+void testDetach() {
+    Heap heap;
+    fill(heap, 10000);
+    CHECK(Tracked::live == 9999);
+    Heap::DetachedNodes nodes = heap.detach();
+    CHECK(heap.isEmpty() && heap.getSize() == 0 && heap.getMin() == nullptr);
+    CHECK(heap.getObserver().clears == 1);
+    CHECK(Tracked::live == 9999);
+
+    // the heap goes on with storage of its own
+    heap.insert(Tracked(-1), 5);
+    heap.insert(Tracked(-2), 3);
+    Heap::Node* min = heap.extractMin();
+    CHECK(min->value.id == -2 && heap.getMin()->value.id == -1);
+    heap.release(min);
+    CHECK(Tracked::live == 10000);
+
+    {
+        Heap::DetachedNodes moved(std::move(nodes));
+        CHECK(Tracked::live == 10000);
+    }
+    CHECK(Tracked::live == 1);
+    nodes.reclaim(SIZE_MAX);  // moved from: owns nothing
+    CHECK(Tracked::live == 1);
+
+    Heap empty;
+    Heap::DetachedNodes none = empty.detach();
+    CHECK(!none.reclaim(1));
+}
+
+// Each step destroys at most its share of payloads, and each one once
+void testBoundedReclaim() {
+    Heap heap;
+    fill(heap, 5001);
+    Heap other;
+    fill(other, 3001);
+    heap.merge(other);  // one pool with the blocks of both
+    CHECK(Tracked::live == 8000);
+
+    Heap::DetachedNodes nodes = heap.detach();
+    int steps = 0;
+    int before = Tracked::live;
+    while (Tracked::live > 0) {
+        CHECK(nodes.reclaim(100));
+        CHECK(before - Tracked::live <= 100);
+        before = Tracked::live;
+        steps++;
+    }
+    // the last payloads used up that step's budget, so the blocks are
+    // left to the steps after: 2048 to 128 of other's, 64 and 4096 and
+    // 2048 to 128 of this heap's, then its 64
+    CHECK(steps == 80);
+    while (nodes.reclaim(100)) steps++;
+    CHECK(steps == 80 + 11);
+    CHECK(Tracked::live == 0 && !nodes.reclaim(100));
+}
+
+// Without payloads to destroy, reclaim() goes straight to the blocks:
+// each step frees at least one, and at least as many slots as asked for
+void testBlocks() {
+    FibonacciHeap<int> heap;
+    for (int i = 0; i < 100000; ++i) heap.insert(i, i);
+    heap.release(heap.extractMin());
+    FibonacciHeap<int>::DetachedNodes nodes = heap.detach();
+    // 64, 128, ..., 2048, then blocks of 4096
+    int blocks = 1;
+    while (nodes.reclaim(1)) blocks++;
+    CHECK(blocks == 6 + 24);
+    CHECK(!nodes.reclaim(1));
+
+    for (int i = 0; i < 100000; ++i) heap.insert(i, i);
+    FibonacciHeap<int>::DetachedNodes more = heap.detach();
+    int steps = 1;
+    while (more.reclaim(4096 * 4)) steps++;  // four blocks a step
+    CHECK(steps == 7);
+
+    for (int i = 0; i < 100000; ++i) heap.insert(i, i);
+    FibonacciHeap<int>::DetachedNodes all = heap.detach();
+    CHECK(!all.reclaim(SIZE_MAX));
+
+    // a pool partly released stays usable, its free slots forgotten
+    NodePool<Heap::Node> pool;
+    std::vector<Heap::Node*> slots;
+    for (int i = 0; i < 64 + 128; ++i) slots.push_back(pool.create(Tracked(i), i));
+    for (Heap::Node* slot : slots) pool.destroy(slot);
+    CHECK(pool.releaseSome(0));  // always one block: the 128
+    slots.clear();
+    for (int i = 0; i < 64; ++i) slots.push_back(pool.create(Tracked(i), i));
+    for (Heap::Node* slot : slots) pool.destroy(slot);
+    CHECK(Tracked::live == 0);
+    CHECK(pool.releaseSome(1) && !pool.releaseSome(1));  // the new block, then the 64
+}
+
+// Garbage that waits for a gate and notes the order it is destroyed in
+struct Marker {
+    std::vector<int>* order;
+    std::mutex* mutex;
+    int id;
+    std::shared_future<void> gate;
+    std::promise<void>* started;
+    Marker(std::vector<int>* o, std::mutex* m, int i, std::shared_future<void> g = {}, std::promise<void>* s = nullptr)
+        : order(o), mutex(m), id(i), gate(std::move(g)), started(s) {}
+    Marker(Marker&& other) noexcept
+        : order(other.order), mutex(other.mutex), id(other.id), gate(std::move(other.gate)), started(other.started) {
+        other.order = nullptr;
+    }
+    ~Marker() {
+        if (!order) return;
+        if (started) started->set_value();
+        if (gate.valid()) gate.wait();
+        std::lock_guard<std::mutex> lock(*mutex);
+        order->push_back(id);
+    }
+};
+
+// Posted nodes are freed on the reclaimer's thread, in posting order
+void testReclaimer() {
+    HeapReclaimer& reclaimer = HeapReclaimer::instance();
+    CHECK(&reclaimer == &HeapReclaimer::instance());
+    Heap heap;
+    fill(heap, 20000);
+    reclaimer.post(heap.detach());
+    CHECK(heap.isEmpty());
+    reclaimer.drain();
+    CHECK(Tracked::live == 0 && Tracked::destroyedOn != std::this_thread::get_id());
+
+    // jobs queued behind a slow one are freed after it, oldest first, and
+    // posting does not wait for it
+    std::vector<int> order;
+    std::mutex mutex;
+    std::promise<void> gate;
+    std::promise<void> started;
+    reclaimer.post(Marker(&order, &mutex, -1, gate.get_future().share(), &started));
+    started.get_future().wait();
+    for (int i = 0; i < 5; ++i) {
+        fill(heap, 2000);
+        reclaimer.post(heap.detach());
+        reclaimer.post(Marker(&order, &mutex, i));
+    }
+    CHECK(Tracked::live == 5 * 1999);
+    gate.set_value();
+    reclaimer.drain();
+    CHECK(Tracked::live == 0);
+    CHECK(order == std::vector<int>({-1, 0, 1, 2, 3, 4}));
+
+    // drain() also waits for the job being destroyed
+    order.clear();
+    std::promise<void> slowGate;
+    std::promise<void> slowStarted;
+    reclaimer.post(Marker(&order, &mutex, 5, slowGate.get_future().share(), &slowStarted));
+    slowStarted.get_future().wait();  // taken off the queue
+    std::thread opener([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        slowGate.set_value();
+    });
+    reclaimer.drain();
+    std::unique_lock<std::mutex> lock(mutex);
+    std::vector<int> drained = order;
+    lock.unlock();
+    opener.join();
+    CHECK(drained == std::vector<int>({5}));
+    reclaimer.drain();  // nothing left: returns at once
+
+    // a reclaimer of its own finishes its jobs on its thread when it goes,
+    // even those still queued
+    {
+        HeapReclaimer own;
+        own.post(Marker(&order, &mutex, 6, std::async(std::launch::async, [] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }).share()));
+        fill(heap, 2000);
+        own.post(heap.detach());
+    }
+    CHECK(Tracked::live == 0 && Tracked::destroyedOn != std::this_thread::get_id());
+    CHECK(order == std::vector<int>({5, 6}));
+}
+
+} // namespace
+
+int main() {
+    testDetach();
+    CHECK(Tracked::live == 0);
+    testBoundedReclaim();
+    testBlocks();
+    testReclaimer();
+    std::puts("reclaim_test passed");
+    return 0;
+}
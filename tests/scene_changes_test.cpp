@@ -0,0 +1,177 @@
+// scene_changes_test - HeapWorker::noteChanges(): every canvas tile drawn
+// differently in the next scene is one the change lists mark stale, and
+// unchanged parts of the heap leave their tiles alone
+
+#include "HeapWorker.h"
+#include "TestCheck.hpp"
+#include <QCoreApplication>
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <random>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+// As HeapCanvas draws and caches the scene (see MainWindow.h)
+const float NODE_RADIUS = HeapScene::NODE_RADIUS;
+const float SUMMARY_EXTENT = 24.0f;
+const int TILE_SIZE = 512;
+const double PEN = 0.75;  // half the width of a parent-child line
+
+// What a tile shows: summary glyphs, lines and nodes with their look
+using Primitive = std::tuple<int, double, double, double, double, int>;
+
+void drawSubtree(const HeapScene& scene, int index, const QRectF& reach, const QRectF& tile,
+                 float zoom, std::vector<Primitive>& out) {
+    const HeapScene::Node& entry = scene.nodes[index];
+    if (!entry.bounds.intersects(reach)) return;
+    bool hasChildren = entry.end > index + 1;
+    float extent = static_cast<float>(std::max(entry.bounds.width(), entry.bounds.height())) * zoom;
+    if (hasChildren && extent < SUMMARY_EXTENT) {
+        if (entry.bounds.intersects(tile)) {
+            out.emplace_back(0, entry.bounds.left(), entry.bounds.top(), entry.bounds.width(), entry.bounds.height(), 0);
+        }
+        return;
+    }
+    for (int child = index + 1; child < entry.end; child = scene.nodes[child].end) {
+        QPointF to = scene.nodes[child].pos;
+        QRectF line = QRectF(entry.pos, to).normalized().adjusted(-PEN, -PEN, PEN, PEN);
+        if (line.intersects(tile)) out.emplace_back(1, entry.pos.x(), entry.pos.y(), to.x(), to.y(), 0);
+    }
+    QRectF circle(entry.pos.x() - NODE_RADIUS - PEN, entry.pos.y() - NODE_RADIUS - PEN,
+                  2 * (NODE_RADIUS + PEN), 2 * (NODE_RADIUS + PEN));
+    if (circle.intersects(tile)) {
+        int look = entry.key * 4 + (entry.marked ? 2 : 0) + (index == scene.minIndex ? 1 : 0);
+        out.emplace_back(2, entry.pos.x(), entry.pos.y(), 0, 0, look);
+    }
+    for (int child = index + 1; child < entry.end; child = scene.nodes[child].end) {
+        drawSubtree(scene, child, reach, tile, zoom, out);
+    }
+}
+
+std::vector<Primitive> drawTile(const HeapScene& scene, const QRectF& tile, float zoom) {
+    std::vector<Primitive> out;
+    QRectF reach = tile.adjusted(-NODE_RADIUS, -NODE_RADIUS, NODE_RADIUS, NODE_RADIUS);
+    for (int i = 0; i < scene.size(); i = scene.nodes[i].end) drawSubtree(scene, i, reach, tile, zoom, out);
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+// HeapCanvas::invalidateTiles(next) drops the tile when this holds
+bool isStale(const HeapScene& next, int column, int row, float zoom) {
+    float extent = TILE_SIZE / zoom;
+    float blend = 1.0f / zoom;
+    QRectF area(column * extent - blend, row * extent - blend, extent + blend * 2, extent + blend * 2);
+    for (const QRectF& changed : next.changedAreas) {
+        if (changed.intersects(area)) return true;
+    }
+    for (const HeapScene::ShapeChange& shape : next.changedShapes) {
+        if (shape.extent * zoom < SUMMARY_EXTENT && shape.area.intersects(area)) return true;
+    }
+    return false;
+}
+
+struct TileCounts {
+    long checked = 0;
+    long kept = 0;
+};
+
+// Every tile that looks different is stale, at zooms from full detail
+// down to summary glyphs
+void checkTiles(const HeapScene& before, const HeapScene& after, std::mt19937& rng, TileCounts& counts) {
+    CHECK(after.hasChanges && after.changesSince == before.version);
+    CHECK(after.changedAreas.size() <= 256 && after.changedShapes.size() <= 256);
+    double right = 0;
+    double bottom = 0;
+    for (const HeapScene* scene : {&before, &after}) {
+        for (const HeapScene::Node& node : scene->nodes) {
+            right = std::max(right, node.bounds.right() + NODE_RADIUS);
+            bottom = std::max(bottom, node.bounds.bottom() + NODE_RADIUS);
+        }
+    }
+    for (float zoom : {2.0f, 1.0f, 0.3f, 0.08f, 0.02f}) {
+        float extent = TILE_SIZE / zoom;
+        int columns = static_cast<int>(right / extent) + 1;
+        int rows = static_cast<int>(bottom / extent) + 1;
+        // all of them while there are few, a sample otherwise
+        bool all = columns * rows <= 64;
+        for (int k = 0; k < (all ? columns * rows : 40); ++k) {
+            int column = all ? k % columns : static_cast<int>(rng() % static_cast<unsigned>(columns));
+            int row = all ? k / columns : static_cast<int>(rng() % static_cast<unsigned>(rows));
+            QRectF tile(column * extent, row * extent, extent, extent);
+            bool stale = isStale(after, column, row, zoom);
+            if (!stale) CHECK(drawTile(before, tile, zoom) == drawTile(after, tile, zoom));
+            counts.checked++;
+            counts.kept += !stale;
+        }
+    }
+}
+
+void testRandomOperations() {
+    std::mt19937 rng(41);
+    TileCounts single;
+    for (int round = 0; round < 20; ++round) {
+        VisualHeap heap;
+        heap.getObserver().setRecording(false);
+        std::vector<VisualHeap::Node*> live;
+        uint64_t version = 0;
+        std::shared_ptr<HeapScene> before = HeapWorker::layOut(heap, ++version);
+        for (int step = 0; step < 60; ++step) {
+            int op = static_cast<int>(rng() % 10);
+            int count = rng() % 4 == 0 ? 1 + static_cast<int>(rng() % 200) : 1;  // sometimes a burst
+            for (int i = 0; i < count; ++i) {
+                if (op < 5 || heap.isEmpty()) {
+                    int key = static_cast<int>(rng() % 100000);
+                    live.push_back(heap.insert(key, key));
+                } else if (op < 7) {
+                    VisualHeap::Node* min = heap.extractMin();
+                    live.erase(std::find(live.begin(), live.end(), min));
+                    heap.release(min);
+                } else if (op < 9) {
+                    VisualHeap::Node* node = live[rng() % live.size()];
+                    heap.decreaseKey(node, node->key - 1 - static_cast<int>(rng() % 1000));
+                } else {
+                    size_t index = rng() % live.size();
+                    heap.deleteNode(live[index]);
+                    live.erase(live.begin() + static_cast<std::ptrdiff_t>(index));
+                }
+            }
+            std::shared_ptr<HeapScene> after = HeapWorker::layOut(heap, ++version);
+            HeapWorker::noteChanges(*after, *before);
+            TileCounts counts;
+            checkTiles(*before, *after, rng, counts);
+            if (count == 1 && heap.getSize() > 500) {
+                single.checked += counts.checked;
+                single.kept += counts.kept;
+            }
+            before = after;
+        }
+    }
+    // single operations on a large heap leave most tiles as they were
+    CHECK(single.checked > 0 && single.kept * 2 > single.checked);
+}
+
+// A scene laid out from an unchanged heap differs nowhere
+void testUnchanged() {
+    VisualHeap heap;
+    heap.getObserver().setRecording(false);
+    for (int i = 0; i < 300; ++i) heap.insert(i, (i * 37) % 300);
+    heap.release(heap.extractMin());
+    std::shared_ptr<HeapScene> before = HeapWorker::layOut(heap, 1);
+    std::shared_ptr<HeapScene> after = HeapWorker::layOut(heap, 2);
+    HeapWorker::noteChanges(*after, *before);
+    CHECK(after->hasChanges && after->changesSince == 1);
+    CHECK(after->changedAreas.empty() && after->changedShapes.empty());
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    testUnchanged();
+    testRandomOperations();
+    std::puts("scene_changes_test passed");
+    return 0;
+}
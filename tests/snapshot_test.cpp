@@ -0,0 +1,294 @@
+// snapshot_test - FibonacciHeap::saveSnapshot/loadSnapshot: exact round
+// trips of trees, marks and payloads, and rejection of damaged files
+
+#include "FibonacciHeap.hpp"
+#include "TestCheck.hpp"
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+struct TempDir {
+    std::string path;
+    TempDir() {
+        char name[] = "/tmp/snapshot_test.XXXXXX";
+        CHECK(::mkdtemp(name) != nullptr);
+        path = name;
+    }
+    ~TempDir() {
+        for (const char* file : {"heap.snap", "heap.snap.tmp", "bad.snap"}) {
+            std::remove((path + "/" + file).c_str());
+        }
+        ::rmdir(path.c_str());
+    }
+};
+
+using Shape = std::vector<std::tuple<int, std::string, int, bool, int>>;
+
+// key, value, degree, mark and parent key of every node, in nodes() order
+template <typename Heap>
+Shape shapeOf(const Heap& heap) {
+    Shape shape;
+    for (auto* node : heap.nodes()) {
+        shape.emplace_back(node->key, node->value, node->degree, node->marked,
+                           node->parent ? node->parent->key : -1);
+    }
+    return shape;
+}
+
+void fill(FibonacciHeap<std::string>& heap) {
+    std::vector<FibonacciHeap<std::string>::Node*> nodes;
+    for (int i = 0; i < 64; ++i) nodes.push_back(heap.insert("patient-" + std::to_string(i), (i * 37) % 64 + 10));
+    heap.release(heap.extractMin());  // links the roots into trees
+    nodes.erase(nodes.begin());       // key 10, the one extracted
+    // cutting a node below a non-root marks its parent
+    int cuts = 0;
+    for (auto* node : nodes) {
+        if (cuts < 3 && node->parent && node->parent->parent && !node->parent->marked) {
+            heap.decreaseKey(node, node->parent->key - 1);
+            cuts++;
+        }
+    }
+}
+
+void writeBytes(const std::string& path, const std::vector<unsigned char>& bytes) {
+    FILE* file = std::fopen(path.c_str(), "wb");
+    CHECK(file != nullptr);
+    CHECK(std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size());
+    std::fclose(file);
+}
+
+std::vector<unsigned char> readBytes(const std::string& path) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    CHECK(file != nullptr);
+    std::vector<unsigned char> bytes;
+    int c;
+    while ((c = std::fgetc(file)) != EOF) bytes.push_back(static_cast<unsigned char>(c));
+    std::fclose(file);
+    return bytes;
+}
+
+void testRoundTrip() {
+    TempDir dir;
+    std::string path = dir.path + "/heap.snap";
+    FibonacciHeap<std::string> heap;
+    fill(heap);
+    bool anyMarked = false;
+    for (auto* node : heap.nodes()) anyMarked = anyMarked || node->marked;
+    CHECK(anyMarked);
+
+    heap.saveSnapshot(path);
+    CHECK(::access((path + ".tmp").c_str(), F_OK) != 0);
+
+    FibonacciHeap<std::string> loaded;
+    loaded.insert("replaced", 1);
+    loaded.loadSnapshot(path);
+    CHECK(loaded.getSize() == heap.getSize());
+    CHECK(shapeOf(loaded) == shapeOf(heap));
+
+    // the loaded links are live: both heaps extract the same sequence
+    while (!heap.isEmpty()) {
+        auto* expected = heap.extractMin();
+        auto* actual = loaded.extractMin();
+        CHECK(actual->key == expected->key && actual->value == expected->value);
+        heap.release(expected);
+        loaded.release(actual);
+    }
+    CHECK(loaded.isEmpty());
+}
+
+void testEmptyAndIncremental() {
+    TempDir dir;
+    std::string path = dir.path + "/heap.snap";
+    FibonacciHeap<int> empty;
+    empty.saveSnapshot(path);
+    FibonacciHeap<int> loaded;
+    loaded.insert(7, 7);
+    loaded.loadSnapshot(path);
+    CHECK(loaded.isEmpty());
+
+    // roots of a heap loaded with a consolidation budget are pending work
+    FibonacciHeap<int> heap;
+    for (int i = 0; i < 100; ++i) heap.insert(i, (i * 53) % 100);
+    heap.saveSnapshot(path);
+    loaded.setConsolidationBudget(2);
+    loaded.loadSnapshot(path);
+    for (int key = 0; key < 100; ++key) {
+        CHECK(loaded.getMin()->key == key);
+        loaded.release(loaded.extractMin());
+    }
+}
+
+void testDamagedFiles() {
+    TempDir dir;
+    std::string path = dir.path + "/heap.snap";
+    std::string bad = dir.path + "/bad.snap";
+    FibonacciHeap<int> heap;
+    for (int i = 0; i < 10; ++i) heap.insert(i, i);
+    heap.release(heap.extractMin());
+    heap.saveSnapshot(path);
+    const std::vector<unsigned char> good = readBytes(path);
+    CHECK(good.size() == sizeof(SnapshotHeader) + 9 * (sizeof(SnapshotNode) + sizeof(int)));
+
+    FibonacciHeap<int> loaded;
+    loaded.insert(42, 42);
+
+    std::vector<unsigned char> bytes = good;
+    bytes[0] = 'X';
+    writeBytes(bad, bytes);
+    CHECK_THROWS(loaded.loadSnapshot(bad));
+    CHECK(loaded.getSize() == 1 && loaded.getMin()->key == 42);  // left as it was
+
+    bytes = good;
+    bytes[offsetof(SnapshotHeader, version)] = SNAPSHOT_VERSION + 1;
+    writeBytes(bad, bytes);
+    CHECK_THROWS(loaded.loadSnapshot(bad));
+    CHECK(loaded.getSize() == 1);
+
+    bytes.assign(good.begin(), good.end() - 1);  // payload cut short
+    writeBytes(bad, bytes);
+    CHECK_THROWS(loaded.loadSnapshot(bad));
+
+    bytes.assign(good.begin(), good.begin() + 10);  // not even a header
+    writeBytes(bad, bytes);
+    CHECK_THROWS(loaded.loadSnapshot(bad));
+
+    bytes = good;
+    bytes[offsetof(SnapshotHeader, nodeCount)] = 10;  // one node more than stored
+    writeBytes(bad, bytes);
+    CHECK_THROWS(loaded.loadSnapshot(bad));
+
+    bytes = good;
+    SnapshotNode node;
+    size_t second = sizeof(SnapshotHeader) + sizeof(SnapshotNode);
+    std::memcpy(&node, &bytes[second], sizeof(node));
+    node.right = 9;  // past the last node
+    std::memcpy(&bytes[second], &node, sizeof(node));
+    writeBytes(bad, bytes);
+    CHECK_THROWS(loaded.loadSnapshot(bad));
+
+    CHECK_THROWS(loaded.loadSnapshot(dir.path + "/missing.snap"));
+    CHECK(loaded.getSize() == 1 && loaded.getMin()->key == 42);
+
+    // a failed load leaves a heap that can load the good file
+    loaded.loadSnapshot(path);
+    CHECK(loaded.getSize() == 9 && loaded.getMin()->key == 1);
+}
+
+SnapshotNode recordAt(const std::vector<unsigned char>& bytes, uint32_t index) {
+    SnapshotNode node;
+    std::memcpy(&node, &bytes[sizeof(SnapshotHeader) + index * sizeof(SnapshotNode)], sizeof(node));
+    return node;
+}
+
+void setRecord(std::vector<unsigned char>& bytes, uint32_t index, const SnapshotNode& node) {
+    std::memcpy(&bytes[sizeof(SnapshotHeader) + index * sizeof(SnapshotNode)], &node, sizeof(node));
+}
+
+// Links that are all in range but do not make a heap are rejected before
+// anything is replaced: the file would otherwise send later operations
+// round cycles or past nodes that are not there
+void testCraftedLinks() {
+    TempDir dir;
+    std::string path = dir.path + "/heap.snap";
+    std::string bad = dir.path + "/bad.snap";
+    FibonacciHeap<int> heap;
+    for (int i = 0; i < 10; ++i) heap.insert(i, i);
+    heap.release(heap.extractMin());  // a tree of 8 and a lone root
+    heap.saveSnapshot(path);
+    const std::vector<unsigned char> good = readBytes(path);
+    const uint32_t count = 9;
+
+    uint32_t parent = SNAPSHOT_NONE;  // the first node with children, and
+    uint32_t leaf = SNAPSHOT_NONE;    // a node without any
+    uint32_t lone = SNAPSHOT_NONE;    // the root without children
+    for (uint32_t i = 0; i < count; ++i) {
+        SnapshotNode node = recordAt(good, i);
+        if (node.child != SNAPSHOT_NONE && parent == SNAPSHOT_NONE) parent = i;
+        if (node.child == SNAPSHOT_NONE && node.parent != SNAPSHOT_NONE) leaf = i;
+        if (node.child == SNAPSHOT_NONE && node.parent == SNAPSHOT_NONE) lone = i;
+    }
+    CHECK(parent != SNAPSHOT_NONE && leaf != SNAPSHOT_NONE && lone != SNAPSHOT_NONE);
+
+    FibonacciHeap<int> loaded;
+    loaded.insert(42, 42);
+    auto rejects = [&](const std::vector<unsigned char>& bytes) {
+        writeBytes(bad, bytes);
+        CHECK_THROWS(loaded.loadSnapshot(bad));
+        CHECK(loaded.getSize() == 1 && loaded.getMin()->key == 42);
+    };
+
+    // a leaf whose child is an ancestor: a cycle through the child links
+    std::vector<unsigned char> bytes = good;
+    SnapshotNode node = recordAt(bytes, leaf);
+    node.child = parent;
+    node.degree = 1;
+    setRecord(bytes, leaf, node);
+    rejects(bytes);
+
+    // a ring that never comes back to where it started
+    bytes = good;
+    node = recordAt(bytes, recordAt(good, parent).child);
+    node.right = parent;
+    setRecord(bytes, recordAt(good, parent).child, node);
+    rejects(bytes);
+
+    // a degree that does not count the children
+    bytes = good;
+    node = recordAt(bytes, parent);
+    node.degree++;
+    setRecord(bytes, parent, node);
+    rejects(bytes);
+
+    // a child below its parent's key
+    bytes = good;
+    node = recordAt(bytes, leaf);
+    node.key = -1;
+    setRecord(bytes, leaf, node);
+    rejects(bytes);
+
+    // the lone root in a ring of its own, out of reach of node 0
+    bytes = good;
+    SnapshotNode loneNode = recordAt(good, lone);
+    node = recordAt(bytes, loneNode.left);
+    node.right = loneNode.right;
+    setRecord(bytes, loneNode.left, node);
+    node = recordAt(bytes, loneNode.right);
+    node.left = loneNode.left;
+    setRecord(bytes, loneNode.right, node);
+    loneNode.left = loneNode.right = lone;
+    setRecord(bytes, lone, loneNode);
+    rejects(bytes);
+
+    // a payload that cannot be read, after valid records
+    FibonacciHeap<std::string> named;
+    named.insert("ann", 1);
+    named.insert("bob", 2);
+    named.saveSnapshot(path);
+    bytes = readBytes(path);
+    bytes[sizeof(SnapshotHeader) + 2 * sizeof(SnapshotNode)] = 0xFF;  // ann's length
+    writeBytes(bad, bytes);
+    named.insert("cat", 3);
+    CHECK_THROWS(named.loadSnapshot(bad));
+    CHECK(named.getSize() == 3 && named.getMin()->value == "ann");
+
+    loaded.loadSnapshot(path);
+    CHECK(loaded.getSize() == 2 && loaded.getMin()->key == 1);
+}
+
+} // namespace
+
+int main() {
+    testRoundTrip();
+    testEmptyAndIncremental();
+    testDamagedFiles();
+    testCraftedLinks();
+    std::puts("snapshot_test passed");
+    return 0;
+}
@@ -0,0 +1,116 @@
+// spatial_grid_test - SpatialHashGrid finds every point within half a
+// cell of a position, as a full scan would, whatever the point layout
+
+#include "SpatialHashGrid.hpp"
+#include "TestCheck.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace {
+
+struct Point {
+    float px;
+    float py;
+    float x() const { return px; }
+    float y() const { return py; }
+};
+
+const float CELL = 40.0f;
+const float RADIUS = CELL / 2;
+
+std::set<uint32_t> scanNear(const std::vector<Point>& points, float x, float y) {
+    std::set<uint32_t> found;
+    for (uint32_t i = 0; i < points.size(); ++i) {
+        float dx = points[i].px - x;
+        float dy = points[i].py - y;
+        if (dx * dx + dy * dy <= RADIUS * RADIUS) found.insert(i);
+    }
+    return found;
+}
+
+std::set<uint32_t> gridNear(const SpatialHashGrid& grid, const std::vector<Point>& points, float x, float y) {
+    std::set<uint32_t> found;
+    grid.forEachNear(x, y, [&](uint32_t i) {
+        CHECK(i < points.size());
+        float dx = points[i].px - x;
+        float dy = points[i].py - y;
+        if (dx * dx + dy * dy <= RADIUS * RADIUS) found.insert(i);
+    });
+    return found;
+}
+
+void build(SpatialHashGrid& grid, const std::vector<Point>& points) {
+    grid.build(points.size(), [&](size_t i) { return points[i]; });
+    CHECK(grid.size() == points.size());
+}
+
+// Spread out, crowded into one cell, on cell borders and at negative
+// coordinates: queries agree with a full scan
+void testAgainstScan() {
+    std::mt19937 rng(40);
+    std::uniform_real_distribution<float> wide(-2000.0f, 2000.0f);
+    std::uniform_real_distribution<float> narrow(0.0f, CELL);
+    std::vector<Point> points;
+    for (int i = 0; i < 3000; ++i) points.push_back({wide(rng), wide(rng)});
+    for (int i = 0; i < 500; ++i) points.push_back({narrow(rng), narrow(rng)});
+    for (int i = -5; i <= 5; ++i) points.push_back({i * CELL, -i * CELL});  // on cell corners
+    points.push_back(points[7]);  // a duplicate
+
+    SpatialHashGrid grid(CELL);
+    build(grid, points);
+    for (int q = 0; q < 3000; ++q) {
+        float x = q % 3 == 0 ? narrow(rng) : wide(rng);
+        float y = q % 3 == 0 ? narrow(rng) : wide(rng);
+        CHECK(gridNear(grid, points, x, y) == scanNear(points, x, y));
+    }
+
+    // away from the crowded cell a query only sees a few points
+    size_t visits = 0;
+    for (int q = 0; q < 2000; ++q) {
+        float x = wide(rng);
+        float y = wide(rng);
+        if (x > -CELL * 3 && x < CELL * 4 && y > -CELL * 3 && y < CELL * 4) continue;
+        grid.forEachNear(x, y, [&](uint32_t) { visits++; });
+    }
+    CHECK(visits < 2000 * 20);
+
+    for (const Point& p : points) {
+        std::set<uint32_t> found = gridNear(grid, points, p.px, p.py);
+        CHECK(found == scanNear(points, p.px, p.py) && !found.empty());
+    }
+}
+
+// build() replaces the previous point set; clear() empties the grid
+void testRebuild() {
+    SpatialHashGrid grid(CELL);
+    CHECK(gridNear(grid, {}, 0, 0).empty());  // never built
+
+    std::vector<Point> many;
+    for (int i = 0; i < 1000; ++i) many.push_back({static_cast<float>(i % 50) * 10, static_cast<float>(i / 50) * 10});
+    build(grid, many);
+    CHECK(gridNear(grid, many, 100, 100).size() == scanNear(many, 100, 100).size());
+
+    std::vector<Point> few = {{5, 5}, {1000, 1000}, {-300, 7}};
+    build(grid, few);
+    CHECK((gridNear(grid, few, 0, 0) == std::set<uint32_t>{0}));
+    CHECK((gridNear(grid, few, 990, 1005) == std::set<uint32_t>{1}));
+    CHECK(gridNear(grid, few, 100, 100).empty());
+
+    build(grid, {});
+    CHECK(grid.size() == 0 && gridNear(grid, few, 5, 5).empty());
+    build(grid, few);
+    grid.clear();
+    CHECK(grid.size() == 0 && gridNear(grid, few, 5, 5).empty());
+}
+
+} // namespace
+
+int main() {
+    testAgainstScan();
+    testRebuild();
+    std::puts("spatial_grid_test passed");
+    return 0;
+}
@@ -0,0 +1,143 @@
+// structure_test - FibonacciHeap::captureStructure() and the lock-free
+// HeapStructurePublisher readers on other threads go through
+
+#include "FibonacciHeap.hpp"
+#include "HeapStructure.hpp"
+#include "TestCheck.hpp"
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Links agree with each other and the numbering is a preorder
+void checkConsistent(const HeapStructure& s) {
+    uint32_t roots = 0;
+    for (uint32_t i = 0; i < s.size(); ++i) {
+        if (s.parent[i] == STRUCTURE_NONE) roots++;
+        else CHECK(s.parent[i] < i);
+        int children = 0;
+        for (uint32_t c = s.child[i]; c != STRUCTURE_NONE; c = s.next[c]) {
+            CHECK(c > i && s.parent[c] == i);
+            CHECK(s.key[c] >= s.key[i]);
+            children++;
+        }
+        CHECK(children == s.degree[i]);
+    }
+    CHECK(roots == s.rootCount);
+    if (!s.empty()) CHECK(s.parent[0] == STRUCTURE_NONE);
+}
+
+void testCapture() {
+    FibonacciHeap<int> heap;
+    std::vector<FibonacciHeap<int>::Node*> nodes;
+    for (int i = 0; i < 200; ++i) nodes.push_back(heap.insert(i, (i * 71) % 200));
+    heap.release(heap.extractMin());
+    for (int i : {3, 50, 99, 150}) heap.decreaseKey(nodes[i], -i);
+
+    HeapStructure s;
+    heap.captureStructure(s);
+    CHECK(s.size() == 199);
+    checkConsistent(s);
+
+    size_t i = 0;
+    for (auto* node : heap.nodes()) {
+        CHECK(s.key[i] == node->key);
+        CHECK(s.degree[i] == node->degree);
+        CHECK(s.marked[i] == (node->marked ? 1 : 0));
+        i++;
+    }
+    CHECK(s.key[0] == heap.getMin()->key);
+    uint32_t roots = 0;
+    for (auto* root : heap.roots()) roots += root != nullptr;
+    CHECK(s.rootCount == roots);
+
+    // the buffer is reused for a smaller heap
+    FibonacciHeap<int> small;
+    small.insert(1, 1);
+    small.captureStructure(s);
+    CHECK(s.size() == 1 && s.rootCount == 1 && s.child[0] == STRUCTURE_NONE);
+    FibonacciHeap<int> empty;
+    empty.captureStructure(s);
+    CHECK(s.empty() && s.rootCount == 0);
+}
+
+// A reader pinning the only other buffer makes publish() give up instead
+// of overwriting what the reader sees
+void testPinnedReader() {
+    FibonacciHeap<int> heap;
+    HeapStructurePublisher publisher;
+    CHECK(publisher.read()->version == 0);
+
+    heap.insert(1, 1);
+    CHECK(publisher.publish(heap));
+    {
+        HeapStructurePublisher::ReadGuard pinned = publisher.read();
+        CHECK(pinned->version == 1 && pinned->size() == 1);
+        heap.insert(2, 2);
+        CHECK(publisher.publish(heap));   // into the other buffer
+        heap.insert(3, 3);
+        CHECK(!publisher.publish(heap));  // would overwrite pinned
+        CHECK(pinned->version == 1 && pinned->size() == 1);
+        CHECK(publisher.read()->version == 2);
+    }
+    CHECK(publisher.publish(heap));
+    CHECK(publisher.version() == 3);
+    CHECK(publisher.read()->size() == 3);
+}
+
+void testConcurrentReaders() {
+    FibonacciHeap<int> heap;
+    HeapStructurePublisher publisher;
+    std::atomic<bool> done(false);
+    std::atomic<bool> torn(false);
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&] {
+            uint64_t last = 0;
+            while (!done) {
+                HeapStructurePublisher::ReadGuard view = publisher.read();
+                if (view->version < last) torn = true;
+                last = view->version;
+                // the writer alternates between two sizes per version
+                if (view->version > 0 && view->size() != 100 + (view->version % 2)) torn = true;
+                for (uint32_t i = 1; i < view->size(); ++i) {
+                    if (view->parent[i] != STRUCTURE_NONE && view->parent[i] >= i) torn = true;
+                }
+            }
+        });
+    }
+
+    for (int i = 0; i < 100; ++i) heap.insert(i, i);
+    uint64_t published = 0;
+    for (int round = 0; round < 20000; ++round) {
+        // odd versions have 101 nodes, even ones 100
+        bool grow = published % 2 == 0;
+        if (grow) heap.insert(-round, -round);
+        else heap.release(heap.extractMin());
+        if (publisher.publish(heap)) {
+            published++;
+            continue;
+        }
+        // a reader still pins the back buffer: undo, try again next round
+        if (grow) heap.release(heap.extractMin());
+        else heap.insert(round, round);
+    }
+    done = true;
+    for (std::thread& reader : readers) reader.join();
+    CHECK(!torn);
+    CHECK(publisher.version() == published);
+    checkConsistent(*publisher.read());
+}
+
+} // namespace
+
+int main() {
+    testCapture();
+    testPinnedReader();
+    testConcurrentReaders();
+    std::puts("structure_test passed");
+    return 0;
+}
@@ -0,0 +1,160 @@
+// task_list_model_test - TaskListModel follows its TaskManager with one
+// row insert or remove per change, and a reset when the store is reloaded
+
+#include "TaskListModel.h"
+#include "TestCheck.hpp"
+#include <QCoreApplication>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+struct TempDir {
+    std::string path;
+    TempDir() {
+        char name[] = "/tmp/task_list_model_test.XXXXXX";
+        CHECK(::mkdtemp(name) != nullptr);
+        path = name;
+    }
+    ~TempDir() {
+        for (const char* file : {"tasks.wal", "tasks.wal.tmp", "tasks.snap", "tasks.snap.tmp"}) {
+            std::remove((path + "/" + file).c_str());
+        }
+        ::rmdir(path.c_str());
+    }
+};
+
+// Replays the model's row signals on a list of names, as a view would
+struct ViewMirror {
+    TaskListModel& model;
+    std::vector<std::string> names;
+    int inserts = 0;
+    int removes = 0;
+    int resets = 0;
+
+    explicit ViewMirror(TaskListModel& m) : model(m) {
+        for (int row = 0; row < model.rowCount(); ++row) names.push_back(nameAt(row));
+        QObject::connect(&model, &QAbstractItemModel::rowsInserted,
+                         [this](const QModelIndex&, int first, int last) {
+            for (int row = first; row <= last; ++row) names.insert(names.begin() + row, nameAt(row));
+            inserts++;
+        });
+        QObject::connect(&model, &QAbstractItemModel::rowsRemoved,
+                         [this](const QModelIndex&, int first, int last) {
+            names.erase(names.begin() + first, names.begin() + last + 1);
+            removes++;
+        });
+        QObject::connect(&model, &QAbstractItemModel::modelReset, [this] {
+            names.clear();
+            for (int row = 0; row < model.rowCount(); ++row) names.push_back(nameAt(row));
+            resets++;
+        });
+    }
+
+    std::string nameAt(int row) const {
+        return model.data(model.index(row, 0), TaskListModel::NameRole).toString().toStdString();
+    }
+};
+
+// The mirror, the model and the manager's view all list the same tasks
+bool matches(const ViewMirror& view, TaskManager& manager) {
+    std::vector<std::string> expected;
+    for (const Task& task : manager.tasksByUrgency()) expected.push_back(task.name);
+    if (view.names != expected || view.model.rowCount() != static_cast<int>(expected.size())) return false;
+    int row = 0;
+    for (const Task& task : manager.tasksByUrgency()) {
+        QModelIndex index = view.model.index(row++, 0);
+        if (view.model.data(index, TaskListModel::UrgencyRole).toInt() != static_cast<int>(task.urgency)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void testIncrementalRows() {
+    TaskManager manager;
+    manager.addPatient("waiting", Urgency::URGENT);  // before the model exists
+    TaskListModel model(manager);
+    ViewMirror view(model);
+    CHECK(matches(view, manager));
+
+    std::mt19937 rng(39);
+    int changes = 0;
+    for (int step = 0; step < 3000; ++step) {
+        std::string name = "patient-" + std::to_string(rng() % 200);
+        Urgency urgency = static_cast<Urgency>(rng() % URGENCY_LEVELS + 1);
+        const Task* task = manager.findTask(name);
+        switch (rng() % 4) {
+        case 0:
+        case 1:
+            // new: one insert; another urgency: a remove and an insert
+            if (!task) changes += 1;
+            else if (task->urgency != urgency) changes += 2;
+            manager.addPatient(name, urgency);
+            break;
+        case 2:
+            if (task) changes += 1;
+            manager.removeTask(name);
+            break;
+        default:
+            if (manager.getPendingCount() > 0) changes += 1;
+            manager.treatNext();
+            break;
+        }
+        if (step % 20 == 0) CHECK(matches(view, manager));
+    }
+    CHECK(matches(view, manager));
+    CHECK(view.inserts + view.removes == changes);
+    CHECK(view.resets == 0);
+}
+
+// Loading a snapshot replaces the whole store, which the model follows
+// with a reset
+void testResetOnLoad() {
+    TempDir dir;
+    {
+        TaskManager saved;
+        saved.enableJournal(dir.path, std::chrono::microseconds(0));
+        for (int i = 0; i < 50; ++i) saved.addPatient("saved-" + std::to_string(i), static_cast<Urgency>(i % 4 + 1));
+        saved.checkpoint();
+    }
+
+    TaskManager manager;
+    manager.addPatient("replaced", Urgency::CRITICAL);
+    TaskListModel model(manager);
+    ViewMirror view(model);
+    manager.enableJournal(dir.path, std::chrono::microseconds(0));
+    CHECK(view.resets == 1 && model.rowCount() == 50);
+    CHECK(matches(view, manager));
+    manager.treatNext();
+    manager.addPatient("saved-7", Urgency::CRITICAL);
+    CHECK(matches(view, manager));
+}
+
+// A destroyed model stops listening
+void testDetachOnDestroy() {
+    TaskManager manager;
+    {
+        TaskListModel model(manager);
+        manager.addPatient("a", Urgency::MINOR);
+        CHECK(model.rowCount() == 1);
+    }
+    manager.addPatient("b", Urgency::URGENT);
+    manager.removeTask("a");
+    CHECK(manager.getPendingCount() == 1);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    testIncrementalRows();
+    testResetOnLoad();
+    testDetachOnDestroy();
+    std::puts("task_list_model_test passed");
+    return 0;
+}
@@ -0,0 +1,169 @@
+// task_manager_test - TaskManager's task store: lookups by name, the
+// ordered TaskView read in place, and the listener that follows it
+
+#include "TaskManager.h"
+#include "TestCheck.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Applies the listener callbacks to a list of names, as a view model would
+struct Mirror : TaskListener {
+    TaskManager& manager;
+    std::vector<std::string> names;
+    int resets = 0;
+
+    explicit Mirror(TaskManager& m) : manager(m) {}
+
+    void taskAdded(const Task& task) override {
+        size_t row = 0;
+        for (const Task& t : manager.tasksByUrgency()) {
+            if (&t == &task) break;
+            row++;
+        }
+        names.insert(names.begin() + static_cast<std::ptrdiff_t>(row), task.name);
+    }
+    void taskRemoving(const Task& task) override {
+        auto it = std::find(names.begin(), names.end(), task.name);
+        CHECK(it != names.end());
+        names.erase(it);
+    }
+    void tasksReset() override { resets++; }
+};
+
+// What the store should hold: urgency and arrival order of every task
+struct Expected {
+    std::map<std::string, std::pair<int, uint64_t>> tasks;
+    uint64_t arrivals = 0;
+
+    void set(const std::string& name, int urgency) {
+        auto it = tasks.find(name);
+        if (it != tasks.end() && it->second.first == urgency) return;
+        tasks[name] = {urgency, arrivals++};  // a new level puts it at the tail
+    }
+
+    std::vector<std::string> order() const {
+        std::vector<std::pair<std::pair<int, uint64_t>, std::string>> sorted;
+        for (const auto& entry : tasks) sorted.push_back({entry.second, entry.first});
+        std::sort(sorted.begin(), sorted.end());
+        std::vector<std::string> names;
+        for (const auto& entry : sorted) names.push_back(entry.second);
+        return names;
+    }
+};
+
+void checkStore(TaskManager& manager, const Expected& expected, const Mirror& mirror) {
+    CHECK(manager.getPendingCount() == static_cast<int>(expected.tasks.size()));
+    TaskView view = manager.tasksByUrgency();
+    CHECK(view.size() == expected.tasks.size());
+
+    std::vector<std::string> names;
+    for (const Task& task : view) {
+        CHECK(manager.findTask(task.name) == &task);  // the store itself, not a copy
+        CHECK(task.heapNode && task.heapNode->value == task.name);
+        CHECK(task.heapNode->key == static_cast<int>(task.urgency));
+        CHECK(expected.tasks.at(task.name).first == static_cast<int>(task.urgency));
+        names.push_back(task.name);
+    }
+    CHECK(names == expected.order());
+    CHECK(mirror.names == names);
+}
+
+void testRandomOperations() {
+    TaskManager manager;
+    Mirror mirror(manager);
+    manager.setListener(&mirror);
+    Expected expected;
+
+    std::mt19937 rng(38);
+    for (int step = 0; step < 5000; ++step) {
+        std::string name = "patient-" + std::to_string(rng() % 300);
+        int urgency = static_cast<int>(rng() % URGENCY_LEVELS) + 1;
+        switch (rng() % 5) {
+        case 0:
+        case 1:
+            manager.addPatient(name, static_cast<Urgency>(urgency));  // adds or updates
+            expected.set(name, urgency);
+            break;
+        case 2: {
+            bool waiting = expected.tasks.count(name) == 1;
+            CHECK(manager.updatePatientStatus(name, static_cast<Urgency>(urgency)) == waiting);
+            if (waiting) expected.set(name, urgency);
+            break;
+        }
+        case 3:
+            manager.removeTask(name);
+            expected.tasks.erase(name);
+            break;
+        default: {
+            std::string treated = manager.treatNext();
+            if (expected.tasks.empty()) {
+                CHECK(treated.empty());
+                break;
+            }
+            int most = static_cast<int>(URGENCY_LEVELS);
+            for (const auto& entry : expected.tasks) most = std::min(most, entry.second.first);
+            CHECK(expected.tasks.at(treated).first == most);
+            CHECK(manager.findTask(treated) == nullptr);
+            expected.tasks.erase(treated);
+            break;
+        }
+        }
+        if (step % 25 == 0) checkStore(manager, expected, mirror);
+    }
+    checkStore(manager, expected, mirror);
+    CHECK(mirror.resets == 0);
+
+    while (manager.getPendingCount() > 0) expected.tasks.erase(manager.treatNext());
+    CHECK(expected.tasks.empty() && manager.tasksByUrgency().empty());
+    CHECK(manager.treatNext().empty() && manager.getNextUrgent().empty());
+    checkStore(manager, expected, mirror);
+}
+
+// Same urgency: nothing moves. A new urgency: the task goes to the tail
+// of that level, whichever way it changed
+void testUrgencyChanges() {
+    TaskManager manager;
+    manager.addPatient("a", Urgency::MODERATE);
+    manager.addPatient("b", Urgency::MODERATE);
+    manager.addPatient("c", Urgency::CRITICAL);
+    manager.addPatient("d", Urgency::MINOR);
+    auto names = [&] {
+        std::vector<std::string> list;
+        for (const Task& task : manager.tasksByUrgency()) list.push_back(task.name);
+        return list;
+    };
+    CHECK((names() == std::vector<std::string>{"c", "a", "b", "d"}));
+
+    CHECK(manager.updatePatientStatus("a", Urgency::MODERATE));
+    CHECK((names() == std::vector<std::string>{"c", "a", "b", "d"}));
+    CHECK(manager.updatePatientStatus("d", Urgency::CRITICAL));
+    CHECK(manager.updatePatientStatus("c", Urgency::URGENT));
+    manager.addPatient("b", Urgency::MINOR);
+    CHECK((names() == std::vector<std::string>{"d", "c", "a", "b"}));
+    CHECK(!manager.updatePatientStatus("nobody", Urgency::URGENT));
+
+    CHECK(manager.getNextUrgent() == "d");
+    CHECK(manager.treatNext() == "d");
+    manager.removeTask("a");
+    manager.removeTask("nobody");
+    CHECK((names() == std::vector<std::string>{"c", "b"}));
+    CHECK(manager.treatNext() == "c" && manager.treatNext() == "b");
+}
+
+} // namespace
+
+int main() {
+    testRandomOperations();
+    testUrgencyChanges();
+    std::puts("task_manager_test passed");
+    return 0;
+}
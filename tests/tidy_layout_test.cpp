@@ -0,0 +1,199 @@
+// tidy_layout_test - TidyTreeLayout as a heap observer: trees that never
+// overlap, parents centred over their children, and incremental layouts
+// identical to fresh ones while rebuilding only what changed
+
+#include "FibonacciHeap.hpp"
+#include "TidyTreeLayout.hpp"
+#include "TestCheck.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace {
+
+using Heap = FibonacciHeap<int, TidyTreeLayout>;
+
+const float RADIUS = 30.0f;
+const float SIBLING_GAP = 40.0f;
+const float TREE_GAP = 120.0f;
+const float LEVEL = 120.0f;
+
+struct Placed {
+    const Heap::Node* node;
+    float x;
+    float y;
+    int parent;
+    float left;
+    float right;
+};
+
+template <typename Layout>
+std::vector<Placed> placeAll(const Heap& heap, Layout& layout) {
+    std::vector<Placed> placed;
+    layout.place(heap.roots(), 0.0f, 0.0f,
+                 [&](const Heap::Node* node, float x, float y, int parent, const TidyTreeLayout::Shape&,
+                     float left, float right) {
+        placed.push_back({node, x, y, parent, left, right});
+    });
+    return placed;
+}
+
+// Positions add up offsets in float, so far from the origin they are only
+// good to a few ulps
+float slack(float x) {
+    return 1e-3f + std::fabs(x) * 1e-6f;
+}
+
+bool near(float a, float b) {
+    return std::fabs(a - b) <= slack(std::max(std::fabs(a), std::fabs(b)));
+}
+
+void checkTidy(const Heap& heap, const std::vector<Placed>& placed) {
+    CHECK(placed.size() == static_cast<size_t>(heap.getSize()));
+    std::map<float, std::vector<float>> levels;  // y -> x of every node on it
+    std::vector<std::vector<int>> children(placed.size());
+    for (size_t i = 0; i < placed.size(); ++i) {
+        const Placed& p = placed[i];
+        levels[p.y].push_back(p.x);
+        if (p.parent < 0) {
+            CHECK(p.y == 0.0f && p.node->parent == nullptr);
+            continue;
+        }
+        const Placed& parent = placed[static_cast<size_t>(p.parent)];
+        CHECK(p.node->parent == parent.node);
+        CHECK(near(p.y, parent.y + LEVEL));
+        // inside every enclosing subtree's extent
+        for (int a = p.parent; a >= 0; a = placed[static_cast<size_t>(a)].parent) {
+            const Placed& ancestor = placed[static_cast<size_t>(a)];
+            CHECK(p.x - RADIUS >= ancestor.left - slack(p.x) && p.x + RADIUS <= ancestor.right + slack(p.x));
+        }
+        children[static_cast<size_t>(p.parent)].push_back(static_cast<int>(i));
+    }
+    // children in ring order from left to right, parent centred above
+    for (size_t i = 0; i < placed.size(); ++i) {
+        const std::vector<int>& kids = children[i];
+        CHECK(static_cast<int>(kids.size()) == placed[i].node->degree);
+        if (kids.empty()) continue;
+        for (size_t k = 1; k < kids.size(); ++k) {
+            CHECK(placed[static_cast<size_t>(kids[k])].x > placed[static_cast<size_t>(kids[k - 1])].x);
+        }
+        float first = placed[static_cast<size_t>(kids.front())].x;
+        float last = placed[static_cast<size_t>(kids.back())].x;
+        CHECK(near(placed[i].x, (first + last) / 2));
+    }
+    // no two nodes on a level closer than two radii and a sibling gap
+    for (auto& level : levels) {
+        std::vector<float>& xs = level.second;
+        std::sort(xs.begin(), xs.end());
+        for (size_t k = 1; k < xs.size(); ++k) CHECK(xs[k] - xs[k - 1] >= 2 * RADIUS + SIBLING_GAP - slack(xs[k]));
+    }
+    // trees side by side, a tree gap apart
+    float edge = 0;
+    bool first = true;
+    for (const Placed& p : placed) {
+        if (p.parent >= 0) continue;
+        if (!first) CHECK(p.left >= edge + TREE_GAP - slack(p.left));
+        first = false;
+        edge = p.right;
+    }
+}
+
+// The observer's cached shapes give the layout a fresh one computes
+void checkMatchesFresh(Heap& heap) {
+    std::vector<Placed> incremental = placeAll(heap, heap.getObserver());
+    checkTidy(heap, incremental);
+    TidyTreeLayout fresh(RADIUS, SIBLING_GAP, TREE_GAP, LEVEL);
+    std::vector<Placed> full = placeAll(heap, fresh);
+    CHECK(full.size() == incremental.size());
+    for (size_t i = 0; i < full.size(); ++i) {
+        CHECK(full[i].node == incremental[i].node && full[i].parent == incremental[i].parent);
+        CHECK(near(full[i].x, incremental[i].x) && near(full[i].y, incremental[i].y));
+        CHECK(near(full[i].left, incremental[i].left) && near(full[i].right, incremental[i].right));
+    }
+}
+
+void testRandomOperations() {
+    std::mt19937 rng(42);
+    Heap heap;
+    std::vector<Heap::Node*> live;
+    for (int step = 0; step < 3000; ++step) {
+        int op = static_cast<int>(rng() % 10);
+        if (live.empty() || op < 4) {
+            live.push_back(heap.insert(step, static_cast<int>(rng() % 100000)));
+        } else if (op < 6) {
+            Heap::Node* min = heap.extractMin();
+            live.erase(std::find(live.begin(), live.end(), min));
+            heap.release(min);
+        } else if (op < 8) {
+            Heap::Node* node = live[rng() % live.size()];
+            heap.decreaseKey(node, node->key - 1 - static_cast<int>(rng() % 5000));
+        } else if (op < 9) {
+            size_t i = rng() % live.size();
+            heap.deleteNode(live[i]);
+            live.erase(live.begin() + static_cast<std::ptrdiff_t>(i));
+        } else {
+            // trees merged in keep the shapes laid out in their own heap
+            Heap other;
+            std::vector<Heap::Node*> added;
+            for (int i = 0; i < 20; ++i) added.push_back(other.insert(-i, static_cast<int>(rng() % 100000)));
+            Heap::Node* min = other.extractMin();
+            added.erase(std::find(added.begin(), added.end(), min));
+            other.release(min);
+            placeAll(other, other.getObserver());
+            live.insert(live.end(), added.begin(), added.end());
+            heap.merge(other);
+        }
+        if (step % 20 == 0) checkMatchesFresh(heap);
+    }
+    checkMatchesFresh(heap);
+}
+
+// After a change only the shapes on the changed paths are rebuilt
+void testRebuildsOnlyChanges() {
+    Heap heap;
+    std::vector<Heap::Node*> nodes;
+    for (int i = 0; i < 2000; ++i) nodes.push_back(heap.insert(i, (i * 7919) % 2000 + 10));
+    Heap::Node* min = heap.extractMin();
+    nodes.erase(std::find(nodes.begin(), nodes.end(), min));
+    heap.release(min);
+    TidyTreeLayout& layout = heap.getObserver();
+    placeAll(heap, layout);
+    size_t before = layout.shapesRebuilt();
+    placeAll(heap, layout);
+    CHECK(layout.shapesRebuilt() == before);  // nothing changed
+
+    heap.insert(-1, 5000);
+    placeAll(heap, layout);
+    CHECK(layout.shapesRebuilt() == before + 1);  // just the new root
+
+    // a deep node cut away rebuilds itself and its old ancestors at most
+    Heap::Node* deepest = nodes.front();
+    auto depth = [](const Heap::Node* n) {
+        int d = 0;
+        for (; n->parent; n = n->parent) d++;
+        return d;
+    };
+    for (Heap::Node* n : nodes) {
+        if (depth(n) > depth(deepest)) deepest = n;
+    }
+    int d = depth(deepest);
+    CHECK(d >= 3);
+    before = layout.shapesRebuilt();
+    heap.decreaseKey(deepest, 0);
+    placeAll(heap, layout);
+    CHECK(layout.shapesRebuilt() - before <= static_cast<size_t>(d + 1));
+    checkMatchesFresh(heap);
+}
+
+} // namespace
+
+int main() {
+    testRandomOperations();
+    testRebuildsOnlyChanges();
+    std::puts("tidy_layout_test passed");
+    return 0;
+}
@@ -0,0 +1,110 @@
+// trace_test - workload traces (HeapTrace.hpp): what RecordingHeap writes
+// for each operation, and how handles follow nodes across key updates
+
+#include "HeapTrace.hpp"
+#include "TestCheck.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+struct TempFile {
+    std::string path;
+    TempFile() {
+        char name[] = "/tmp/trace_test.XXXXXX";
+        int fd = ::mkstemp(name);
+        CHECK(fd >= 0);
+        ::close(fd);
+        path = name;
+    }
+    ~TempFile() { std::remove(path.c_str()); }
+};
+
+std::vector<TraceRecord> readTrace(const std::string& path, TraceHeader& header) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    CHECK(file != nullptr);
+    CHECK(std::fread(&header, sizeof(header), 1, file) == 1);
+    std::vector<TraceRecord> records;
+    TraceRecord record;
+    while (std::fread(&record, sizeof(record), 1, file) == 1) records.push_back(record);
+    std::fclose(file);
+    return records;
+}
+
+bool is(const TraceRecord& record, TraceOp op, uint32_t handle, int key) {
+    return record.op == static_cast<uint8_t>(op) && record.handle == handle && record.key == key;
+}
+
+void testRecordedOperations() {
+    TempFile trace;
+    FibonacciHeap<int> heap;
+    {
+        HeapTraceWriter writer(trace.path);
+        RecordingHeap<int> recorder(heap, writer);
+        auto* a = recorder.insert(1, 50);                // handle 0
+        auto* b = recorder.insert(2, 30);                // handle 1
+        auto* c = recorder.insert(3, 70);                // handle 2
+        recorder.insert(4, 90);                          // handle 3
+        CHECK(recorder.getMin() == b);
+        heap.release(recorder.extractMin());             // b
+        recorder.decreaseKey(c, 20);
+        auto* moved = recorder.updateKey(a, 80);         // may move to a new node
+        recorder.updateKey(moved, 10);                   // still handle 0
+        recorder.deleteNode(c);
+        CHECK(writer.recordCount() == 10);
+    }
+    CHECK(heap.getSize() == 2);
+
+    TraceHeader header;
+    std::vector<TraceRecord> records = readTrace(trace.path, header);
+    CHECK(std::string(header.magic, 4) == "FHTR");
+    CHECK(header.version == TRACE_VERSION);
+    CHECK(header.recordSize == sizeof(TraceRecord));
+    CHECK(header.recordCount == 10);  // patched in on close
+    CHECK(records.size() == 10);
+
+    CHECK(is(records[0], TraceOp::INSERT, 0, 50));
+    CHECK(is(records[1], TraceOp::INSERT, 1, 30));
+    CHECK(is(records[2], TraceOp::INSERT, 2, 70));
+    CHECK(is(records[3], TraceOp::INSERT, 3, 90));
+    CHECK(is(records[4], TraceOp::GET_MIN, TRACE_NO_HANDLE, 0));
+    CHECK(is(records[5], TraceOp::EXTRACT_MIN, 1, 0));
+    CHECK(is(records[6], TraceOp::DECREASE_KEY, 2, 20));
+    CHECK(is(records[7], TraceOp::UPDATE_KEY, 0, 80));
+    CHECK(is(records[8], TraceOp::UPDATE_KEY, 0, 10));
+    CHECK(is(records[9], TraceOp::DELETE_NODE, 2, 0));
+    CHECK(records[8].reserved[0] == 0 && records[8].reserved[1] == 0 && records[8].reserved[2] == 0);
+}
+
+// Records are buffered; the count on disk stays 0 until the writer closes,
+// which is how readers tell a truncated trace
+void testBufferedRecords() {
+    TempFile trace;
+    FibonacciHeap<int> heap;
+    HeapTraceWriter writer(trace.path);
+    RecordingHeap<int> recorder(heap, writer);
+    for (int i = 0; i < 5000; ++i) recorder.insert(i, i);
+
+    TraceHeader header;
+    std::vector<TraceRecord> records = readTrace(trace.path, header);
+    CHECK(header.recordCount == 0);
+    CHECK(records.size() == 4096);
+    CHECK(is(records[4095], TraceOp::INSERT, 4095, 4095));
+
+    writer.flush();
+    records = readTrace(trace.path, header);
+    CHECK(records.size() == 5000);
+    CHECK(writer.recordCount() == 5000);
+}
+
+} // namespace
+
+int main() {
+    testRecordedOperations();
+    testBufferedRecords();
+    std::puts("trace_test passed");
+    return 0;
+}
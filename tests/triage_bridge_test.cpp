@@ -0,0 +1,405 @@
+// triage_bridge_test - TriageBridge from the QML triage app
+// (MyEmergencyTriage): change notifications coalesced per frame, and the
+// incremental row signals of its PatientListModel, and the severity
+// counts kept by its heap observer; priority updates by patient id
+
+#include "TriageBridge.hpp"
+#include "PatientListModel.hpp"
+#include "TestCheck.hpp"
+#include <QCoreApplication>
+#include <QEventLoop>
+#include <QTimer>
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Runs the event loop past the bridge's one-frame notification timer
+void processFrame() {
+    QEventLoop loop;
+    QTimer::singleShot(50, &loop, &QEventLoop::quit);
+    loop.exec();
+}
+
+struct Notifications {
+    int patients = 0;
+    int count = 0;
+    int critical = 0;
+    int urgent = 0;
+    int treated = 0;
+    int top = 0;
+
+    explicit Notifications(TriageBridge& bridge) {
+        QObject::connect(&bridge, &TriageBridge::patientsChanged, [this] { patients++; });
+        QObject::connect(&bridge, &TriageBridge::patientCountChanged, [this] { count++; });
+        QObject::connect(&bridge, &TriageBridge::criticalCountChanged, [this] { critical++; });
+        QObject::connect(&bridge, &TriageBridge::urgentCountChanged, [this] { urgent++; });
+        QObject::connect(&bridge, &TriageBridge::treatedCountChanged, [this] { treated++; });
+        QObject::connect(&bridge, &TriageBridge::topPatientChanged, [this] { top++; });
+    }
+
+    int total() const { return patients + count + critical + urgent + treated + top; }
+};
+
+// Any number of changes within a frame signal each property once, and
+// only the properties they touched
+void testCoalescedNotifications() {
+    TriageBridge bridge;
+    Notifications seen(bridge);
+
+    bridge.addPatient("Ann", "Fever", 5);
+    bridge.addPatient("Ben", "Fracture", 2);
+    bridge.addPatient("Cal", "Chest Pain", 1);
+    CHECK(seen.total() == 0);  // nothing before the frame ends
+    processFrame();
+    CHECK(seen.patients == 1 && seen.count == 1 && seen.critical == 1 && seen.urgent == 1 && seen.top == 1);
+    CHECK(seen.treated == 0);
+    CHECK(bridge.patientCount() == 3);
+
+    bridge.treatNext();
+    bridge.treatNext();
+    processFrame();
+    CHECK(seen.treated == 1 && seen.count == 2 && seen.patients == 2);
+    CHECK(bridge.treatedCount() == 2);
+
+    processFrame();  // nothing changed, nothing signalled
+    CHECK(seen.total() == 11);
+}
+
+// Between beginUpdate() and endUpdate() nothing is signalled, however long
+// it takes; the changes are signalled in the frame after
+void testUpdateScope() {
+    TriageBridge bridge;
+    Notifications seen(bridge);
+
+    bridge.addPatient("Ann", "Fever", 5);  // the frame timer is running
+    bridge.beginUpdate();
+    processFrame();
+    bridge.beginUpdate();  // nested
+    bridge.simulateMassEmergency(20);
+    bridge.endUpdate();
+    processFrame();
+    CHECK(seen.total() == 0);
+    bridge.endUpdate();
+    bridge.endUpdate();  // unmatched: ignored
+    CHECK(seen.total() == 0);
+    processFrame();
+    CHECK(seen.patients == 1 && seen.count == 1 && seen.top == 1);
+    CHECK(bridge.patientCount() == 21);
+}
+
+// Replays the model's row signals on a list of ids, as a view would
+struct ViewMirror {
+    PatientListModel& model;
+    std::vector<int> ids;
+    int inserts = 0;
+    int removes = 0;
+    int moves = 0;
+    int resets = 0;
+    int changes = 0;
+    int lastChanged = -1;
+
+    explicit ViewMirror(PatientListModel& m) : model(m) {
+        QObject::connect(&model, &QAbstractItemModel::rowsInserted,
+                         [this](const QModelIndex&, int first, int last) {
+            for (int row = first; row <= last; ++row) ids.insert(ids.begin() + row, idAt(row));
+            inserts++;
+        });
+        QObject::connect(&model, &QAbstractItemModel::rowsRemoved,
+                         [this](const QModelIndex&, int first, int last) {
+            ids.erase(ids.begin() + first, ids.begin() + last + 1);
+            removes++;
+        });
+        // the destination row counts the moved rows as still in place
+        QObject::connect(&model, &QAbstractItemModel::rowsMoved,
+                         [this](const QModelIndex&, int first, int last, const QModelIndex&, int destination) {
+            std::vector<int> block(ids.begin() + first, ids.begin() + last + 1);
+            ids.erase(ids.begin() + first, ids.begin() + last + 1);
+            int at = destination > last ? destination - static_cast<int>(block.size()) : destination;
+            ids.insert(ids.begin() + at, block.begin(), block.end());
+            moves++;
+        });
+        QObject::connect(&model, &QAbstractItemModel::modelReset, [this] {
+            ids.clear();
+            for (int row = 0; row < model.rowCount(); ++row) ids.push_back(idAt(row));
+            resets++;
+        });
+        QObject::connect(&model, &QAbstractItemModel::dataChanged,
+                         [this](const QModelIndex& topLeft, const QModelIndex&, const QList<int>&) {
+            lastChanged = topLeft.row();
+            changes++;
+        });
+    }
+
+    int idAt(int row) const { return model.data(model.index(row), PatientListModel::IdRole).toInt(); }
+    int priorityAt(int row) const { return model.data(model.index(row), PatientListModel::PriorityRole).toInt(); }
+
+    // the mirror holds the model's rows, and they are in (priority, id) order
+    bool matches() const {
+        if (static_cast<int>(ids.size()) != model.rowCount()) return false;
+        for (int row = 0; row < model.rowCount(); ++row) {
+            if (ids[static_cast<size_t>(row)] != idAt(row)) return false;
+            if (row > 0 && (priorityAt(row - 1) > priorityAt(row) ||
+                            (priorityAt(row - 1) == priorityAt(row) && idAt(row - 1) > idAt(row)))) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+std::shared_ptr<Patient> makePatient(int id, int priority) {
+    return std::make_shared<Patient>(id, "Patient " + QString::number(id), "Fever", priority);
+}
+
+// Each change is one insert, remove or move of the affected row
+void testModelRows() {
+    PatientListModel model;
+    ViewMirror view(model);
+    std::vector<std::shared_ptr<Patient>> patients;
+    int priorities[] = {5, 2, 8, 2, 1, 5, 9, 3};
+    for (int i = 0; i < 8; ++i) {
+        patients.push_back(makePatient(i + 1, priorities[i]));
+        model.insertPatient(patients.back());
+        CHECK(view.matches());
+    }
+    CHECK(view.inserts == 8 && view.resets == 0);
+    CHECK(view.idAt(0) == 5 && view.idAt(1) == 2 && view.idAt(2) == 4);  // ties by id
+
+    auto change = [&](int id, int priority) {
+        Patient& patient = *patients[static_cast<size_t>(id - 1)];
+        int old = patient.priority;
+        patient.priority = priority;
+        model.priorityChanged(patient, old);
+    };
+
+    change(7, 0);  // last to first
+    CHECK(view.moves == 1 && view.matches() && view.idAt(0) == 7);
+    CHECK(view.changes == 1 && view.lastChanged == 0);
+    change(5, 6);  // down past several rows
+    CHECK(view.moves == 2 && view.matches());
+    CHECK(view.lastChanged == 6 && view.idAt(6) == 5);
+    change(6, 2);  // after the others with priority 2
+    CHECK(view.moves == 3 && view.matches() && view.idAt(3) == 6);
+    change(3, 10);  // already last: no move, only the data changes
+    CHECK(view.moves == 3 && view.changes == 4 && view.lastChanged == 7);
+    CHECK(view.matches());
+
+    model.removePatient(*patients[0]);
+    CHECK(view.removes == 1 && view.matches() && model.rowCount() == 7);
+    Patient stranger(99, "Nobody", "Fever", 4);
+    model.removePatient(stranger);
+    model.priorityChanged(stranger, 3);
+    CHECK(view.removes == 1 && view.moves == 3 && view.changes == 4);
+    CHECK(view.inserts == 8 && view.resets == 0);
+}
+
+// Batched inserts show up together at endBatch(), one insert each, and a
+// large batch as a single reset
+void testModelBatches() {
+    PatientListModel model;
+    ViewMirror view(model);
+    std::vector<std::shared_ptr<Patient>> patients;
+    int nextId = 1;
+    auto add = [&](int priority) {
+        patients.push_back(makePatient(nextId++, priority));
+        model.insertPatient(patients.back());
+    };
+
+    model.beginBatch();
+    model.beginBatch();  // nested
+    for (int i = 0; i < 10; ++i) add((i * 7) % 10);
+    model.endBatch();
+    CHECK(view.inserts == 0 && model.rowCount() == 0);
+    model.endBatch();
+    CHECK(view.inserts == 10 && view.matches());
+    model.endBatch();  // unmatched: ignored
+    CHECK(model.rowCount() == 10);
+
+    // a removal inside a batch sees the rows inserted before it
+    model.beginBatch();
+    add(4);
+    model.removePatient(*patients.back());
+    CHECK(view.removes == 1 && view.matches() && model.rowCount() == 10);
+    model.endBatch();
+
+    model.beginBatch();
+    for (int i = 0; i < 300; ++i) add((i * 31) % 10);
+    model.endBatch();
+    CHECK(view.resets == 1 && view.inserts == 11);
+    CHECK(model.rowCount() == 310 && view.matches());
+}
+
+// The counter against a count of every node, roots and children alike,
+// under a random mix of the operations that change keys or membership
+void testSeverityCounter() {
+    using Heap = FibonacciHeap<int, SeverityCounter>;
+    auto exact = [](const Heap& heap, const SeverityCounter& counter) {
+        int counts[SeverityCounter::LEVEL_COUNT] = {};
+        for (auto* node : heap.nodes()) counts[SeverityCounter::levelOf(node->key)]++;
+        for (int level = 0; level < SeverityCounter::LEVEL_COUNT; ++level) {
+            if (counter.count(static_cast<SeverityCounter::Level>(level)) != counts[level]) return false;
+        }
+        return true;
+    };
+
+    std::mt19937 rng(36);
+    std::uniform_int_distribution<int> priority(0, 11);
+    Heap heap;
+    std::vector<Heap::Node*> live;
+    for (int step = 0; step < 4000; ++step) {
+        int op = static_cast<int>(rng() % 7);
+        if (live.empty() || op <= 1 || op == 6) {
+            live.push_back(heap.insert(step, priority(rng)));
+        } else if (op == 2) {
+            Heap::Node* min = heap.extractMin();
+            live.erase(std::find(live.begin(), live.end(), min));
+            heap.release(min);
+        } else {
+            size_t i = rng() % live.size();
+            if (op == 3) {
+                heap.decreaseKey(live[i], live[i]->key - 1 - static_cast<int>(rng() % 3));
+            } else if (op == 4) {
+                live[i] = heap.updateKey(live[i], priority(rng));
+            } else {
+                heap.deleteNode(live[i]);
+                live.erase(live.begin() + static_cast<std::ptrdiff_t>(i));
+            }
+        }
+        if (step % 50 == 0) CHECK(exact(heap, heap.getObserver()));
+    }
+    CHECK(exact(heap, heap.getObserver()));
+    bool inChildren = false;
+    for (auto* node : heap.nodes()) inChildren = inChildren || (node->parent && node->key <= 3);
+    CHECK(inChildren);  // the counts cover patients below the roots too
+
+    Heap copy = heap.clone();
+    CHECK(exact(copy, copy.getObserver()));
+    Heap other;
+    for (int i = 0; i < 30; ++i) other.insert(i, i % 12);
+    heap.merge(other);
+    CHECK(exact(heap, heap.getObserver()));
+    CHECK(exact(other, other.getObserver()));
+    heap.clear();
+    CHECK(exact(heap, heap.getObserver()));
+}
+
+// The bridge's counts match the waiting patients as the model lists them
+void testSeverityCounts() {
+    TriageBridge bridge;
+    QAbstractItemModel* model = bridge.patientModel();
+    auto matches = [&] {
+        int critical = 0;
+        int urgent = 0;
+        for (int row = 0; row < model->rowCount(); ++row) {
+            int priority = model->data(model->index(row, 0), PatientListModel::PriorityRole).toInt();
+            critical += SeverityCounter::levelOf(priority) == SeverityCounter::CRITICAL;
+            urgent += SeverityCounter::levelOf(priority) == SeverityCounter::URGENT;
+        }
+        return bridge.criticalCount() == critical && bridge.urgentCount() == urgent;
+    };
+
+    bridge.addPatient("Ann", "Fever", 5);
+    bridge.addPatient("Ben", "Fracture", 1);
+    bridge.addPatient("Cal", "Chest Pain", 3);
+    CHECK(bridge.criticalCount() == 1 && bridge.urgentCount() == 1);
+    bridge.updatePriority(1, 0);  // moderate to critical
+    CHECK(bridge.criticalCount() == 2 && bridge.urgentCount() == 1);
+    bridge.updatePriority(2, 9);  // critical to routine
+    CHECK(bridge.criticalCount() == 1 && bridge.urgentCount() == 1);
+    bridge.treatNext();
+    CHECK(bridge.criticalCount() == 0 && bridge.urgentCount() == 1);
+
+    bridge.simulateMassEmergency(300);
+    bridge.treatNext();  // links the roots into trees
+    CHECK(matches());
+    std::mt19937 rng(37);
+    for (int i = 0; i < 200; ++i) {
+        int row = static_cast<int>(rng() % static_cast<unsigned>(model->rowCount()));
+        int id = model->data(model->index(row, 0), PatientListModel::IdRole).toInt();
+        bridge.updatePriority(id, static_cast<int>(rng() % 12));
+        if (i % 20 == 0) bridge.treatNext();
+    }
+    CHECK(matches());
+}
+
+// Priority by id of every patient the model lists
+std::map<int, int> listedPriorities(QAbstractItemModel* model) {
+    std::map<int, int> priorities;
+    for (int row = 0; row < model->rowCount(); ++row) {
+        QModelIndex index = model->index(row, 0);
+        priorities[model->data(index, PatientListModel::IdRole).toInt()] =
+            model->data(index, PatientListModel::PriorityRole).toInt();
+    }
+    return priorities;
+}
+
+// updatePriority() reaches every waiting patient by id, wherever its node
+// sits in the heap and after an increase has moved it to a new node
+void testUpdateById() {
+    TriageBridge bridge;
+    QAbstractItemModel* model = bridge.patientModel();
+    std::map<int, int> expected;
+    for (int id = 1; id <= 40; ++id) {
+        int priority = (id * 7) % 10 + 1;
+        bridge.addPatient("Patient " + QString::number(id), "Fever", priority);
+        expected[id] = priority;
+    }
+    QVariantMap top = bridge.topPatient();
+    int treatedId = top["id"].toInt();
+    bridge.treatNext();  // links the rest into trees
+    expected.erase(treatedId);
+
+    std::mt19937 rng(38);
+    for (int round = 0; round < 3; ++round) {
+        for (auto& entry : expected) {
+            entry.second = static_cast<int>(rng() % 10) + 1;  // up or down
+            bridge.updatePriority(entry.first, entry.second);
+        }
+        CHECK(listedPriorities(model) == expected);
+    }
+    bridge.updatePriority(27, 0);
+    expected[27] = 0;
+    top = bridge.topPatient();
+    CHECK(top["id"].toInt() == 27 && bridge.topPatientName() == "Patient 27");
+
+    // unknown and treated ids change nothing
+    for (int id : {0, -3, 41, 1000, treatedId}) bridge.updatePriority(id, 1);
+    CHECK(listedPriorities(model) == expected);
+    CHECK(bridge.patientCount() == 39);
+
+    // the heap agrees: patients come out in priority order, at the
+    // priorities they were given
+    int last = -1;
+    while (bridge.patientCount() > 0) {
+        top = bridge.topPatient();
+        int id = top["id"].toInt();
+        CHECK(expected.count(id) == 1 && top["priority"].toInt() == expected[id]);
+        CHECK(expected[id] >= last);
+        last = expected[id];
+        expected.erase(id);
+        bridge.treatNext();
+    }
+    CHECK(expected.empty());
+    bridge.updatePriority(27, 1);  // every patient treated
+    CHECK(bridge.patientCount() == 0 && model->rowCount() == 0);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    testCoalescedNotifications();
+    testUpdateScope();
+    testModelRows();
+    testModelBatches();
+    testSeverityCounter();
+    testSeverityCounts();
+    testUpdateById();
+    std::puts("triage_bridge_test passed");
+    return 0;
+}
@@ -0,0 +1,169 @@
+// vector_test - Vector.hpp: inline storage, construction only of elements
+// actually added, strong guarantee on growth, aliasing arguments and
+// allocator-aware copies and moves
+
+#include "Vector.hpp"
+#include "TestCheck.hpp"
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace {
+
+int liveObjects = 0;
+int copiesLeft = -1;  // Tracked copies throw once this reaches 0
+
+// Counts live instances; the move is not noexcept, so growth has to copy,
+// and copies can be made to throw
+struct Tracked {
+    int value;
+    explicit Tracked(int v = 0) : value(v) { liveObjects++; }
+    Tracked(const Tracked& other) : value(other.value) {
+        if (copiesLeft == 0) throw std::runtime_error("copy failed");
+        if (copiesLeft > 0) copiesLeft--;
+        liveObjects++;
+    }
+    Tracked(Tracked&& other) : value(other.value) { liveObjects++; }
+    Tracked& operator=(const Tracked&) = default;
+    ~Tracked() { liveObjects--; }
+};
+
+// Stateful allocator that counts its allocations; allocators with
+// different ids cannot free each other's storage
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::false_type;
+    int id;
+    int* allocations;
+    CountingAllocator(int i, int* count) : id(i), allocations(count) {}
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>& other) : id(other.id), allocations(other.allocations) {}
+    T* allocate(size_t n) {
+        (*allocations)++;
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+    void deallocate(T* p, size_t) { ::operator delete(p); }
+    bool operator==(const CountingAllocator& other) const { return id == other.id; }
+    bool operator!=(const CountingAllocator& other) const { return id != other.id; }
+};
+
+void testInlineThenSpill() {
+    int allocations = 0;
+    using Ints = Vector<int, 4, CountingAllocator<int>>;
+    Ints v(CountingAllocator<int>(1, &allocations));
+    for (int i = 0; i < 4; ++i) v.push_back(i);
+    CHECK(allocations == 0);
+    CHECK(v.capacity() == 4);
+    v.push_back(4);
+    CHECK(allocations == 1);
+    CHECK(v.capacity() == 8);
+    for (int i = 0; i < 5; ++i) CHECK(v[i] == i);
+    v.reserve(100);
+    CHECK(allocations == 2 && v.capacity() == 100 && v.size() == 5);
+}
+
+void testConstructsOnlyWhatIsAdded() {
+    {
+        Vector<Tracked, 2> v;
+        CHECK(liveObjects == 0);  // inline slots are raw storage
+        v.reserve(64);
+        CHECK(liveObjects == 0);
+        v.emplace_back(1);
+        v.resize(10, Tracked(7));
+        CHECK(liveObjects == 10);
+        v.resize(3);
+        CHECK(liveObjects == 3);
+        v.pop_back();
+        CHECK(liveObjects == 2 && v.back().value == 7);
+    }
+    CHECK(liveObjects == 0);
+}
+
+// A copy that throws while the vector grows leaves it as it was
+void testStrongGuarantee() {
+    {
+        Vector<Tracked, 2> v;
+        for (int i = 0; i < 8; ++i) v.emplace_back(i);
+        size_t capacity = v.capacity();
+        CHECK(v.size() == capacity);
+        copiesLeft = 3;  // the fourth of the eight copies throws
+        CHECK_THROWS(v.emplace_back(8));
+        copiesLeft = -1;
+        CHECK(v.size() == 8 && v.capacity() == capacity);
+        for (int i = 0; i < 8; ++i) CHECK(v[i].value == i);
+        CHECK(liveObjects == 8);
+    }
+    CHECK(liveObjects == 0);
+}
+
+// The argument may be an element of the vector whose storage is replaced
+void testAliasingArguments() {
+    Vector<std::string, 2> v;
+    v.push_back(std::string(40, 'a'));
+    v.push_back(std::string(40, 'b'));
+    v.push_back(v[0]);
+    CHECK(v.size() == 3 && v[2] == std::string(40, 'a'));
+    v.resize(v.capacity() + 5, v[1]);
+    CHECK(v.back() == std::string(40, 'b'));
+}
+
+void testCopyAndMove() {
+    Vector<std::string, 2> small;
+    small.push_back("x");
+    Vector<std::string, 2> large;
+    for (int i = 0; i < 10; ++i) large.push_back(std::to_string(i));
+
+    Vector<std::string, 2> copy(large);
+    CHECK(copy.size() == 10 && copy[9] == "9" && copy.data() != large.data());
+
+    const std::string* buffer = large.data();
+    Vector<std::string, 2> moved(std::move(large));
+    CHECK(moved.data() == buffer);  // a heap buffer changes hands
+    CHECK(large.empty() && large.capacity() == 2);
+
+    Vector<std::string, 2> movedSmall(std::move(small));
+    CHECK(movedSmall.size() == 1 && movedSmall[0] == "x" && small.empty());
+
+    copy = movedSmall;
+    CHECK(copy.size() == 1 && copy[0] == "x");
+    copy = std::move(moved);
+    CHECK(copy.size() == 10 && copy.data() == buffer && moved.empty());
+}
+
+// Storage cannot change hands between unequal allocators that do not
+// propagate, so the elements are moved one by one instead
+void testUnequalAllocators() {
+    int first = 0;
+    int second = 0;
+    using Ints = Vector<int, 2, CountingAllocator<int>>;
+    Ints a(CountingAllocator<int>(1, &first));
+    Ints b(CountingAllocator<int>(2, &second));
+    for (int i = 0; i < 8; ++i) a.push_back(i);
+    const int* buffer = a.data();
+    b = std::move(a);
+    CHECK(b.size() == 8 && b[7] == 7);
+    CHECK(b.data() != buffer);
+    CHECK(b.get_allocator().id == 2 && second == 1);
+    CHECK(a.empty());
+
+    // only allocators that always hand over their storage make the move
+    // assignment noexcept
+    static_assert(std::is_nothrow_move_assignable<Vector<int, 2>>::value, "");
+    static_assert(!std::is_nothrow_move_assignable<Ints>::value, "");
+    static_assert(!std::is_nothrow_move_assignable<Vector<Tracked, 2>>::value, "");
+}
+
+} // namespace
+
+int main() {
+    testInlineThenSpill();
+    testConstructsOnlyWhatIsAdded();
+    testStrongGuarantee();
+    testAliasingArguments();
+    testCopyAndMove();
+    testUnequalAllocators();
+    std::puts("vector_test passed");
+    return 0;
+}
@@ -0,0 +1,533 @@
+// heap_replay - replays a recorded heap workload against one or more engines
+//
+// Usage:
+//   heap_replay <trace> [--engine fibonacci|observed|incremental|binary|all]
+//               [--repeat N] [--budget N]
+//   heap_replay --generate <trace> <ops> [seed] [--burst N]
+//
+// Traces are produced by HeapTraceWriter (TaskManagerGUI records one when
+// TASKMANAGER_TRACE=<path> is set). The trace is memory-mapped and replayed
+// at full speed; each engine reports throughput, per-operation latency
+// percentiles and a checksum of the extracted keys and final heap state,
+// which must match across engines for the same trace. The observed engine
+// is the Fibonacci heap with a counting observer on every hook, so its
+// difference to fibonacci is the cost of the instrumentation. The
+// incremental engine is the same heap consolidating --budget steps per
+// operation (default 4) instead of all at once in extractMin(); compare
+// its p99.9 and max against fibonacci. --burst makes the generated
+// workload insert N nodes in a row every so often, the case where eager
+// consolidation stalls.
+
+#include "FibonacciHeap.hpp"
+#include "HeapTrace.hpp"
+#include "MappedFile.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// =====================================================================
+// Engines
+// =====================================================================
+
+/**
+ * Observer that counts every structural event, to measure what an
+ * instrumented heap pays per event compared to NullHeapObserver.
+ */
+struct EventCounter : NullHeapObserver {
+    uint64_t events = 0;
+
+    template <typename Node> void inserted(const Node*) { events++; }
+    template <typename Node> void extracted(const Node*) { events++; }
+    template <typename Node> void keyChanged(const Node*, int) { events++; }
+    template <typename Node> void linked(const Node*, const Node*) { events++; }
+    template <typename Node> void cut(const Node*, const Node*) { events++; }
+    template <typename Node> void marked(const Node*) { events++; }
+    template <typename Node> void unmarked(const Node*) { events++; }
+    template <typename Node, typename Source> void merged(const Node*, Source&) { events++; }
+    void cleared() { events++; }
+};
+
+/**
+ * FibonacciHeap under test. The payload is the trace handle so the
+ * extracted node can be mapped back to its slot.
+ */
+template <typename Observer>
+class BasicFibonacciEngine {
+private:
+    using Heap = FibonacciHeap<uint32_t, Observer>;
+    Heap heap;
+    std::vector<typename Heap::Node*> nodes;
+
+public:
+    static const char* name();
+
+    explicit BasicFibonacciEngine(int consolidationBudget = 0) {
+        heap.setConsolidationBudget(consolidationBudget);
+    }
+
+    void reserve(size_t handles) { nodes.resize(handles, nullptr); }
+
+    void insert(uint32_t handle, int key) {
+        if (handle >= nodes.size()) nodes.resize(handle + 1, nullptr);
+        nodes[handle] = heap.insert(handle, key);
+    }
+
+    bool peekMin(int& key) const {
+        auto* min = heap.getMin();
+        if (!min) return false;
+        key = min->key;
+        return true;
+    }
+
+    bool extractMin(int& key, uint32_t& handle) {
+        auto* min = heap.extractMin();
+        if (!min) return false;
+        key = min->key;
+        handle = min->value;
+        nodes[handle] = nullptr;
+        heap.release(min);
+        return true;
+    }
+
+    void rename(uint32_t from, uint32_t to) {
+        if (from >= nodes.size() || !nodes[from]) return;
+        if (to >= nodes.size()) nodes.resize(to + 1, nullptr);
+        nodes[to] = nodes[from];
+        nodes[to]->value = to;
+        nodes[from] = nullptr;
+    }
+
+    void decreaseKey(uint32_t handle, int key) {
+        if (handle < nodes.size() && nodes[handle]) heap.decreaseKey(nodes[handle], key);
+    }
+
+    void updateKey(uint32_t handle, int key) {
+        if (handle < nodes.size() && nodes[handle]) nodes[handle] = heap.updateKey(nodes[handle], key);
+    }
+
+    void erase(uint32_t handle) {
+        if (handle < nodes.size() && nodes[handle]) {
+            heap.deleteNode(nodes[handle]);
+            nodes[handle] = nullptr;
+        }
+    }
+
+    int size() const { return heap.getSize(); }
+
+    template <typename F>
+    void forEachKey(F f) const {
+        for (auto* node : nodes) {
+            if (node) f(node->key);
+        }
+    }
+};
+
+template <> const char* BasicFibonacciEngine<NullHeapObserver>::name() { return "fibonacci"; }
+template <> const char* BasicFibonacciEngine<EventCounter>::name() { return "observed"; }
+
+using FibonacciEngine = BasicFibonacciEngine<NullHeapObserver>;
+// the same heap with every observer hook counting
+using ObservedFibonacciEngine = BasicFibonacciEngine<EventCounter>;
+// FibonacciEngine constructed with a consolidation budget
+const char* const INCREMENTAL_ENGINE = "incremental";
+
+/**
+ * Indexed binary heap used as the reference engine.
+ */
+class BinaryEngine {
+private:
+    static constexpr uint32_t ABSENT = 0xFFFFFFFFu;
+    std::vector<uint32_t> heap;      // handles in heap order
+    std::vector<uint32_t> position;  // handle -> index in heap
+    std::vector<int> keys;           // handle -> key
+
+    void place(size_t i, uint32_t handle) {
+        heap[i] = handle;
+        position[handle] = static_cast<uint32_t>(i);
+    }
+
+    void siftUp(size_t i) {
+        uint32_t handle = heap[i];
+        int key = keys[handle];
+        while (i > 0) {
+            size_t parent = (i - 1) / 2;
+            if (keys[heap[parent]] <= key) break;
+            place(i, heap[parent]);
+            i = parent;
+        }
+        place(i, handle);
+    }
+
+    void siftDown(size_t i) {
+        uint32_t handle = heap[i];
+        int key = keys[handle];
+        size_t n = heap.size();
+        for (;;) {
+            size_t child = 2 * i + 1;
+            if (child >= n) break;
+            if (child + 1 < n && keys[heap[child + 1]] < keys[heap[child]]) child++;
+            if (keys[heap[child]] >= key) break;
+            place(i, heap[child]);
+            i = child;
+        }
+        place(i, handle);
+    }
+
+    void removeAt(size_t i) {
+        uint32_t removed = heap[i];
+        uint32_t last = heap.back();
+        heap.pop_back();
+        position[removed] = ABSENT;
+        if (i < heap.size()) {
+            place(i, last);
+            siftDown(i);
+            siftUp(position[last]);
+        }
+    }
+
+    bool contains(uint32_t handle) const {
+        return handle < position.size() && position[handle] != ABSENT;
+    }
+
+public:
+    static const char* name() { return "binary"; }
+
+    void reserve(size_t handles) {
+        heap.reserve(handles);
+        position.resize(handles, ABSENT);
+        keys.resize(handles, 0);
+    }
+
+    void insert(uint32_t handle, int key) {
+        if (handle >= position.size()) {
+            position.resize(handle + 1, ABSENT);
+            keys.resize(handle + 1, 0);
+        }
+        keys[handle] = key;
+        heap.push_back(handle);
+        position[handle] = static_cast<uint32_t>(heap.size() - 1);
+        siftUp(heap.size() - 1);
+    }
+
+    bool peekMin(int& key) const {
+        if (heap.empty()) return false;
+        key = keys[heap[0]];
+        return true;
+    }
+
+    bool extractMin(int& key, uint32_t& handle) {
+        if (heap.empty()) return false;
+        handle = heap[0];
+        key = keys[handle];
+        removeAt(0);
+        return true;
+    }
+
+    void rename(uint32_t from, uint32_t to) {
+        if (!contains(from)) return;
+        if (to >= position.size()) {
+            position.resize(to + 1, ABSENT);
+            keys.resize(to + 1, 0);
+        }
+        keys[to] = keys[from];
+        place(position[from], to);
+        position[from] = ABSENT;
+    }
+
+    void decreaseKey(uint32_t handle, int key) {
+        if (!contains(handle)) return;
+        keys[handle] = key;
+        siftUp(position[handle]);
+    }
+
+    void updateKey(uint32_t handle, int key) {
+        if (!contains(handle)) return;
+        int old = keys[handle];
+        keys[handle] = key;
+        if (key < old) siftUp(position[handle]);
+        else siftDown(position[handle]);
+    }
+
+    void erase(uint32_t handle) {
+        if (contains(handle)) removeAt(position[handle]);
+    }
+
+    int size() const { return static_cast<int>(heap.size()); }
+
+    template <typename F>
+    void forEachKey(F f) const {
+        for (uint32_t handle : heap) f(keys[handle]);
+    }
+};
+
+// =====================================================================
+// Replay
+// =====================================================================
+
+struct TraceView {
+    const TraceRecord* records;
+    size_t count;
+};
+
+struct ReplayResult {
+    double seconds = 0.0;
+    std::vector<uint32_t> latencies;  // nanoseconds per operation
+    uint64_t checksum = 0;
+    int finalSize = 0;
+};
+
+inline uint64_t mix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+template <typename Engine, typename... Args>
+ReplayResult replay(const TraceView& trace, Args... engineArgs) {
+    using Clock = std::chrono::steady_clock;
+    ReplayResult result;
+    result.latencies.resize(trace.count);
+
+    Engine engine(engineArgs...);
+    uint64_t sequenceHash = 0;  // order-sensitive hash of observed keys
+
+    // Handle tables are sized up front, so growing them is not measured
+    // as the latency of whichever insert happened to trigger it
+    size_t handles = 0;
+    for (size_t i = 0; i < trace.count; ++i) {
+        uint32_t handle = trace.records[i].handle;
+        if (handle != TRACE_NO_HANDLE) handles = std::max<size_t>(handles, handle + 1);
+    }
+    engine.reserve(handles);
+
+    auto wallStart = Clock::now();
+    for (size_t i = 0; i < trace.count; ++i) {
+        const TraceRecord& rec = trace.records[i];
+        int key = 0;
+        uint32_t extracted = TRACE_NO_HANDLE;
+        auto start = Clock::now();
+        switch (static_cast<TraceOp>(rec.op)) {
+            case TraceOp::INSERT:
+                engine.insert(rec.handle, rec.key);
+                break;
+            case TraceOp::EXTRACT_MIN:
+                if (engine.extractMin(key, extracted)) {
+                    sequenceHash = mix(sequenceHash ^ static_cast<uint32_t>(key));
+                    // On equal keys the engine may pick a different node than the
+                    // recording did; the recorded node takes over the extracted
+                    // one's identity so later records still refer to live nodes
+                    if (extracted != rec.handle && rec.handle != TRACE_NO_HANDLE) {
+                        engine.rename(rec.handle, extracted);
+                    }
+                }
+                break;
+            case TraceOp::GET_MIN:
+                if (engine.peekMin(key)) sequenceHash = mix(sequenceHash ^ static_cast<uint32_t>(key));
+                break;
+            case TraceOp::DECREASE_KEY:
+                engine.decreaseKey(rec.handle, rec.key);
+                break;
+            case TraceOp::UPDATE_KEY:
+                engine.updateKey(rec.handle, rec.key);
+                break;
+            case TraceOp::DELETE_NODE:
+                engine.erase(rec.handle);
+                break;
+        }
+        auto end = Clock::now();
+        result.latencies[i] = static_cast<uint32_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+    result.seconds = std::chrono::duration<double>(Clock::now() - wallStart).count();
+
+    // The final state is hashed order-independently so engines with
+    // different internal layouts agree
+    uint64_t stateHash = 0;
+    engine.forEachKey([&stateHash](int key) { stateHash += mix(static_cast<uint32_t>(key)); });
+    result.finalSize = engine.size();
+    result.checksum = mix(sequenceHash ^ mix(stateHash ^ static_cast<uint64_t>(result.finalSize)));
+    return result;
+}
+
+uint32_t percentile(const std::vector<uint32_t>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1));
+    return sorted[index];
+}
+
+void report(const char* engineName, ReplayResult& result) {
+    std::vector<uint32_t>& lat = result.latencies;
+    std::sort(lat.begin(), lat.end());
+    double mops = result.seconds > 0 ? lat.size() / result.seconds / 1e6 : 0.0;
+
+    std::cout << std::left << std::setw(12) << engineName << std::right
+              << std::fixed << std::setprecision(2)
+              << std::setw(9) << mops << " Mops/s"
+              << "  p50 " << std::setw(6) << percentile(lat, 0.50)
+              << "  p90 " << std::setw(6) << percentile(lat, 0.90)
+              << "  p99 " << std::setw(6) << percentile(lat, 0.99)
+              << "  p99.9 " << std::setw(7) << percentile(lat, 0.999)
+              << "  max " << std::setw(9) << (lat.empty() ? 0 : lat.back()) << " ns"
+              << "  size " << result.finalSize
+              << "  checksum " << std::hex << std::setw(16) << std::setfill('0')
+              << result.checksum << std::dec << std::setfill(' ') << "\n";
+}
+
+TraceView openTrace(const MappedFile& file) {
+    if (file.size() < sizeof(TraceHeader)) throw std::runtime_error("Trace is too small");
+    TraceHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, "FHTR", 4) != 0) throw std::runtime_error("Not a heap trace");
+    if (header.version != TRACE_VERSION || header.recordSize != sizeof(TraceRecord)) {
+        throw std::runtime_error("Unsupported trace version");
+    }
+
+    TraceView view;
+    view.records = reinterpret_cast<const TraceRecord*>(file.data() + sizeof(TraceHeader));
+    view.count = (file.size() - sizeof(TraceHeader)) / sizeof(TraceRecord);
+    if (header.recordCount != 0 && header.recordCount != view.count) {
+        std::cerr << "warning: header lists " << header.recordCount << " records, file holds "
+                  << view.count << "\n";
+    }
+    return view;
+}
+
+// Synthetic triage-like workload, useful for smoke-testing the pipeline.
+// With burst > 0, every 8 * burst operations start with burst inserts in a
+// row, like a mass-casualty intake.
+void generate(const std::string& path, size_t ops, unsigned seed, size_t burst) {
+    HeapTraceWriter writer(path);
+    FibonacciHeap<int> heap;
+    RecordingHeap<int> recorder(heap, writer);
+    std::vector<FibonacciHeap<int>::Node*> live;  // nodes still in the heap
+    std::vector<size_t> slotOf;                    // payload id -> index in live
+    std::mt19937 rng(seed);
+
+    auto removeSlot = [&](size_t index) {
+        live[index] = live.back();
+        slotOf[live[index]->value] = index;
+        live.pop_back();
+    };
+
+    size_t burstLeft = 0;
+    for (size_t i = 0; i < ops; ++i) {
+        if (burst > 0 && i % (burst * 8) == 0) burstLeft = burst;
+        unsigned roll = rng() % 100;
+        if (burstLeft > 0) {
+            burstLeft--;
+            roll = 0;
+        }
+        if (roll < 50 || live.empty()) {
+            slotOf.push_back(live.size());
+            live.push_back(recorder.insert(static_cast<int>(slotOf.size() - 1), static_cast<int>(rng() % 10000)));
+        } else if (roll < 75) {
+            auto* min = recorder.extractMin();
+            removeSlot(slotOf[min->value]);
+            heap.release(min);
+        } else if (roll < 95) {
+            size_t index = rng() % live.size();
+            live[index] = recorder.updateKey(live[index], static_cast<int>(rng() % 10000));
+        } else {
+            size_t index = rng() % live.size();
+            auto* node = live[index];
+            removeSlot(index);
+            recorder.deleteNode(node);
+        }
+    }
+}
+
+void usage() {
+    std::cerr << "usage: heap_replay <trace> [--engine fibonacci|observed|incremental|binary|all]\n"
+              << "                   [--repeat N] [--budget N]\n"
+              << "       heap_replay --generate <trace> <ops> [seed] [--burst N]\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        usage();
+        return 2;
+    }
+
+    try {
+        if (std::strcmp(argv[1], "--generate") == 0) {
+            if (argc < 4) {
+                usage();
+                return 2;
+            }
+            size_t ops = std::strtoull(argv[3], nullptr, 10);
+            unsigned seed = 1;
+            size_t burst = 0;
+            for (int i = 4; i < argc; ++i) {
+                if (std::strcmp(argv[i], "--burst") == 0 && i + 1 < argc) {
+                    burst = std::strtoull(argv[++i], nullptr, 10);
+                } else {
+                    seed = static_cast<unsigned>(std::strtoul(argv[i], nullptr, 10));
+                }
+            }
+            generate(argv[2], ops, seed, burst);
+            std::cout << "Wrote " << ops << " operations to " << argv[2] << "\n";
+            return 0;
+        }
+
+        std::string engine = "all";
+        int repeat = 1;
+        int budget = 4;
+        for (int i = 2; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--engine") == 0 && i + 1 < argc) {
+                engine = argv[++i];
+            } else if (std::strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+                repeat = std::max(1, std::atoi(argv[++i]));
+            } else if (std::strcmp(argv[i], "--budget") == 0 && i + 1 < argc) {
+                budget = std::max(1, std::atoi(argv[++i]));
+            } else {
+                usage();
+                return 2;
+            }
+        }
+        if (engine != "all" && engine != FibonacciEngine::name() &&
+            engine != ObservedFibonacciEngine::name() && engine != INCREMENTAL_ENGINE &&
+            engine != BinaryEngine::name()) {
+            usage();
+            return 2;
+        }
+
+        MappedFile file(argv[1]);
+        TraceView trace = openTrace(file);
+        std::cout << "Replaying " << trace.count << " operations from " << argv[1] << "\n";
+
+        for (int run = 0; run < repeat; ++run) {
+            if (engine == "all" || engine == FibonacciEngine::name()) {
+                ReplayResult result = replay<FibonacciEngine>(trace);
+                report(FibonacciEngine::name(), result);
+            }
+            if (engine == "all" || engine == ObservedFibonacciEngine::name()) {
+                ReplayResult result = replay<ObservedFibonacciEngine>(trace);
+                report(ObservedFibonacciEngine::name(), result);
+            }
+            if (engine == "all" || engine == INCREMENTAL_ENGINE) {
+                ReplayResult result = replay<FibonacciEngine>(trace, budget);
+                report(INCREMENTAL_ENGINE, result);
+            }
+            if (engine == "all" || engine == BinaryEngine::name()) {
+                ReplayResult result = replay<BinaryEngine>(trace);
+                report(BinaryEngine::name(), result);
+            }
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}